@@ -0,0 +1,123 @@
+$input v_position, v_texcoord0
+
+/*
+ * Copyright 2011-2017 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx#license-bsd-2-clause
+ */
+
+// fs_nanovg_fill with a gamma and a false color mapping of the image fills,
+// see nvgToneMap(). fs_nanovg_tonemap.bin.h is generated with:
+//
+//   shaderc -f fs_nanovg_tonemap.sc -o fs_nanovg_tonemap.bin.h --type fragment
+//           --platform linux -p 120 -i <bgfx>/src --bin2c fs_nanovg_tonemap_glsl
+//
+// Only the GLSL variant is embedded, so that the other renderers go without
+// the gamma and the false color mapping.
+
+#include <bgfx_shader.sh>
+
+#define EDGE_AA 1
+
+uniform mat3 u_scissorMat;
+uniform mat3 u_paintMat;
+uniform vec4 u_innerCol;
+uniform vec4 u_outerCol;
+uniform vec4 u_scissorExtScale;
+uniform vec4 u_extentRadius;
+uniform vec4 u_params;
+uniform vec4 u_toneMap;
+SAMPLER2D(s_tex, 0);
+
+#define u_scissorExt   (u_scissorExtScale.xy)
+#define u_scissorScale (u_scissorExtScale.zw)
+#define u_extent       (u_extentRadius.xy)
+#define u_radius       (u_extentRadius.z)
+#define u_feather      (u_params.x)
+#define u_strokeMult   (u_params.y)
+#define u_texType      (u_params.z)
+#define u_type         (u_params.w)
+#define u_invGamma     (u_toneMap.x)
+#define u_falseColor   (u_toneMap.y)
+
+float sdroundrect(vec2 pt, vec2 ext, float rad)
+{
+	vec2 ext2 = ext - vec2(rad,rad);
+	vec2 d = abs(pt) - ext2;
+	return min(max(d.x, d.y), 0.0) + length(max(d, 0.0) ) - rad;
+}
+
+// Scissoring
+float scissorMask(vec2 p)
+{
+	vec2 sc = abs(mul(u_scissorMat, vec3(p, 1.0) ).xy) - u_scissorExt;
+	sc = vec2(0.5, 0.5) - sc * u_scissorScale;
+	return clamp(sc.x, 0.0, 1.0) * clamp(sc.y, 0.0, 1.0);
+}
+
+#if EDGE_AA
+// Stroke - from [0..1] to clipped pyramid, where the slope is 1px.
+float strokeMask(vec2 _texcoord)
+{
+	return min(1.0, (1.0 - abs(_texcoord.x*2.0 - 1.0) )*u_strokeMult) * min(1.0, _texcoord.y);
+}
+#endif // EDGE_AA
+
+// Tone maps a premultiplied color whose tint (and exposure) is applied.
+vec4 toneMap(vec4 color)
+{
+	vec3 rgb = color.w > 0.0 ? max(color.xyz / color.w, 0.0) : vec3_splat(0.0);
+	if (u_falseColor != 0.0)
+	{
+		float t = clamp(dot(rgb, vec3(0.2126, 0.7152, 0.0722) ), 0.0, 1.0);
+		rgb = clamp(vec3_splat(1.5) - abs(4.0 * vec3_splat(t) - vec3(3.0, 2.0, 1.0) ), 0.0, 1.0);
+	}
+	rgb = pow(rgb, vec3_splat(u_invGamma) );
+	return vec4(rgb * color.w, color.w);
+}
+
+void main()
+{
+#if EDGE_AA
+	float strokeAlpha = strokeMask(v_texcoord0);
+#else
+	float strokeAlpha = 1.0;
+#endif // EDGE_AA
+
+	if (u_type == 0.0) // Gradient
+	{
+		float scissor = scissorMask(v_position);
+		// Calculate gradient color using box gradient
+		vec2 pt = mul(u_paintMat, vec3(v_position, 1.0) ).xy;
+		float d = clamp( (sdroundrect(pt, u_extent, u_radius) + u_feather*0.5) / u_feather, 0.0, 1.0);
+		vec4 color = mix(u_innerCol, u_outerCol, d);
+		// Combine alpha
+		color *= strokeAlpha * scissor;
+		gl_FragColor = color;
+	}
+	else if (u_type == 1.0) // Image
+	{
+		float scissor = scissorMask(v_position);
+		// Calculate color from texture
+		vec2 pt = mul(u_paintMat, vec3(v_position, 1.0) ).xy / u_extent;
+		vec4 color = texture2D(s_tex, pt);
+		if (u_texType == 1.0) color = vec4(color.xyz * color.w, color.w);
+		if (u_texType == 2.0) color = vec4_splat(color.x);
+		// Apply color tint and alpha, then tone map.
+		color = toneMap(color * u_innerCol);
+		// Combine alpha
+		color *= strokeAlpha * scissor;
+		gl_FragColor = color;
+	}
+	else if (u_type == 2.0) // Stencil fill
+	{
+		gl_FragColor = vec4(1.0, 1.0, 1.0, 1.0);
+	}
+	else if (u_type == 3.0) // Textured tris
+	{
+		vec4 color = texture2D(s_tex, v_texcoord0);
+		if (u_texType == 1.0) color = vec4(color.xyz * color.w, color.w);
+		if (u_texType == 2.0) color = vec4_splat(color.x);
+		float scissor = scissorMask(v_position);
+		gl_FragColor = toneMap(color * u_innerCol) * scissor;
+	}
+}
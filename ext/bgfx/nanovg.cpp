@@ -802,6 +802,11 @@ void nvgUpdateImage(NVGcontext* ctx, int image, const unsigned char* data)
 	ctx->params.renderUpdateTexture(ctx->params.userPtr, image, 0,0, w,h, data);
 }
 
+void nvgUpdateImageRegion(NVGcontext* ctx, int image, int x, int y, int w, int h, const unsigned char* data)
+{
+	ctx->params.renderUpdateTexture(ctx->params.userPtr, image, x,y, w,h, data);
+}
+
 void nvgImageSize(NVGcontext* ctx, int image, int* w, int* h)
 {
 	ctx->params.renderGetTextureSize(ctx->params.userPtr, image, w, h);
@@ -2387,6 +2392,125 @@ static void nvg__renderText(NVGcontext* ctx, NVGvertex* verts, int nverts)
 	ctx->textTriCount += nverts/3;
 }
 
+void nvgTintedImageRects(NVGcontext* ctx, int image, const float* rects, int count, NVGcolor color)
+{
+	NVGstate* state = nvg__getState(ctx);
+	NVGpaint paint;
+	NVGvertex* verts;
+	int i, w = 0, h = 0, nverts = 0;
+
+	if (count <= 0) return;
+	ctx->params.renderGetTextureSize(ctx->params.userPtr, image, &w, &h);
+	if (w <= 0 || h <= 0) return;
+
+	verts = nvg__allocTempVerts(ctx, count*6);
+	if (verts == NULL) return;
+
+	for (i = 0; i < count; i++) {
+		const float* r = &rects[i*8];
+		float s0 = r[4] / w, t0 = r[5] / h;
+		float s1 = (r[4]+r[6]) / w, t1 = (r[5]+r[7]) / h;
+		float c[4*2];
+		// Transform corners.
+		nvgTransformPoint(&c[0],&c[1], state->xform, r[0], r[1]);
+		nvgTransformPoint(&c[2],&c[3], state->xform, r[0]+r[2], r[1]);
+		nvgTransformPoint(&c[4],&c[5], state->xform, r[0]+r[2], r[1]+r[3]);
+		nvgTransformPoint(&c[6],&c[7], state->xform, r[0], r[1]+r[3]);
+		// Create triangles
+		nvg__vset(&verts[nverts], c[0], c[1], s0, t0); nverts++;
+		nvg__vset(&verts[nverts], c[4], c[5], s1, t1); nverts++;
+		nvg__vset(&verts[nverts], c[2], c[3], s1, t0); nverts++;
+		nvg__vset(&verts[nverts], c[0], c[1], s0, t0); nverts++;
+		nvg__vset(&verts[nverts], c[6], c[7], s0, t1); nverts++;
+		nvg__vset(&verts[nverts], c[4], c[5], s1, t1); nverts++;
+	}
+
+	paint = nvgImagePattern(ctx, 0, 0, (float)w, (float)h, 0, image, 1.0f);
+	paint.innerColor = paint.outerColor = color;
+
+	// Apply global alpha
+	paint.innerColor.a *= state->alpha;
+	paint.outerColor.a *= state->alpha;
+
+	ctx->params.renderTriangles(ctx->params.userPtr, &paint, state->compositeOperation, &state->scissor, verts, nverts);
+
+	ctx->drawCallCount++;
+	ctx->fillTriCount += nverts/3;
+}
+
+void nvgImageRects(NVGcontext* ctx, int image, const float* rects, int count, float alpha)
+{
+	nvgTintedImageRects(ctx, image, rects, count, nvgRGBAf(1,1,1,alpha));
+}
+
+int nvgTextGlyphQuads(NVGcontext* ctx, const char* string, const char* end, NVGglyphQuad* quads, int maxQuads, int* image)
+{
+	NVGstate* state = nvg__getState(ctx);
+	FONStextIter iter, prevIter;
+	FONSquad q;
+	float scale = nvg__getFontScale(state) * ctx->devicePxRatio;
+	float invscale = 1.0f / scale;
+	int iw, ih;
+	int nquads = 0;
+
+	*image = 0;
+	if (end == NULL)
+		end = string + strlen(string);
+
+	if (state->fontId == FONS_INVALID) return 0;
+
+	fonsSetSize(ctx->fs, state->fontSize*scale);
+	fonsSetSpacing(ctx->fs, state->letterSpacing*scale);
+	fonsSetBlur(ctx->fs, state->fontBlur*scale);
+	fonsSetAlign(ctx->fs, state->textAlign);
+	fonsSetFont(ctx->fs, state->fontId);
+
+	fonsTextIterInit(ctx->fs, &iter, 0, 0, string, end);
+	prevIter = iter;
+	while (nquads < maxQuads) {
+		NVGglyphQuad* quad = &quads[nquads];
+		// The quads are reused in any order, so no kerning against the previous character.
+		iter.prevGlyphIndex = -1;
+		if (!fonsTextIterNext(ctx->fs, &iter, &q))
+			break;
+		if (iter.prevGlyphIndex == -1) { // can not retrieve glyph?
+			if (nquads != 0 || !nvg__allocTextAtlas(ctx))
+				break; // no memory, or the quads so far are in the old atlas
+			iter = prevIter;
+			iter.prevGlyphIndex = -1;
+			fonsTextIterNext(ctx->fs, &iter, &q); // try again
+			if (iter.prevGlyphIndex == -1) // still can not find glyph?
+				break;
+		}
+		prevIter = iter;
+		quad->x0 = (q.x0 - iter.x)*invscale;
+		quad->y0 = (q.y0 - iter.y)*invscale;
+		quad->x1 = (q.x1 - iter.x)*invscale;
+		quad->y1 = (q.y1 - iter.y)*invscale;
+		quad->s0 = q.s0;
+		quad->t0 = q.t0;
+		quad->s1 = q.s1;
+		quad->t1 = q.t1;
+		// Without kerning, fontstash leaves out the letter spacing too.
+		quad->advance = (iter.nextx - iter.x)*invscale + state->letterSpacing;
+		nquads++;
+	}
+
+	nvg__flushTextTexture(ctx);
+
+	// Convert the texture coordinates to pixels of the atlas.
+	*image = ctx->fontImages[ctx->fontImageIdx];
+	fonsGetTextureData(ctx->fs, &iw, &ih);
+	for (int i = 0; i < nquads; i++) {
+		quads[i].s0 *= iw;
+		quads[i].t0 *= ih;
+		quads[i].s1 *= iw;
+		quads[i].t1 *= ih;
+	}
+
+	return nquads;
+}
+
 float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char* end)
 {
 	NVGstate* state = nvg__getState(ctx);
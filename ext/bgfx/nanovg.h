@@ -128,6 +128,13 @@ struct NVGglyphPosition {
 };
 typedef struct NVGglyphPosition NVGglyphPosition;
 
+struct NVGglyphQuad {
+	float x0, y0, x1, y1;	// Rectangle of the glyph relative to the pen position on the baseline.
+	float s0, t0, s1, t1;	// Rectangle of the glyph in the font atlas image, in pixels.
+	float advance;			// Horizontal advance of the pen, without kerning.
+};
+typedef struct NVGglyphQuad NVGglyphQuad;
+
 struct NVGtextRow {
 	const char* start;	// Pointer to the input text where the row starts.
 	const char* end;	// Pointer to the input text where the row ends (one past the last character).
@@ -373,12 +380,26 @@ int nvgCreateImageRGBA(NVGcontext* ctx, int w, int h, int imageFlags, const unsi
 // Updates image data specified by image handle.
 void nvgUpdateImage(NVGcontext* ctx, int image, const unsigned char* data);
 
+// Updates the region (x,y,w,h) of the image specified by image handle.
+// Parameter data holds the pixels of the whole image, of which only the region is uploaded.
+void nvgUpdateImageRegion(NVGcontext* ctx, int image, int x, int y, int w, int h, const unsigned char* data);
+
 // Returns the dimensions of a created image.
 void nvgImageSize(NVGcontext* ctx, int image, int* w, int* h);
 
 // Deletes created image.
 void nvgDeleteImage(NVGcontext* ctx, int image);
 
+// Draws parts of an image as axis-aligned rectangles in a single draw call, e.g. sprites packed into an atlas.
+// Parameter rects holds count groups of 8 values: the destination rectangle (x,y,w,h), transformed by the
+// current transform, followed by the source rectangle (x,y,w,h) in image pixels. The rectangles are not
+// anti-aliased and use the current scissor, composite operation and global alpha.
+void nvgImageRects(NVGcontext* ctx, int image, const float* rects, int count, float alpha);
+
+// Like nvgImageRects(), but multiplies the image by the specified color. Alpha-only images,
+// such as the font atlas, are drawn in that color.
+void nvgTintedImageRects(NVGcontext* ctx, int image, const float* rects, int count, NVGcolor color);
+
 //
 // Paints
 //
@@ -594,6 +615,13 @@ void nvgTextBoxBounds(NVGcontext* ctx, float x, float y, float breakRowWidth, co
 // Measured values are returned in local coordinate space.
 int nvgTextGlyphPositions(NVGcontext* ctx, float x, float y, const char* string, const char* end, NVGglyphPosition* positions, int maxPositions);
 
+// Lays out the glyphs of the specified text string with the current text style, e.g. to draw many
+// short strings made of the same few characters with nvgTintedImageRects(). Returns the number of
+// quads written, one per character, and stores the handle of the font atlas image they refer to.
+// Each quad is laid out on its own: the text alignment and the kerning between characters are not applied.
+// The quads stay valid until the font atlas grows, and should be requested again every frame.
+int nvgTextGlyphQuads(NVGcontext* ctx, const char* string, const char* end, NVGglyphQuad* quads, int maxQuads, int* image);
+
 // Returns the vertical metrics based on the current text style.
 // Measured values are returned in local coordinate space.
 void nvgTextMetrics(NVGcontext* ctx, float* ascender, float* descender, float* lineh);
@@ -609,6 +637,8 @@ int nvgTextBreakLines(NVGcontext* ctx, const char* string, const char* end, floa
 enum NVGtexture {
 	NVG_TEXTURE_ALPHA = 0x01,
 	NVG_TEXTURE_RGBA = 0x02,
+	NVG_TEXTURE_RGBA16F = 0x03,
+	NVG_TEXTURE_RGBA32F = 0x04,
 };
 
 struct NVGscissor {
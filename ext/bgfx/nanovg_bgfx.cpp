@@ -38,12 +38,23 @@ BX_PRAGMA_DIAGNOSTIC_IGNORED_MSVC(4244); // warning C4244: '=' : conversion from
 
 #include "vs_nanovg_fill.bin.h"
 #include "fs_nanovg_fill.bin.h"
+#include "fs_nanovg_tonemap.bin.h"
 
 static const bgfx::EmbeddedShader s_embeddedShaders[] =
 {
 	BGFX_EMBEDDED_SHADER(vs_nanovg_fill),
 	BGFX_EMBEDDED_SHADER(fs_nanovg_fill),
 
+	// Only compiled to GLSL, see fs_nanovg_tonemap.sc.
+	{
+		"fs_nanovg_tonemap",
+		{
+			{ bgfx::RendererType::OpenGLES, fs_nanovg_tonemap_glsl, BX_COUNTOF(fs_nanovg_tonemap_glsl) },
+			{ bgfx::RendererType::OpenGL,   fs_nanovg_tonemap_glsl, BX_COUNTOF(fs_nanovg_tonemap_glsl) },
+			{ bgfx::RendererType::Count,    NULL,                   0 },
+		}
+	},
+
 	BGFX_EMBEDDED_SHADER_END()
 };
 
@@ -66,10 +77,16 @@ namespace
 
 	struct GLNVGtexture
 	{
+		int image; // Handle of the image (index of the texture + 1), 0 if unused.
 		bgfx::TextureHandle id;
 		int width, height;
 		int type;
 		int flags;
+		uint32_t bytes;
+		uint32_t lastUsed; // Frame in which the image was last drawn.
+		bool evicted;      // The texture was destroyed to stay within the budget.
+		NVGimageReloadCallback reload; // Set for images that may be evicted.
+		void* reloadUserPtr;
 	};
 
 	struct GLNVGblend
@@ -128,6 +145,11 @@ namespace
 		float strokeMult;
 		float texType;
 		float type;
+
+		// u_toneMap
+		float invGamma; // 0 if the fill is not tone mapped.
+		float falseColor;
+		float toneMapUnused[2];
 	};
 
 	struct GLNVGcontext
@@ -144,9 +166,18 @@ namespace
 		bgfx::UniformHandle u_extentRadius;
 		bgfx::UniformHandle u_params;
 		bgfx::UniformHandle u_halfTexel;
+		bgfx::UniformHandle u_toneMap;
 
 		bgfx::UniformHandle s_tex;
 
+		// Tone mapping of the image fills, see nvgToneMap().
+		bgfx::ProgramHandle toneMapProg;
+		bgfx::ProgramHandle defaultToneMapProg;
+		bgfx::ProgramHandle currentProg;
+		float exposureScale;
+		float invGamma;
+		float falseColor;
+
 		uint64_t state;
 		bgfx::TextureHandle th;
 		bgfx::TextureHandle texMissing;
@@ -159,6 +190,13 @@ namespace
 		int ntextures;
 		int ctextures;
 		int textureId;
+
+		// Texture accounting
+		size_t textureBytes; // Bytes of the resident textures.
+		size_t textureBudget;
+		uint32_t frame;
+		uint64_t evictions;
+		uint64_t reloads;
 		int vertBuf;
 		int fragSize;
 		int edgeAntiAlias;
@@ -185,7 +223,7 @@ namespace
 
 		for (i = 0; i < gl->ntextures; i++)
 		{
-			if (gl->textures[i].id.idx == bgfx::invalidHandle)
+			if (gl->textures[i].image == 0)
 			{
 				tex = &gl->textures[i];
 				break;
@@ -210,42 +248,90 @@ namespace
 		}
 
 		bx::memSet(tex, 0, sizeof(*tex) );
+		tex->image = int(tex - gl->textures) + 1;
+		tex->id.idx = bgfx::invalidHandle;
 
 		return tex;
 	}
 
+	// Image handles index the texture array rather than naming bgfx textures,
+	// so that the texture behind a handle can be replaced.
 	static struct GLNVGtexture* glnvg__findTexture(struct GLNVGcontext* gl, int id)
 	{
-		int i;
-		for (i = 0; i < gl->ntextures; i++)
+		if (id <= 0 || id > gl->ntextures)
 		{
-			if (gl->textures[i].id.idx == id)
-			{
-				return &gl->textures[i];
-			}
+			return NULL;
 		}
 
-		return NULL;
+		struct GLNVGtexture* tex = &gl->textures[id - 1];
+		return tex->image == id ? tex : NULL;
 	}
 
-	static int glnvg__deleteTexture(struct GLNVGcontext* gl, int id)
+	static void glnvg__freeTexture(struct GLNVGcontext* gl, struct GLNVGtexture* tex)
 	{
-		for (int ii = 0; ii < gl->ntextures; ii++)
+		if (bgfx::isValid(tex->id) )
 		{
-			if (gl->textures[ii].id.idx == id)
+			if ( (tex->flags & NVG_IMAGE_NODELETE) == 0)
 			{
-				if (bgfx::isValid(gl->textures[ii].id)
-				&& (gl->textures[ii].flags & NVG_IMAGE_NODELETE) == 0)
-				{
-					bgfx::destroyTexture(gl->textures[ii].id);
-				}
-				bx::memSet(&gl->textures[ii], 0, sizeof(gl->textures[ii]) );
-				gl->textures[ii].id.idx = bgfx::invalidHandle;
-				return 1;
+				bgfx::destroyTexture(tex->id);
 			}
+			gl->textureBytes -= tex->bytes;
 		}
+		bx::memSet(tex, 0, sizeof(*tex) );
+		tex->id.idx = bgfx::invalidHandle;
+	}
 
-		return 0;
+	static int glnvg__deleteTexture(struct GLNVGcontext* gl, int id)
+	{
+		struct GLNVGtexture* tex = glnvg__findTexture(gl, id);
+		if (tex == NULL)
+		{
+			return 0;
+		}
+
+		glnvg__freeTexture(gl, tex);
+		return 1;
+	}
+
+	static uint32_t glnvg__bytesPerPixel(int _type)
+	{
+		switch (_type)
+		{
+		case NVG_TEXTURE_RGBA:    return 4;
+		case NVG_TEXTURE_RGBA16F: return 8;
+		case NVG_TEXTURE_RGBA32F: return 16;
+		default:                  return 1;
+		}
+	}
+
+	static bgfx::TextureFormat::Enum glnvg__textureFormat(int _type)
+	{
+		switch (_type)
+		{
+		case NVG_TEXTURE_RGBA:    return bgfx::TextureFormat::RGBA8;
+		case NVG_TEXTURE_RGBA16F: return bgfx::TextureFormat::RGBA16F;
+		case NVG_TEXTURE_RGBA32F: return bgfx::TextureFormat::RGBA32F;
+		default:                  return bgfx::TextureFormat::R8;
+		}
+	}
+
+	static uint32_t glnvg__textureFlags(int _flags)
+	{
+		// Images are clamped to their edges unless repeated, as in the OpenGL back-end.
+		uint32_t flags = BGFX_TEXTURE_NONE;
+		if (0 == (_flags & NVG_IMAGE_REPEATX))
+		{
+			flags |= BGFX_TEXTURE_U_CLAMP;
+		}
+		if (0 == (_flags & NVG_IMAGE_REPEATY))
+		{
+			flags |= BGFX_TEXTURE_V_CLAMP;
+		}
+		if (0 != (_flags & NVG_IMAGE_NEAREST))
+		{
+			flags |= BGFX_TEXTURE_MIN_POINT | BGFX_TEXTURE_MAG_POINT;
+		}
+		return flags;
 	}
 
 	static int nvgRenderCreate(void* _userPtr)
@@ -272,8 +358,27 @@ namespace
 		gl->u_scissorExtScale = bgfx::createUniform("u_scissorExtScale", bgfx::UniformType::Vec4);
 		gl->u_extentRadius    = bgfx::createUniform("u_extentRadius",    bgfx::UniformType::Vec4);
 		gl->u_params          = bgfx::createUniform("u_params",          bgfx::UniformType::Vec4);
+		gl->u_toneMap         = bgfx::createUniform("u_toneMap",         bgfx::UniformType::Vec4);
 		gl->s_tex             = bgfx::createUniform("s_tex",             bgfx::UniformType::Int1);
 
+		// The tone mapping shader is not available to every renderer.
+		gl->defaultToneMapProg.idx = bgfx::invalidHandle;
+		bgfx::ShaderHandle toneMapShader = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_nanovg_tonemap");
+		if (bgfx::isValid(toneMapShader) )
+		{
+			gl->defaultToneMapProg = bgfx::createProgram(
+							  bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_nanovg_fill")
+							, toneMapShader
+							, true
+							);
+		}
+
+		gl->toneMapProg     = gl->defaultToneMapProg;
+		gl->currentProg     = gl->prog;
+		gl->exposureScale   = 1.0f;
+		gl->invGamma        = 1.0f;
+		gl->falseColor      = 0.0f;
+
 		if (bgfx::getRendererType() == bgfx::RendererType::Direct3D9)
 		{
 			gl->u_halfTexel   = bgfx::createUniform("u_halfTexel",       bgfx::UniformType::Vec4);
@@ -305,6 +410,14 @@ namespace
 		)
 	{
 		struct GLNVGcontext* gl = (struct GLNVGcontext*)_userPtr;
+
+		// Float textures are not available on every renderer.
+		const bgfx::TextureFormat::Enum format = glnvg__textureFormat(_type);
+		if (0 == (bgfx::getCaps()->formats[format] & BGFX_CAPS_FORMAT_TEXTURE_2D) )
+		{
+			return 0;
+		}
+
 		struct GLNVGtexture* tex = glnvg__allocTexture(gl);
 
 		if (tex == NULL)
@@ -317,7 +430,7 @@ namespace
 		tex->type   = _type;
 		tex->flags  = _flags;
 
-		uint32_t bytesPerPixel = NVG_TEXTURE_RGBA == tex->type ? 4 : 1;
+		uint32_t bytesPerPixel = glnvg__bytesPerPixel(tex->type);
 		uint32_t pitch = tex->width * bytesPerPixel;
 
 		const bgfx::Memory* mem = NULL;
@@ -331,8 +444,8 @@ namespace
 						, tex->height
 						, false
 						, 1
-						, NVG_TEXTURE_RGBA == _type ? bgfx::TextureFormat::RGBA8 : bgfx::TextureFormat::R8
-						, BGFX_TEXTURE_NONE
+						, format
+						, glnvg__textureFlags(_flags)
 						);
 
 		if (NULL != mem)
@@ -349,7 +462,106 @@ namespace
 				);
 		}
 
-		return bgfx::isValid(tex->id) ? tex->id.idx : 0;
+		if (!bgfx::isValid(tex->id) )
+		{
+			glnvg__freeTexture(gl, tex);
+			return 0;
+		}
+
+		tex->bytes = tex->height * pitch;
+		tex->lastUsed = gl->frame;
+		gl->textureBytes += tex->bytes;
+
+		return tex->image;
+	}
+
+	// Recreates the texture of an evicted image. Unless the caller is about to
+	// upload all the pixels itself, the texture is cleared and its owner asked
+	// to restore the pixels, possibly later.
+	static void glnvg__restoreTexture(struct GLNVGcontext* gl, struct GLNVGtexture* tex, bool _reload)
+	{
+		// Created without memory so that the texture stays updatable.
+		tex->id = bgfx::createTexture2D(
+						  tex->width
+						, tex->height
+						, false
+						, 1
+						, glnvg__textureFormat(tex->type)
+						, glnvg__textureFlags(tex->flags)
+						);
+		if (!bgfx::isValid(tex->id) )
+		{
+			return;
+		}
+
+		tex->evicted = false;
+		tex->lastUsed = gl->frame;
+		gl->textureBytes += tex->bytes;
+		gl->reloads++;
+		if (!_reload)
+		{
+			return;
+		}
+
+		const bgfx::Memory* mem = bgfx::alloc(tex->bytes);
+		bx::memSet(mem->data, 0, tex->bytes);
+		bgfx::updateTexture2D(tex->id, 0, 0, 0, 0, tex->width, tex->height, mem);
+
+		if (tex->reload != NULL)
+		{
+			tex->reload(tex->reloadUserPtr, tex->image);
+		}
+	}
+
+	static int glnvg__compareLastUsed(const void* _lhs, const void* _rhs)
+	{
+		const struct GLNVGtexture* lhs = *(const struct GLNVGtexture**)_lhs;
+		const struct GLNVGtexture* rhs = *(const struct GLNVGtexture**)_rhs;
+		return lhs->lastUsed < rhs->lastUsed ? -1 : (lhs->lastUsed > rhs->lastUsed ? 1 : 0);
+	}
+
+	// Destroys the textures of the least recently drawn reloadable images
+	// until the resident textures fit in the budget.
+	static void glnvg__evictTextures(struct GLNVGcontext* gl)
+	{
+		if (gl->textureBudget == 0
+		||  gl->textureBytes <= gl->textureBudget)
+		{
+			return;
+		}
+
+		struct GLNVGtexture** candidates = (struct GLNVGtexture**)BX_ALLOC(gl->m_allocator, sizeof(struct GLNVGtexture*) * gl->ntextures);
+		if (candidates == NULL)
+		{
+			return;
+		}
+
+		int num = 0;
+		for (int ii = 0; ii < gl->ntextures; ++ii)
+		{
+			struct GLNVGtexture* tex = &gl->textures[ii];
+			if (tex->image != 0
+			&&  tex->reload != NULL
+			&&  bgfx::isValid(tex->id)
+			&& (tex->flags & NVG_IMAGE_NODELETE) == 0
+			&&  tex->lastUsed != gl->frame)
+			{
+				candidates[num++] = tex;
+			}
+		}
+		qsort(candidates, num, sizeof(struct GLNVGtexture*), glnvg__compareLastUsed);
+
+		for (int ii = 0; ii < num && gl->textureBytes > gl->textureBudget; ++ii)
+		{
+			struct GLNVGtexture* tex = candidates[ii];
+			bgfx::destroyTexture(tex->id);
+			tex->id.idx = bgfx::invalidHandle;
+			tex->evicted = true;
+			gl->textureBytes -= tex->bytes;
+			gl->evictions++;
+		}
+
+		BX_FREE(gl->m_allocator, candidates);
 	}
 
 	static int nvgRenderDeleteTexture(void* _userPtr, int image)
@@ -367,7 +579,15 @@ namespace
 			return 0;
 		}
 
-		uint32_t bytesPerPixel = NVG_TEXTURE_RGBA == tex->type ? 4 : 1;
+		if (tex->evicted)
+		{
+			// An update of the whole image restores it: calling the reload
+			// callback would only make its owner upload the pixels again.
+			bool whole = x == 0 && y == 0 && w == tex->width && h == tex->height;
+			glnvg__restoreTexture(gl, tex, !whole);
+		}
+
+		uint32_t bytesPerPixel = glnvg__bytesPerPixel(tex->type);
 		uint32_t pitch = tex->width * bytesPerPixel;
 
 		const bgfx::Memory* mem = bgfx::alloc(w * h * bytesPerPixel);
@@ -394,7 +614,7 @@ namespace
 		struct GLNVGtexture* tex = glnvg__findTexture(gl, image);
 
 		if (NULL == tex
-		|| !bgfx::isValid(tex->id) )
+		|| (!bgfx::isValid(tex->id) && !tex->evicted) )
 		{
 			return 0;
 		}
@@ -474,12 +694,39 @@ namespace
 			{
 				return 0;
 			}
-			nvgTransformInverse(invxform, paint->xform);
+			if (tex->evicted)
+			{
+				glnvg__restoreTexture(gl, tex, true);
+			}
+			tex->lastUsed = gl->frame;
+			if ( (tex->flags & NVG_IMAGE_FLIPY) != 0)
+			{
+				// Mirrors the paint about the middle of its extent.
+				float m1[6], m2[6];
+				nvgTransformTranslate(m1, 0.0f, frag->extent[1] * 0.5f);
+				nvgTransformMultiply(m1, paint->xform);
+				nvgTransformScale(m2, 1.0f, -1.0f);
+				nvgTransformMultiply(m2, m1);
+				nvgTransformTranslate(m1, 0.0f, -frag->extent[1] * 0.5f);
+				nvgTransformMultiply(m1, m2);
+				nvgTransformInverse(invxform, m1);
+			}
+			else
+			{
+				nvgTransformInverse(invxform, paint->xform);
+			}
 			frag->type = NSVG_SHADER_FILLIMG;
 
-			if (tex->type == NVG_TEXTURE_RGBA)
+			if (tex->type != NVG_TEXTURE_ALPHA)
 			{
 				frag->texType = (tex->flags & NVG_IMAGE_PREMULTIPLIED) ? 0.0f : 1.0f;
+
+				// The exposure scales the tint, so that the default program applies it too.
+				frag->innerCol.r *= gl->exposureScale;
+				frag->innerCol.g *= gl->exposureScale;
+				frag->innerCol.b *= gl->exposureScale;
+				frag->invGamma   = gl->invGamma;
+				frag->falseColor = gl->falseColor;
 			}
 			else
 			{
@@ -535,12 +782,23 @@ namespace
 		bgfx::setUniform(gl->u_extentRadius,    &frag->extent[0]);
 		bgfx::setUniform(gl->u_params,          &frag->feather);
 
+		gl->currentProg = gl->prog;
+		// invGamma is zero for the fills that are not tone mapped.
+		if (bgfx::isValid(gl->toneMapProg)
+		&&  frag->invGamma != 0.0f
+		&& (frag->invGamma != 1.0f || frag->falseColor != 0.0f) )
+		{
+			bgfx::setUniform(gl->u_toneMap, &frag->invGamma);
+			gl->currentProg = gl->toneMapProg;
+		}
+
 		bgfx::TextureHandle handle = gl->texMissing;
 
 		if (image != 0)
 		{
 			struct GLNVGtexture* tex = glnvg__findTexture(gl, image);
-			if (tex != NULL)
+			if (tex != NULL
+			&&  bgfx::isValid(tex->id) )
 			{
 				handle = tex->id;
 
@@ -608,7 +866,7 @@ namespace
 				bgfx::setVertexBuffer(0, &gl->tvb);
 				bgfx::setTexture(0, gl->s_tex, gl->th);
 				fan(paths[i].fillOffset, paths[i].fillCount);
-				bgfx::submit(gl->m_viewId, gl->prog);
+				bgfx::submit(gl->m_viewId, gl->currentProg);
 			}
 		}
 
@@ -632,7 +890,7 @@ namespace
 					);
 				bgfx::setVertexBuffer(0, &gl->tvb, paths[i].strokeOffset, paths[i].strokeCount);
 				bgfx::setTexture(0, gl->s_tex, gl->th);
-				bgfx::submit(gl->m_viewId, gl->prog);
+				bgfx::submit(gl->m_viewId, gl->currentProg);
 			}
 		}
 
@@ -647,7 +905,7 @@ namespace
 				| BGFX_STENCIL_OP_FAIL_Z_ZERO
 				| BGFX_STENCIL_OP_PASS_Z_ZERO
 				);
-		bgfx::submit(gl->m_viewId, gl->prog);
+		bgfx::submit(gl->m_viewId, gl->currentProg);
 	}
 
 	static void glnvg__convexFill(struct GLNVGcontext* gl, struct GLNVGcall* call)
@@ -664,7 +922,7 @@ namespace
 			bgfx::setVertexBuffer(0, &gl->tvb);
 			bgfx::setTexture(0, gl->s_tex, gl->th);
 			fan(paths[i].fillOffset, paths[i].fillCount);
-			bgfx::submit(gl->m_viewId, gl->prog);
+			bgfx::submit(gl->m_viewId, gl->currentProg);
 		}
 
 		if (gl->edgeAntiAlias)
@@ -677,7 +935,7 @@ namespace
 					);
 				bgfx::setVertexBuffer(0, &gl->tvb, paths[i].strokeOffset, paths[i].strokeCount);
 				bgfx::setTexture(0, gl->s_tex, gl->th);
-				bgfx::submit(gl->m_viewId, gl->prog);
+				bgfx::submit(gl->m_viewId, gl->currentProg);
 			}
 		}
 	}
@@ -697,7 +955,7 @@ namespace
 				);
 			bgfx::setVertexBuffer(0, &gl->tvb, paths[i].strokeOffset, paths[i].strokeCount);
 			bgfx::setTexture(0, gl->s_tex, gl->th);
-			bgfx::submit(gl->m_viewId, gl->prog);
+			bgfx::submit(gl->m_viewId, gl->currentProg);
 		}
 	}
 
@@ -710,7 +968,7 @@ namespace
 			bgfx::setState(gl->state);
 			bgfx::setVertexBuffer(0, &gl->tvb, call->vertexOffset, call->vertexCount);
 			bgfx::setTexture(0, gl->s_tex, gl->th);
-			bgfx::submit(gl->m_viewId, gl->prog);
+			bgfx::submit(gl->m_viewId, gl->currentProg);
 		}
 	}
 
@@ -807,6 +1065,9 @@ namespace
 		gl->npaths    = 0;
 		gl->ncalls    = 0;
 		gl->nuniforms = 0;
+
+		glnvg__evictTextures(gl);
+		gl->frame++;
 	}
 
 	static int glnvg__maxVertCount(const struct NVGpath* paths, int npaths)
@@ -1053,6 +1314,10 @@ namespace
 		}
 
 		bgfx::destroyProgram(gl->prog);
+		if (bgfx::isValid(gl->defaultToneMapProg) )
+		{
+			bgfx::destroyProgram(gl->defaultToneMapProg);
+		}
 		bgfx::destroyTexture(gl->texMissing);
 
 		bgfx::destroyUniform(gl->u_scissorMat);
@@ -1063,6 +1328,7 @@ namespace
 		bgfx::destroyUniform(gl->u_scissorExtScale);
 		bgfx::destroyUniform(gl->u_extentRadius);
 		bgfx::destroyUniform(gl->u_params);
+		bgfx::destroyUniform(gl->u_toneMap);
 		bgfx::destroyUniform(gl->s_tex);
 
 		if (bgfx::isValid(gl->u_halfTexel) )
@@ -1072,10 +1338,9 @@ namespace
 
 		for (uint32_t ii = 0, num = gl->ntextures; ii < num; ++ii)
 		{
-			if (bgfx::isValid(gl->textures[ii].id)
-			&& (gl->textures[ii].flags & NVG_IMAGE_NODELETE) == 0)
+			if (gl->textures[ii].image != 0)
 			{
-				bgfx::destroyTexture(gl->textures[ii].id);
+				glnvg__freeTexture(gl, &gl->textures[ii]);
 			}
 		}
 
@@ -1176,6 +1441,153 @@ bgfx::TextureHandle nvglImageHandle(NVGcontext* ctx, int image)
 	return tex->id;
 }
 
+int nvgReplaceImageRGBA(NVGcontext* ctx, int image, int w, int h, const unsigned char* data)
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	GLNVGtexture* tex = glnvg__findTexture(gl, image);
+	if (tex == NULL
+	|| tex->type != NVG_TEXTURE_RGBA)
+	{
+		return 0;
+	}
+
+	if (tex->width == w
+	&&  tex->height == h)
+	{
+		return nvgRenderUpdateTexture(gl, image, 0, 0, w, h, data);
+	}
+
+	// Created without memory (a texture created with memory is immutable), so
+	// that later updates and same size replacements of the image still apply.
+	bgfx::TextureHandle id = bgfx::createTexture2D(
+		  uint16_t(w)
+		, uint16_t(h)
+		, false
+		, 1
+		, bgfx::TextureFormat::RGBA8
+		, glnvg__textureFlags(tex->flags)
+		);
+	if (!bgfx::isValid(id) )
+	{
+		return 0;
+	}
+	bgfx::updateTexture2D(id, 0, 0, 0, 0, uint16_t(w), uint16_t(h), bgfx::copy(data, w * h * 4) );
+
+	// bgfx defers the destruction until the frames using the texture are rendered.
+	if (bgfx::isValid(tex->id) )
+	{
+		if ( (tex->flags & NVG_IMAGE_NODELETE) == 0)
+		{
+			bgfx::destroyTexture(tex->id);
+		}
+		gl->textureBytes -= tex->bytes;
+	}
+	tex->id       = id;
+	tex->width    = w;
+	tex->height   = h;
+	tex->flags   &= ~NVG_IMAGE_NODELETE;
+	tex->bytes    = w * h * 4;
+	tex->evicted  = false;
+	tex->lastUsed = gl->frame;
+	gl->textureBytes += tex->bytes;
+
+	return 1;
+}
+
+int nvgCreateImageRGBA16F(NVGcontext* ctx, int w, int h, int imageFlags, const uint16_t* data)
+{
+	NVGparams* params = nvgInternalParams(ctx);
+	return params->renderCreateTexture(params->userPtr, NVG_TEXTURE_RGBA16F, w, h, imageFlags, (const unsigned char*)data);
+}
+
+int nvgCreateImageRGBA32F(NVGcontext* ctx, int w, int h, int imageFlags, const float* data)
+{
+	NVGparams* params = nvgInternalParams(ctx);
+	return params->renderCreateTexture(params->userPtr, NVG_TEXTURE_RGBA32F, w, h, imageFlags, (const unsigned char*)data);
+}
+
+void nvgToneMap(NVGcontext* ctx, float exposure, float gamma, int falseColor)
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	gl->exposureScale = powf(2.0f, exposure);
+	gl->invGamma      = gamma > 0.0f ? 1.0f / gamma : 1.0f;
+	gl->falseColor    = falseColor ? 1.0f : 0.0f;
+}
+
+void nvgSetToneMapProgram(NVGcontext* ctx, bgfx::ProgramHandle program)
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	gl->toneMapProg = bgfx::isValid(program) ? program : gl->defaultToneMapProg;
+}
+
+int nvgToneMapSupported(NVGcontext* ctx)
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	return bgfx::isValid(gl->toneMapProg) ? 1 : 0;
+}
+
+int nvgSetImageReloadable(NVGcontext* ctx, int image, NVGimageReloadCallback callback, void* userPtr)
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	GLNVGtexture* tex = glnvg__findTexture(gl, image);
+	if (tex == NULL)
+	{
+		return 0;
+	}
+
+	tex->reload        = callback;
+	tex->reloadUserPtr = userPtr;
+	if (callback == NULL
+	&&  tex->evicted)
+	{
+		// The owner no longer restores the pixels: the image stays cleared.
+		glnvg__restoreTexture(gl, tex, true);
+	}
+
+	return 1;
+}
+
+void nvgSetTextureBudget(NVGcontext* ctx, size_t bytes)
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	gl->textureBudget = bytes;
+}
+
+size_t nvgTextureBudget(NVGcontext* ctx)
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	return gl->textureBudget;
+}
+
+void nvgTextureStats(NVGcontext* ctx, NVGtextureStats* stats)
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	bx::memSet(stats, 0, sizeof(*stats) );
+	stats->residentBytes = gl->textureBytes;
+	stats->budgetBytes   = gl->textureBudget;
+	stats->evictions     = gl->evictions;
+	stats->reloads       = gl->reloads;
+	for (int ii = 0; ii < gl->ntextures; ++ii)
+	{
+		const GLNVGtexture* tex = &gl->textures[ii];
+		if (tex->image == 0)
+		{
+			continue;
+		}
+
+		stats->images++;
+		if (tex->reload != NULL)
+		{
+			stats->reloadableImages++;
+		}
+		if (tex->evicted)
+		{
+			stats->evictedImages++;
+			stats->evictedBytes += tex->bytes;
+		}
+	}
+}
+
 NVGLUframebuffer* nvgluCreateFramebuffer(NVGcontext* ctx, int width, int height, int imageFlags, uint8_t viewId)
 {
 	NVGLUframebuffer* framebuffer = nvgluCreateFramebuffer(ctx, width, height, imageFlags);
@@ -1190,7 +1602,6 @@ NVGLUframebuffer* nvgluCreateFramebuffer(NVGcontext* ctx, int width, int height,
 
 NVGLUframebuffer* nvgluCreateFramebuffer(NVGcontext* _ctx, int _width, int _height, int _imageFlags)
 {
-	BX_UNUSED(_imageFlags);
 	bgfx::TextureHandle textures[] =
 	{
 		bgfx::createTexture2D(_width, _height, false, 1, bgfx::TextureFormat::RGBA8, BGFX_TEXTURE_RT),
@@ -1220,12 +1631,15 @@ NVGLUframebuffer* nvgluCreateFramebuffer(NVGcontext* _ctx, int _width, int _heig
 	tex->width  = _width;
 	tex->height = _height;
 	tex->type   = NVG_TEXTURE_RGBA;
-	tex->flags  = _imageFlags | NVG_IMAGE_PREMULTIPLIED;
+	tex->flags  = _imageFlags | NVG_IMAGE_PREMULTIPLIED | NVG_IMAGE_NODELETE; // Owned by the framebuffer
 	tex->id     = bgfx::getTexture(fbh);
+	tex->bytes  = _width * _height * 8; // Color and depth/stencil attachments
+	tex->lastUsed = gl->frame;
+	gl->textureBytes += tex->bytes;
 
 	NVGLUframebuffer* framebuffer = BX_NEW(gl->m_allocator, NVGLUframebuffer);
 	framebuffer->ctx    = _ctx;
-	framebuffer->image  = tex->id.idx;
+	framebuffer->image  = tex->image;
 	framebuffer->handle = fbh;
 
 	return framebuffer;
@@ -1271,3 +1685,8 @@ void nvgluSetViewFramebuffer(uint8_t viewId, NVGLUframebuffer* framebuffer)
 	bgfx::setViewFrameBuffer(viewId, framebuffer->handle);
 	bgfx::setViewSeq(viewId, true);
 }
+
+int nvgluFramebufferImageFlags()
+{
+	return bgfx::getCaps()->originBottomLeft ? NVG_IMAGE_FLIPY : 0;
+}
@@ -26,6 +26,66 @@ void nvgDelete(struct NVGcontext* ctx);
 uint8_t nvgViewId(struct NVGcontext* ctx);
 void nvgViewId(struct NVGcontext* ctx, unsigned char _viewId);
 
+// Replaces the pixels of an RGBA image, which may change its size. The image
+// keeps its handle and flags, so everything drawing it shows the new pixels.
+// Returns 0 if the image does not exist or is not an RGBA image.
+int nvgReplaceImageRGBA(struct NVGcontext* ctx, int image, int w, int h, const unsigned char* data);
+
+// Creates high dynamic range images from 16-bit half float or 32-bit float
+// RGBA pixels (data may be NULL). nvgUpdateImage() and nvgUpdateImageRegion()
+// take the pixels in the same format. Returns 0 if the renderer does not
+// support the texture format. Not every renderer filters 32-bit float
+// textures; use NVG_IMAGE_NEAREST or half floats for those.
+int nvgCreateImageRGBA16F(struct NVGcontext* ctx, int w, int h, int imageFlags, const uint16_t* data);
+int nvgCreateImageRGBA32F(struct NVGcontext* ctx, int w, int h, int imageFlags, const float* data);
+
+// Tone mapping of the color images drawn from now on (fonts are not affected).
+// The exposure (in stops) scales the tint of the image paint, which every
+// program applies. The gamma and the false color mapping (of the luminance,
+// clamped to [0, 1]) need the tone mapping program: without one they are
+// ignored. Changing the tone mapping only changes uniforms, never textures.
+// Reset with nvgToneMap(ctx, 0, 1, 0).
+void nvgToneMap(struct NVGcontext* ctx, float exposure, float gamma, int falseColor);
+
+// Sets the program used for the image fills with a gamma or a false color
+// mapping (the caller keeps ownership), or restores the built-in one if the
+// handle is invalid. The built-in program (fs_nanovg_tonemap.sc) is only
+// embedded for the OpenGL renderers. A program must use the uniforms of the
+// fill program plus u_toneMap (x: 1 / gamma, y: 1 if false color).
+void nvgSetToneMapProgram(struct NVGcontext* ctx, bgfx::ProgramHandle program);
+// Returns 1 if a tone mapping program is available.
+int nvgToneMapSupported(struct NVGcontext* ctx);
+
+// Texture accounting. Every image counts the bytes of its texture. When the
+// textures exceed the budget at the end of a frame, the textures of the least
+// recently drawn reloadable images are destroyed (evicted). When an evicted
+// image is drawn or partially updated again, its texture is recreated (cleared)
+// and its reload callback is called to restore the pixels, with nvgUpdateImage()
+// or nvgReplaceImageRGBA(). Updating or replacing the whole image restores it
+// without calling the callback. Images drawn in the current frame are never
+// evicted.
+typedef void (*NVGimageReloadCallback)(void* userPtr, int image);
+
+struct NVGtextureStats {
+	size_t residentBytes;   // Bytes of the textures currently allocated
+	size_t budgetBytes;     // Budget (0 if unlimited)
+	size_t evictedBytes;    // Bytes of the evicted images
+	int images;
+	int reloadableImages;
+	int evictedImages;
+	uint64_t evictions;     // Total number of evictions
+	uint64_t reloads;       // Total number of reloads
+};
+typedef struct NVGtextureStats NVGtextureStats;
+
+// Registers an image as reloadable (or not, if callback is NULL), which lets it
+// be evicted. Images of framebuffers are never evicted.
+int nvgSetImageReloadable(struct NVGcontext* ctx, int image, NVGimageReloadCallback callback, void* userPtr);
+// Sets the budget of the textures in bytes (0, the default, disables eviction).
+void nvgSetTextureBudget(struct NVGcontext* ctx, size_t bytes);
+size_t nvgTextureBudget(struct NVGcontext* ctx);
+void nvgTextureStats(struct NVGcontext* ctx, NVGtextureStats* stats);
+
 // Helper functions to create bgfx framebuffer to render to.
 // Example:
 //		float scale = 2;
@@ -45,10 +105,15 @@ void nvgViewId(struct NVGcontext* ctx, unsigned char _viewId);
 //		nvgFillPaint(ctx, paint);
 //		nvgFill(ctx);
 //		nvgEndFrame(ctx);
+// Renderers whose textures start at the bottom (bgfx::Caps::originBottomLeft)
+// show the framebuffer upside down unless its image is created with
+// NVG_IMAGE_FLIPY (or nvgluFramebufferImageFlags() is used).
 NVGLUframebuffer* nvgluCreateFramebuffer(NVGcontext* ctx, int width, int height, int imageFlags, uint8_t viewId);
 NVGLUframebuffer* nvgluCreateFramebuffer(NVGcontext* ctx, int width, int height, int imageFlags);
 void nvgluBindFramebuffer(NVGLUframebuffer* framebuffer);
 void nvgluDeleteFramebuffer(NVGLUframebuffer* framebuffer);
 void nvgluSetViewFramebuffer(uint8_t viewId, NVGLUframebuffer* framebuffer);
+// Returns NVG_IMAGE_FLIPY if the renderer needs it to show framebuffers upright.
+int nvgluFramebufferImageFlags();
 
 #endif // NANOVG_BGFX_H_HEADER_GUARD
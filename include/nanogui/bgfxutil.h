@@ -0,0 +1,283 @@
+/*
+    nanogui/bgfxutil.h -- Convenience classes for rendering with bgfx
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_BGFXUTIL
+#define NG_BGFXUTIL
+
+#include <nanogui/common.h>
+#include <bgfx/bgfx.h>
+#include <map>
+#include <stdexcept>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace half_float { class half; }
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+// bypass template specializations
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+NAMESPACE_BEGIN(detail)
+template <typename T> struct bgfx_type_traits;
+template <> struct bgfx_type_traits<uint32_t> { enum { index = 1 }; };
+template <> struct bgfx_type_traits<uint16_t> { enum { index = 1 }; };
+template <> struct bgfx_type_traits<int16_t> { enum { type = bgfx::AttribType::Int16, index = 0 }; };
+template <> struct bgfx_type_traits<uint8_t> { enum { type = bgfx::AttribType::Uint8, index = 0 }; };
+template <> struct bgfx_type_traits<float> { enum { type = bgfx::AttribType::Float, index = 0 }; };
+template <> struct bgfx_type_traits<half_float::half> { enum { type = bgfx::AttribType::Half, index = 0 }; };
+NAMESPACE_END(detail)
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+//  ----------------------------------------------------
+
+/**
+ * \class BGFXShader bgfxutil.h nanogui/bgfxutil.h
+ *
+ * \brief Helper class managing a bgfx program with its named vertex and
+ * index buffers and uniforms, the bgfx counterpart of \ref GLShader.
+ *
+ * Each attribute is stored in its own dynamic vertex buffer, bound to the
+ * vertex stream of its rank in the alphabetical order of the attribute
+ * names. Attributes are uploaded from Eigen matrices with one column per
+ * vertex. When a version number is passed, an upload whose version and size
+ * match the data already on the GPU is skipped, so that unchanged meshes are
+ * not uploaded again every frame; \ref updateAttrib() uploads a range of
+ * vertices only.
+ *
+ * Uniform handles are created on first use and cached by name.
+ */
+class NANOGUI_EXPORT BGFXShader {
+public:
+    /// Create an unitialized shader
+    BGFXShader() { mProgram.idx = bgfx::invalidHandle; }
+    ~BGFXShader() { free(); }
+
+    BGFXShader(const BGFXShader &) = delete;
+    BGFXShader &operator=(const BGFXShader &) = delete;
+
+    /// Initialize the shader with a program, which the shader then owns
+    void init(const std::string &name, bgfx::ProgramHandle program);
+
+    /// Initialize the shader with compiled shaders, which are destroyed with the program
+    void init(const std::string &name, bgfx::ShaderHandle vertexShader,
+              bgfx::ShaderHandle fragmentShader);
+
+    /// Return the name of the shader
+    const std::string &name() const { return mName; }
+
+    /// Return the bgfx program
+    bgfx::ProgramHandle program() const { return mProgram; }
+
+    /// Release the program, the buffers and the uniforms
+    void free();
+
+    /// Return the handle of a uniform, which is created on first use
+    bgfx::UniformHandle uniform(const std::string &name, bgfx::UniformType::Enum type,
+                                uint16_t num = 1);
+
+    /// Upload an Eigen matrix (one column per vertex) as a vertex attribute
+    template <typename Matrix> void uploadAttrib(const std::string &name, bgfx::Attrib::Enum attrib,
+                                                 const Matrix &M, int version = -1,
+                                                 bool normalized = false) {
+        typedef typename Matrix::Scalar Scalar;
+        uploadAttrib(name, attrib, (uint32_t) M.cols(), (int) M.rows(), sizeof(Scalar),
+                     (bgfx::AttribType::Enum) detail::bgfx_type_traits<Scalar>::type,
+                     normalized, M.data(), version);
+    }
+
+    /**
+     * \brief Upload the columns <tt>[first, first + count)</tt> of an Eigen matrix
+     * to an existing vertex attribute
+     *
+     * The buffer grows when the range extends past its end. The version of
+     * the attribute is set to \c version.
+     */
+    template <typename Matrix> void updateAttrib(const std::string &name, const Matrix &M,
+                                                 uint32_t first, uint32_t count, int version = -1) {
+        if (first + count > (uint32_t) M.cols())
+            throw std::runtime_error("updateAttrib(" + mName + ", " + name + ") : range out of bounds!");
+        updateAttrib(name, first, count, (int) M.rows(), sizeof(typename Matrix::Scalar),
+                     M.data() + (size_t) first * M.rows(), version);
+    }
+
+    /// Upload an index buffer (16 or 32 bit indices, three per column for triangles)
+    template <typename Matrix> void uploadIndices(const Matrix &M, int version = -1) {
+        typedef typename Matrix::Scalar Scalar;
+        static_assert(detail::bgfx_type_traits<Scalar>::index == 1,
+                      "uploadIndices(): indices must be 16 or 32 bit unsigned integers");
+        uploadIndices((uint32_t) M.size(), sizeof(Scalar), M.data(), version);
+    }
+
+    /// Upload the indices <tt>[first, first + count)</tt> (in storage order) of an Eigen matrix
+    template <typename Matrix> void updateIndices(const Matrix &M, uint32_t first, uint32_t count,
+                                                  int version = -1) {
+        if (first + count > (uint32_t) M.size())
+            throw std::runtime_error("updateIndices(" + mName + ") : range out of bounds!");
+        updateIndices(first, count, sizeof(typename Matrix::Scalar), M.data() + first, version);
+    }
+
+    /// Completely free an existing attribute buffer
+    void freeAttrib(const std::string &name);
+
+    /// Check if an attribute was registered a given name
+    bool hasAttrib(const std::string &name) const { return mBuffers.find(name) != mBuffers.end(); }
+
+    /// Return the version number of a given attribute (-1 if unknown)
+    int attribVersion(const std::string &name) const {
+        auto it = mBuffers.find(name);
+        return it == mBuffers.end() ? -1 : it->second.version;
+    }
+
+    /// Reset the version number of a given attribute, so that the next upload is not skipped
+    void resetAttribVersion(const std::string &name) {
+        auto it = mBuffers.find(name);
+        if (it != mBuffers.end())
+            it->second.version = -1;
+    }
+
+    /// Invalidate the version numbers associated with attribute data
+    void invalidateAttribs();
+
+    /// Set a uniform to a 4x4 matrix
+    void setUniform(const std::string &name, const Matrix4f &mat);
+    /// Set a uniform to a 3x3 matrix
+    void setUniform(const std::string &name, const Matrix3f &mat);
+    /// Set a \c vec4 uniform
+    void setUniform(const std::string &name, const Vector4f &v);
+    /// Set a \c vec4 uniform to a 3D vector (w = 0)
+    void setUniform(const std::string &name, const Vector3f &v) {
+        setUniform(name, Vector4f(v.x(), v.y(), v.z(), 0.f));
+    }
+    /// Set a \c vec4 uniform to a scalar (in x)
+    void setUniform(const std::string &name, float value) {
+        setUniform(name, Vector4f(value, 0.f, 0.f, 0.f));
+    }
+    /// Bind a texture to a sampler uniform
+    void setTexture(uint8_t stage, const std::string &name, bgfx::TextureHandle texture,
+                    uint32_t flags = UINT32_MAX);
+
+    /// Submit a sequence of vertices to a view (the primitive type is part of \c state)
+    void drawArray(uint8_t viewId, uint32_t offset, uint32_t count,
+                   uint64_t state = BGFX_STATE_DEFAULT);
+
+    /// Submit a sequence of primitives using the uploaded index buffer to a view
+    void drawIndexed(uint8_t viewId, uint32_t offset, uint32_t count,
+                     uint64_t state = BGFX_STATE_DEFAULT);
+
+    /// Return the size of all registered buffers in bytes
+    size_t bufferSize() const {
+        size_t size = 0;
+        for (auto const &buf : mBuffers)
+            size += (size_t) buf.second.capacity * buf.second.dim * buf.second.compSize;
+        return size;
+    }
+
+public:
+    /* Low-level API */
+    void uploadAttrib(const std::string &name, bgfx::Attrib::Enum attrib, uint32_t size, int dim,
+                      uint32_t compSize, bgfx::AttribType::Enum type, bool normalized,
+                      const void *data, int version = -1);
+    void updateAttrib(const std::string &name, uint32_t first, uint32_t count, int dim,
+                      uint32_t compSize, const void *data, int version = -1);
+    void uploadIndices(uint32_t size, uint32_t compSize, const void *data, int version = -1);
+    void updateIndices(uint32_t first, uint32_t count, uint32_t compSize, const void *data,
+                       int version = -1);
+
+protected:
+    /**
+     * \struct Buffer bgfxutil.h nanogui/bgfxutil.h
+     *
+     * A dynamic vertex or index buffer and the layout of its data.
+     */
+    struct Buffer {
+        bgfx::DynamicVertexBufferHandle vertexBuffer;
+        bgfx::DynamicIndexBufferHandle indexBuffer;
+        bgfx::VertexDecl decl;
+        uint32_t dim;
+        uint32_t compSize;
+        /// Component type of a vertex buffer (\c bgfx::AttribType::Count for indices)
+        bgfx::AttribType::Enum type;
+        bool normalized;
+        /// Number of vertices (or indices) uploaded
+        uint32_t size;
+        /// Number of vertices (or indices) the buffer holds
+        uint32_t capacity;
+        int version;
+    };
+
+    /// Bind the vertices <tt>[first, first + count)</tt> of every attribute (all of them if \c count is \c UINT32_MAX)
+    void bindBuffers(uint32_t first, uint32_t count);
+    static void destroyBuffer(Buffer &buffer);
+
+protected:
+    std::string mName;
+    bgfx::ProgramHandle mProgram;
+    std::map<std::string, Buffer> mBuffers;
+    std::map<std::string, bgfx::UniformHandle> mUniforms;
+};
+
+//  ----------------------------------------------------
+
+/**
+ * \class BGFXFramebuffer bgfxutil.h nanogui/bgfxutil.h
+ *
+ * \brief Helper class for creating bgfx framebuffers with a color and a
+ * depth/stencil attachment, the bgfx counterpart of \ref GLFramebuffer.
+ */
+class NANOGUI_EXPORT BGFXFramebuffer {
+public:
+    /// Default constructor: unusable until you call the ``init()`` method
+    BGFXFramebuffer() : mSize(Vector2i::Zero()), mSamples(0) { mFramebuffer.idx = bgfx::invalidHandle; }
+    ~BGFXFramebuffer() { free(); }
+
+    BGFXFramebuffer(const BGFXFramebuffer &) = delete;
+    BGFXFramebuffer &operator=(const BGFXFramebuffer &) = delete;
+
+    /// Create a new framebuffer with the specified size and number of MSAA samples (1, 2, 4, 8 or 16)
+    void init(const Vector2i &size, int nSamples = 1,
+              bgfx::TextureFormat::Enum colorFormat = bgfx::TextureFormat::RGBA8);
+
+    /// Release all associated resources
+    void free();
+
+    /// Render a view into the framebuffer, covering all of it
+    void bind(uint8_t viewId);
+
+    /// Render a view into the back buffer again
+    void release(uint8_t viewId);
+
+    /// Return whether or not the framebuffer has been initialized
+    bool ready() const { return bgfx::isValid(mFramebuffer); }
+
+    /// Return the bgfx framebuffer
+    bgfx::FrameBufferHandle handle() const { return mFramebuffer; }
+
+    /// Return the color texture (to sample it once the view was rendered)
+    bgfx::TextureHandle texture() const { return bgfx::getTexture(mFramebuffer, 0); }
+
+    /// Return the size of the framebuffer in pixels
+    const Vector2i &size() const { return mSize; }
+
+    /// Return the number of MSAA samples
+    int samples() const { return mSamples; }
+
+protected:
+    bgfx::FrameBufferHandle mFramebuffer;
+    Vector2i mSize;
+    int mSamples;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
@@ -14,6 +14,7 @@
 #define NG_COMBOBOX
 
 #include <nanogui/popupbutton.h>
+#include <nanogui/textindex.h>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -21,6 +22,11 @@ NAMESPACE_BEGIN(nanogui)
  * \class ComboBox combobox.h nanogui/combobox.h
  *
  * \brief Simple combo box widget based on a popup button.
+ *
+ * The popup lists the items in a \ref ListView, so only the visible entries
+ * are instantiated. When the combo box is searchable, typing while the popup
+ * is open filters the items by (case-insensitive) substring; the filter uses a
+ * \ref TextIndex that is built on demand.
  */
 class NANOGUI_EXPORT ComboBox : public PopupButton {
 public:
@@ -48,14 +54,49 @@ public:
     const std::vector<std::string> &items() const { return mItems; }
     const std::vector<std::string> &itemsShort() const { return mItemsShort; }
 
+    /// Return whether the popup shows a search field that filters the items
+    bool searchable() const { return mSearchable; }
+    /// Set whether the popup shows a search field that filters the items
+    void setSearchable(bool searchable);
+
+    /// Return the current search query
+    const std::string &query() const { return mQuery; }
+    /// Filter the items by the given search query
+    void setQuery(const std::string &query);
+
+    /// Return the maximum number of items visible in the popup without scrolling
+    int popupItemCount() const { return mPopupItemCount; }
+    /// Set the maximum number of items visible in the popup without scrolling
+    void setPopupItemCount(int count) { mPopupItemCount = std::max(count, 1); }
+
+    virtual void performLayout(NVGcontext *ctx) override;
     virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual bool keyboardCharacterEvent(unsigned int codepoint) override;
 
     virtual void save(Serializer &s) const override;
     virtual bool load(Serializer &s) override;
+protected:
+    /// Create the search field and item list of the popup
+    void initializePopup();
+    /// Select an item from the popup and close it
+    void selectItem(int index);
+    /// Return the item shown in the given row of the popup
+    int itemAt(int row) const { return mQuery.empty() ? row : mFiltered[row]; }
+
 protected:
     std::vector<std::string> mItems, mItemsShort;
     std::function<void(int)> mCallback;
     int mSelectedIndex;
+
+    TextBox *mSearchBox;
+    ListView *mList;
+    bool mSearchable;
+    int mPopupItemCount;
+    std::string mQuery;
+    /// Items matching \ref mQuery (unused while the query is empty)
+    std::vector<int> mFiltered;
+    TextIndex mIndex;
+    bool mIndexDirty;
 };
 
 NAMESPACE_END(nanogui)
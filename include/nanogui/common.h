@@ -104,6 +104,7 @@ struct GLFWwindow { /* Opaque handle type, never de-referenced within NanoGUI */
 
 struct NVGcolor;
 struct NVGglyphPosition;
+struct NVGLUframebuffer;
 struct GLFWcursor;
 
 #endif // DOXYGEN_SHOULD_SKIP_THIS
@@ -353,6 +354,8 @@ public:
 /* Forward declarations */
 template <typename T> class ref;
 class AdvancedGridLayout;
+class BGFXFramebuffer;
+class BGFXShader;
 class BoxLayout;
 class Button;
 class CheckBox;
@@ -363,25 +366,36 @@ class GLFramebuffer;
 class GLShader;
 class GridLayout;
 class GroupLayout;
+class ImageLoader;
 class ImagePanel;
 class ImageView;
 class Label;
 class Layout;
+class ListView;
+class LogView;
 class MessageDialog;
 class Object;
+class PieceTable;
 class Popup;
 class PopupButton;
 class ProgressBar;
+class RenderCanvas;
 class Screen;
 class Serializer;
 class Slider;
+class SpatialIndex;
 class StackedWidget;
 class TabHeader;
+class TableView;
 class TabWidget;
+class TextArea;
 class TextBox;
+class TextIndex;
 class GLCanvas;
 class Theme;
+class TiledImage;
 class ToolButton;
+class TreeView;
 class VScrollPanel;
 class Widget;
 class Window;
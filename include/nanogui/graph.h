@@ -14,6 +14,9 @@
 #define NG_GRAPH
 
 #include <nanogui/widget.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -44,19 +47,120 @@ public:
     const Color &textColor() const { return mTextColor; }
     void setTextColor(const Color &textColor) { mTextColor = textColor; }
 
-    const VectorXf &values() const { return mValues; }
-    VectorXf &values() { return mValues; }
-    void setValues(const VectorXf &values) { mValues = values; }
+    Eigen::Map<const VectorXf> values() const { return Eigen::Map<const VectorXf>(mValues.data(), valueCount()); }
+    /// Return a mutable reference to the values (invalidates the level-of-detail data, and releases the room reserved by \ref appendValues())
+    VectorXf &values() { mValues.conservativeResize(valueCount()); mValueCount = -1; mPyramidDirty = true; return mValues; }
+    void setValues(const VectorXf &values) { mValues = values; mValueCount = -1; mPyramidDirty = true; }
+
+    /// Append values to the plot; the level-of-detail data is updated incrementally
+    void appendValues(const float *values, size_t count);
+
+    /**
+     * \brief Return whether large plots are decimated to per-pixel min/max envelopes
+     *
+     * When enabled (the default) and there are more samples than pixel
+     * columns, each column is drawn from the first, minimum, maximum and last
+     * value of the samples it covers (M4 aggregation). These are looked up in
+     * a multi-resolution min/max pyramid, so the draw cost depends on the
+     * widget width rather than on the number of samples.
+     */
+    bool decimation() const { return mDecimation; }
+    /// Set whether large plots are decimated to per-pixel min/max envelopes
+    void setDecimation(bool decimation) { mDecimation = decimation; }
+
+    /**
+     * \brief Enable streaming mode backed by a lock-free ring buffer
+     *
+     * In streaming mode, the graph plots the most recent \c capacity samples
+     * submitted through \ref append() instead of \ref values(). One producer
+     * thread may call \ref append() concurrently with the UI thread, which
+     * drains the ring buffer at draw time.
+     *
+     * \param capacity
+     *     Size of the ring buffer and of the plotted window. Zero disables
+     *     streaming mode.
+     *
+     * \param overwrite
+     *     When the ring buffer is full, overwrite the oldest samples that have
+     *     not been drawn yet (\c true) or reject the new ones (\c false).
+     *
+     * Must not be called while a producer thread is appending.
+     */
+    void setStreamCapacity(size_t capacity, bool overwrite = true);
+    size_t streamCapacity() const { return mStreamCapacity; }
+    bool streamOverwrite() const { return mStreamOverwrite; }
+
+    /**
+     * \brief Submit samples from the producer thread (lock-free)
+     *
+     * \return The number of samples that were accepted, which is less than
+     * \c count only when the ring buffer is full and overwriting is disabled.
+     */
+    size_t append(const float *values, size_t count);
+
+    /// Return whether the producer submitted samples that have not been drawn yet
+    bool hasPendingData() const {
+        return mStreamHead.load(std::memory_order_acquire) !=
+               mStreamTail.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Set a function that is called when new samples arrive
+     *
+     * The callback runs on the producer thread when \ref append() adds samples
+     * to a drained ring buffer, i.e. once per drawn frame at most. See
+     * \ref Screen for waking up the UI thread. The callback may be changed
+     * while the producer appends samples.
+     */
+    void setDataCallback(const std::function<void()> &callback);
+    std::function<void()> dataCallback() const { return mDataCallback; }
 
     virtual Vector2i preferredSize(NVGcontext *ctx) const override;
     virtual void draw(NVGcontext *ctx) override;
+    virtual bool needsRedraw() override;
 
     virtual void save(Serializer &s) const override;
     virtual bool load(Serializer &s) override;
+protected:
+    /// Move the samples submitted through \ref append() into the plotted window
+    void drainStream();
+
+    /// Bring the min/max pyramid up to date with the \c n samples in \c data
+    void updatePyramid(const float *data, size_t n);
+
+    /// Return the number of values plotted
+    Eigen::Index valueCount() const { return mValueCount >= 0 ? mValueCount : mValues.size(); }
+
+    /// Compute the minimum and maximum over the samples <tt>[begin, end)</tt>
+    void valueRange(const float *data, size_t begin, size_t end,
+                    float &min, float &max) const;
+
 protected:
     std::string mCaption, mHeader, mFooter;
     Color mBackgroundColor, mForegroundColor, mTextColor;
+    /// Values, followed by the room reserved by \ref appendValues()
     VectorXf mValues;
+    /// Number of values in use, or -1 if all of \ref mValues is
+    Eigen::Index mValueCount;
+
+    bool mDecimation;
+    /* Level-of-detail data: level i (block size 2^(i+1)) of the min/max pyramid */
+    std::vector<std::vector<float>> mPyramidMin, mPyramidMax;
+    /// Number of samples covered by the pyramid
+    size_t mPyramidSize;
+    bool mPyramidDirty;
+
+    /* Streaming mode: ring buffer shared with the producer thread */
+    std::unique_ptr<std::atomic<float>[]> mStream;
+    size_t mStreamCapacity;
+    bool mStreamOverwrite;
+    /// Total number of samples published by / reserved by / drained from the producer
+    std::atomic<uint64_t> mStreamHead, mStreamReserved, mStreamTail;
+    /// Drained samples; the last \ref mStreamCapacity entries are plotted
+    std::vector<float> mStreamValues;
+    /// Guards \ref mDataCallback, which the producer thread reads
+    std::mutex mDataCallbackMutex;
+    std::function<void()> mDataCallback;
 };
 
 NAMESPACE_END(nanogui)
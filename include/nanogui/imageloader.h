@@ -0,0 +1,169 @@
+/*
+    nanogui/imageloader.h -- Decodes images on worker threads and uploads
+    them in the background
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_IMAGELOADER
+#define NG_IMAGELOADER
+
+#include <nanogui/common.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class ImageLoader imageloader.h nanogui/imageloader.h
+ *
+ * \brief Decodes images on worker threads and uploads them in the background.
+ *
+ * \ref load() returns a NanoVG image handle right away. The handle first
+ * refers to a one pixel placeholder; once a worker thread has decoded the
+ * image, \ref update() replaces the placeholder by the decoded pixels, so that
+ * an \ref ImagePanel or \ref ImageView showing the handle displays the image
+ * without further action.
+ *
+ * Every \ref Screen owns a loader (see \ref Screen::imageLoader()) and calls
+ * \ref update() at the start of each frame. To keep frame times steady, the
+ * images uploaded by a call to \ref update() amount to at most
+ * \ref uploadBudget() bytes; at least one image is uploaded per call so that
+ * images larger than the budget get through.
+ *
+ * When \ref reloadable() is set, uploaded images are registered with the
+ * texture budget of the NanoVG back-end (see \c nvgSetTextureBudget()): their
+ * textures may be evicted when they are not drawn, and are decoded again when
+ * they are drawn later.
+ *
+ * The loader does not know any file format: images are decoded by a function
+ * set with \ref setDecoder(), for instance one based on \c stb_image.
+ */
+class NANOGUI_EXPORT ImageLoader {
+public:
+    /**
+     * \brief Function decoding an image into 8-bit RGBA pixels
+     *
+     * Receives the name passed to \ref load() and stores the size and the
+     * pixels (in row-major order) of the image. Returns \c false if the image
+     * cannot be decoded. Called on the worker threads, concurrently.
+     */
+    typedef std::function<bool(const std::string &name, Vector2i &size,
+                               std::vector<uint8_t> &pixels)> Decoder;
+
+    /// Create a loader for a NanoVG context, with a worker per additional hardware thread by default
+    ImageLoader(NVGcontext *ctx, int threadCount = 0);
+    ~ImageLoader();
+
+    /// Return the function decoding images
+    const Decoder &decoder() const { return mDecoder; }
+    /// Set the function decoding images (before calling \ref load())
+    void setDecoder(const Decoder &decoder);
+
+    /**
+     * \brief Start loading an image and return its handle
+     *
+     * \c imageFlags are NanoVG image flags (\c NVGimageFlags). The caller
+     * owns the handle and must \ref cancel() it before deleting it.
+     */
+    int load(const std::string &name, int imageFlags = 0);
+
+    /// Stop loading or reloading an image (a pending image keeps showing the placeholder)
+    void cancel(int image);
+
+    /// Return whether uploaded images may be evicted and decoded again
+    bool reloadable() const { return mReloadable; }
+    /// Set whether images uploaded from now on may be evicted and decoded again
+    void setReloadable(bool reloadable) { mReloadable = reloadable; }
+
+    /// Return whether an image was decoded and uploaded (\c false for failed or cancelled images)
+    bool ready(int image) const { return mReady.count(image) != 0; }
+
+    /// Return the number of images that were not uploaded yet
+    size_t pendingCount() const { return mPending.size(); }
+
+    /// Return the maximum number of bytes uploaded per call to \ref update()
+    size_t uploadBudget() const { return mUploadBudget; }
+    void setUploadBudget(size_t uploadBudget) { mUploadBudget = uploadBudget; }
+
+    /**
+     * \brief Set a function that is called when an image is decoded
+     *
+     * The callback runs on a worker thread when a decoded image is queued
+     * for the next \ref update() and no other image was waiting, i.e. once
+     * per batch of results. See \ref Screen for waking up the UI thread.
+     */
+    void setDataCallback(const std::function<void()> &callback);
+    std::function<void()> dataCallback() const { return mDataCallback; }
+
+    /// Set a function that is called on the UI thread when an image is uploaded or failed to decode
+    void setCallback(const std::function<void(int, bool)> &callback) { mCallback = callback; }
+    std::function<void(int, bool)> callback() const { return mCallback; }
+
+    /// Upload decoded images within the upload budget (UI thread, before drawing); returns whether an image was uploaded
+    bool update();
+
+protected:
+    struct Job {
+        int image;
+        /// Distinguishes loads of a handle that was deleted and reused
+        uint64_t ticket;
+        std::string name;
+    };
+
+    struct Result {
+        int image;
+        uint64_t ticket;
+        bool success;
+        Vector2i size;
+        std::vector<uint8_t> pixels;
+    };
+
+    /// Queue an image for decoding
+    void enqueue(int image);
+    /// Reload callback of the images registered with the NanoVG back-end
+    static void reloadImage(void *loader, int image);
+    /// Body of the worker threads
+    void workerThread();
+
+protected:
+    NVGcontext *mContext;
+    Decoder mDecoder;
+    size_t mUploadBudget;
+    std::function<void()> mDataCallback;
+    std::function<void(int, bool)> mCallback;
+
+    bool mReloadable;
+
+    /* UI thread state */
+    /// Name of each image loaded and not cancelled
+    std::unordered_map<int, std::string> mNames;
+    /// Ticket of the load of each pending image
+    std::unordered_map<int, uint64_t> mPending;
+    std::unordered_set<int> mReady;
+    uint64_t mNextTicket;
+
+    /* State shared with the worker threads (started by the first load) */
+    int mThreadCount;
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<Job> mJobs;
+    std::deque<Result> mResults;
+    bool mStop;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
@@ -15,6 +15,13 @@
 #define NG_IMAGEPANEL
 
 #include <nanogui/widget.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -22,16 +29,107 @@ NAMESPACE_BEGIN(nanogui)
  * \class ImagePanel imagepanel.h nanogui/imagepanel.h
  *
  * \brief Image panel widget which shows a number of square-shaped icons.
+ *
+ * By default, every icon is drawn from its own NanoVG image handle. When a
+ * thumbnail source is set (see \ref setThumbnailSource()), the panel runs in
+ * atlas mode instead: it downscales the pixels of each image into a thumbnail
+ * and packs the thumbnails into a few shared atlas pages, so that the whole
+ * grid is drawn in a handful of draw calls. Thumbnails are only generated for
+ * the icons inside the visible part of the panel, at most
+ * \ref thumbnailsPerFrame() per frame. When the atlas pages exceed
+ * \ref atlasPageLimit(), the least recently drawn page is cleared and reused.
+ *
+ * In data-source mode (see \ref setDataSource()), the panel shows a number of
+ * images without an \ref images() list, and the thumbnail source runs on
+ * worker threads. A thumbnail is requested when the cell of its image becomes
+ * visible; requests are served in grid order, and the requests that were not
+ * started when their cell scrolls out of view are cancelled. Memory use thus
+ * follows the size of the viewport rather than the number of images.
  */
 class NANOGUI_EXPORT ImagePanel : public Widget {
 public:
     typedef std::vector<std::pair<int, std::string>> Images;
+
+    /**
+     * \brief Function producing the pixels of an image for its thumbnail
+     *
+     * Receives the index of the image in the grid and stores the size
+     * and the pixels (8-bit RGBA with straight alpha, in row-major order) of
+     * the image, at any resolution. Returns \c false if the image has no
+     * thumbnail.
+     */
+    typedef std::function<bool(int index, Vector2i &size,
+                               std::vector<uint8_t> &pixels)> ThumbnailSource;
 public:
     ImagePanel(Widget *parent);
 
-    void setImages(const Images &data) { mImages = data; }
+    /// Set the images (in atlas mode, the handles are not drawn and may be 0)
+    void setImages(const Images &data);
     const Images& images() const { return mImages; }
 
+    /// Return the function producing thumbnail pixels (atlas mode when set)
+    const ThumbnailSource &thumbnailSource() const { return mThumbnailSource; }
+    /// Set the function producing thumbnail pixels, enabling atlas mode (or disabling it if empty)
+    void setThumbnailSource(const ThumbnailSource &source);
+
+    /**
+     * \brief Show \c count images whose thumbnails are produced on worker threads
+     *
+     * \c source is called concurrently on \c threadCount worker threads (one
+     * per additional hardware thread by default), started by the first
+     * request. Calling \ref setImages() leaves data-source mode.
+     */
+    void setDataSource(int count, const ThumbnailSource &source, int threadCount = 0);
+
+    /// Return whether thumbnails are produced on worker threads
+    bool dataSourceMode() const { return mImageCount >= 0; }
+
+    /// Return the number of images shown
+    int imageCount() const { return mImageCount >= 0 ? mImageCount : (int) mImages.size(); }
+
+    /**
+     * \brief Set a function that is called when a worker thread produced a thumbnail
+     *
+     * The callback runs on a worker thread when a finished thumbnail is
+     * queued and no other one was waiting, i.e. once per batch of results;
+     * the thumbnails are packed into the atlas when the panel is next drawn.
+     * See \ref Screen for waking up the UI thread.
+     */
+    void setDataCallback(const std::function<void()> &callback);
+    std::function<void()> dataCallback() const { return mDataCallback; }
+
+    /// Return the width and height of the atlas pages in pixels
+    int atlasPageSize() const { return mAtlasPageSize; }
+    void setAtlasPageSize(int atlasPageSize);
+
+    /// Return the number of atlas pages kept when they are not drawn
+    int atlasPageLimit() const { return mAtlasPageLimit; }
+    void setAtlasPageLimit(int atlasPageLimit) { mAtlasPageLimit = atlasPageLimit; }
+
+    /// Return the number of atlas pages
+    int atlasPageCount() const { return (int) mPages.size(); }
+
+    /// Return the maximum number of thumbnails generated while drawing a frame
+    int thumbnailsPerFrame() const { return mThumbnailsPerFrame; }
+    void setThumbnailsPerFrame(int thumbnailsPerFrame) { mThumbnailsPerFrame = thumbnailsPerFrame; }
+
+    /// Return whether visible thumbnails were left to generate by the last frame (draw again, or wait for the data callback in data-source mode)
+    bool thumbnailsPending() const { return mThumbnailsPending; }
+
+    /// Generate the thumbnail of an image again when it is next drawn
+    void updateThumbnail(int index);
+
+    /**
+     * \brief Generate the thumbnails that could not be produced again when they are next drawn
+     *
+     * Failed thumbnails are also forgotten when their cell scrolls out of
+     * view, so that they are retried when it becomes visible again.
+     */
+    void retryFailedThumbnails();
+
+    /// Release all atlas pages
+    void clearAtlas();
+
     std::function<void(int)> callback() const { return mCallback; }
     void setCallback(const std::function<void(int)> &callback) { mCallback = callback; }
 
@@ -39,9 +137,73 @@ public:
     virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
     virtual Vector2i preferredSize(NVGcontext *ctx) const override;
     virtual void draw(NVGcontext* ctx) override;
+    virtual bool needsRedraw() override;
 protected:
+    virtual ~ImagePanel();
+
+    /// Atlas texture holding thumbnails, with a copy of its pixels
+    struct AtlasPage {
+        int image;
+        /// Premultiplied RGBA pixels
+        std::vector<uint8_t> pixels;
+        /// Skyline of the packed thumbnails as (x, y, width) segments
+        std::vector<Vector3i> skyline;
+        /// Region of the pixels not uploaded yet (empty if \c dirtyMin > \c dirtyMax)
+        Vector2i dirtyMin, dirtyMax;
+        uint32_t lastUsed;
+    };
+
+    /// Location of a thumbnail in the atlas (\c page is -1 if the thumbnail could not be produced)
+    struct Thumbnail {
+        int page;
+        Vector2i pos;
+    };
+
+    /// Thumbnail requested from the worker threads
+    struct Request {
+        int index;
+        /// Distinguishes requests made before the atlas was cleared
+        uint64_t generation;
+        /* Settings of the panel when the request was made, since the worker threads cannot read them */
+        int thumbSize;
+        int thumbPixels;
+        float ratio;
+    };
+
+    struct Result {
+        int index;
+        uint64_t generation;
+        bool success;
+        /// Premultiplied thumbnail pixels
+        std::vector<uint8_t> pixels;
+    };
+
     Vector2i gridSize() const;
     int indexForPosition(const Vector2i &p) const;
+    /// Draw every icon from its own image handle
+    void drawImages(NVGcontext *ctx);
+    /// Draw the icons from the atlas pages
+    void drawAtlas(NVGcontext *ctx);
+    /// Return the thumbnail of an image, generating it if the frame budget allows (or \c nullptr)
+    const Thumbnail *thumbnail(NVGcontext *ctx, int index, int &budget);
+    /// Copy thumbnail pixels into the atlas and record their location
+    const Thumbnail *storeThumbnail(NVGcontext *ctx, int index, const std::vector<uint8_t> &pixels);
+    /// Find room for a thumbnail, clearing or adding a page if needed
+    bool allocateThumbnail(NVGcontext *ctx, Thumbnail &thumb);
+    /// Delete an atlas page and forget its thumbnails
+    void releasePage(int page);
+    /// Move the thumbnails of the visible cells produced by the worker threads into the atlas
+    void collectResults(NVGcontext *ctx, const Vector2i &cellMin, const Vector2i &cellMax);
+    /// Replace the queued requests by those of the visible cells missing a thumbnail
+    void requestThumbnails(const std::vector<int> &indices);
+    /// Stop the worker threads and drop their requests
+    void stopWorkers();
+    /// Body of the worker threads
+    void workerThread();
+    /// Rasterize the shadow and border drawn around every thumbnail
+    void createDecoration(NVGcontext *ctx);
+    /// Delete the atlas textures
+    void releaseAtlas();
 protected:
     Images mImages;
     std::function<void(int)> mCallback;
@@ -49,6 +211,41 @@ protected:
     int mSpacing;
     int mMargin;
     int mMouseIndex;
+
+    /* Atlas mode */
+    ThumbnailSource mThumbnailSource;
+    int mAtlasPageSize;
+    int mAtlasPageLimit;
+    int mThumbnailsPerFrame;
+    bool mThumbnailsPending;
+    std::vector<AtlasPage> mPages;
+    std::unordered_map<int, Thumbnail> mThumbnails;
+    /// Image holding the shadow and border drawn around every thumbnail
+    int mDecorationImage;
+    /// Pixel ratio the atlas was generated for
+    float mAtlasRatio;
+    uint32_t mFrame;
+    NVGcontext *mContext;
+    std::vector<float> mRects;
+    std::vector<uint8_t> mThumbData;
+
+    /* Data-source mode */
+    /// Number of images, or -1 when \ref images() is used
+    int mImageCount;
+    /// Indices requested from the worker threads and not collected yet
+    std::unordered_set<int> mRequested;
+    /// Incremented when the atlas is cleared
+    uint64_t mGeneration;
+    std::function<void()> mDataCallback;
+
+    /* State shared with the worker threads */
+    int mThreadCount;
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<Request> mRequests;
+    std::deque<Result> mResults;
+    bool mStop;
 };
 
 NAMESPACE_END(nanogui)
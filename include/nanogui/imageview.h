@@ -16,8 +16,10 @@
 #define NG_IMAGEVIEW
 
 #include <nanogui/widget.h>
-#include <nanogui/glutil.h>
+#include <nanogui/tiledimage.h>
 #include <functional>
+#include <list>
+#include <unordered_map>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -25,15 +27,65 @@ NAMESPACE_BEGIN(nanogui)
  * \class ImageView imageview.h nanogui/imageview.h
  *
  * \brief Widget used to display images.
+ *
+ * The image is either a NanoVG image handle or a \ref TiledImage. When the
+ * size of the image behind a handle changes, for instance when an
+ * \ref ImageLoader replaces its placeholder, the image is fitted again.
+ *
+ * A tiled image is drawn from the level of its pyramid matching the current
+ * scale, and only the visible tiles of that level are loaded and uploaded.
+ * Uploaded tiles are kept in a cache whose least recently drawn tiles are
+ * released when it exceeds \ref tileCacheBudget(). While a tile is not
+ * uploaded yet, its area is drawn from a coarser level.
+ *
+ * High dynamic range images (see \c nvgCreateImageRGBA16F() and
+ * \c nvgCreateImageRGBA32F()) are tone mapped while drawing: the
+ * \ref exposure(), \ref gamma() and \ref falseColor() settings are uniforms
+ * of the NanoVG back-end, so changing them never uploads the image again.
  */
 class NANOGUI_EXPORT ImageView : public Widget {
 public:
-    ImageView(Widget* parent, GLuint imageID);
+    /**
+     * \brief Function reading the values of a block of pixels in bulk
+     *
+     * Receives the first pixel and the size of the block, and stores
+     * <tt>size.prod() * pixelValueChannels()</tt> values in \c values, in
+     * row-major order with the channels of each pixel next to each other.
+     */
+    typedef std::function<void(const Vector2i &origin, const Vector2i &size,
+                               float *values)> PixelValueCallback;
+
+    ImageView(Widget* parent, int image = 0);
+    ImageView(Widget* parent, TiledImage* image);
     ~ImageView();
 
-    void bindImage(GLuint imageId);
+    /// Show a NanoVG image handle
+    void bindImage(int image);
+    /// Show a tiled image
+    void bindImage(TiledImage* image);
+
+    /// Return the NanoVG image handle shown (0 if none or if a tiled image is shown)
+    int image() const { return mImage; }
+    /// Return the tiled image shown (or \c nullptr)
+    TiledImage* tiledImage() { return mTiledImage.get(); }
+    const TiledImage* tiledImage() const { return mTiledImage.get(); }
 
-    GLShader& imageShader() { return mShader; }
+    /// Return the maximum size in bytes of the uploaded tiles kept when they are not visible
+    size_t tileCacheBudget() const { return mTileCacheBudget; }
+    void setTileCacheBudget(size_t tileCacheBudget) { mTileCacheBudget = tileCacheBudget; }
+
+    /// Return the size in bytes of the uploaded tiles
+    size_t tileCacheSize() const { return mTileCacheSize; }
+
+    /// Return the maximum number of tiles loaded and uploaded while drawing a frame
+    int tileUploadsPerFrame() const { return mTileUploadsPerFrame; }
+    void setTileUploadsPerFrame(int tileUploadsPerFrame) { mTileUploadsPerFrame = tileUploadsPerFrame; }
+
+    /// Return whether visible tiles were left to upload by the last frame (draw again to complete the image)
+    bool tilesPending() const { return mTilesPending; }
+
+    /// Release all uploaded tiles
+    void clearTileCache();
 
     Vector2f positionF() const { return mPos.cast<float>(); }
     Vector2f sizeF() const { return mSize.cast<float>(); }
@@ -71,6 +123,43 @@ public:
     }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
+    /**
+     * \brief Show the numeric values of the visible pixels, read in bulk
+     *
+     * Replaces the pixel info callback with a fast path: the values of all
+     * visible pixels are read by a single call, formatted with
+     * \ref pixelValueDecimals() decimals into a preallocated buffer, and drawn
+     * as glyph quads of the font atlas in two batched draw calls (a shadow
+     * and the text). Each channel is shown on its own row.
+     */
+    void setPixelValueCallback(int channels, const PixelValueCallback& callback);
+    const PixelValueCallback& pixelValueCallback() const { return mPixelValueCallback; }
+    int pixelValueChannels() const { return mPixelValueChannels; }
+
+    int pixelValueDecimals() const { return mPixelValueDecimals; }
+    void setPixelValueDecimals(int pixelValueDecimals) { mPixelValueDecimals = pixelValueDecimals; }
+
+    /// Return the exposure of the image in stops (0 by default)
+    float exposure() const { return mExposure; }
+    void setExposure(float exposure) { mExposure = exposure; }
+
+    /**
+     * \brief Return the gamma applied after the exposure (1 by default)
+     *
+     * The gamma and the false color mapping need the tone mapping program of
+     * the NanoVG back-end, which is built in for the OpenGL renderers (see
+     * \c nvgToneMapSupported()); without it, only the exposure is applied.
+     */
+    float gamma() const { return mGamma; }
+    void setGamma(float gamma) { mGamma = gamma; }
+
+    /// Return whether the luminance of the image is shown in false colors
+    bool falseColor() const { return mFalseColor; }
+    void setFalseColor(bool falseColor) { mFalseColor = falseColor; }
+
+    /// Return whether the image is drawn with a tone mapping
+    bool toneMapped() const { return mExposure != 0 || mGamma != 1 || mFalseColor; }
+
     void setFontScaleFactor(float fontScaleFactor) { mFontScaleFactor = fontScaleFactor; }
     float fontScaleFactor() const { return mFontScaleFactor; }
 
@@ -134,10 +223,33 @@ public:
     void draw(NVGcontext* ctx) override;
 
 private:
+    /// Uploaded tile of a tiled image
+    struct Tile {
+        int image;
+        size_t bytes;
+        /// Frame in which the tile was last drawn
+        uint32_t lastUsed;
+        /// Position in the list of tiles ordered by last use
+        std::list<uint64_t>::iterator order;
+    };
+
     // Helper image methods.
-    void updateImageParameters();
+    void updateImageParameters(NVGcontext* ctx);
+    static uint64_t tileKey(int level, const Vector2i& tile) {
+        return ((uint64_t) level << 56) | ((uint64_t) tile.y() << 28) | (uint64_t) tile.x();
+    }
+    /// Return the image of an uploaded tile and mark it as used (0 if not uploaded)
+    int cachedTile(int level, const Vector2i& tile);
+    /// Load and upload a tile
+    int uploadTile(NVGcontext* ctx, int level, const Vector2i& tile);
+    /// Release the least recently drawn tiles until the cache fits in its budget
+    void evictTiles(NVGcontext* ctx);
 
     // Helper drawing methods.
+    void drawImage(NVGcontext* ctx);
+    void drawTiles(NVGcontext* ctx, const Vector2f& origin);
+    void drawTile(NVGcontext* ctx, const Vector2f& origin, int level, const Vector2i& tile,
+                  int image, const Vector2f& clipBegin, const Vector2f& clipEnd) const;
     void drawWidgetBorder(NVGcontext* ctx) const;
     void drawImageBorder(NVGcontext* ctx) const;
     void drawHelpers(NVGcontext* ctx) const;
@@ -146,11 +258,27 @@ private:
     void drawPixelInfo(NVGcontext* ctx, const float stride) const;
     void writePixelInfo(NVGcontext* ctx, const Vector2f& cellPosition,
                         const Vector2i& pixel, const float stride) const;
+    void drawPixelValues(NVGcontext* ctx, const float stride) const;
 
     // Image parameters.
-    GLShader mShader;
-    GLuint mImageID;
+    int mImage;
+    ref<TiledImage> mTiledImage;
     Vector2i mImageSize;
+    /// Set when a new image handle must be fitted
+    bool mImageChanged;
+
+    // Tile cache.
+    std::unordered_map<uint64_t, Tile> mTiles;
+    /// Keys of the uploaded tiles, most recently drawn first
+    std::list<uint64_t> mTileOrder;
+    size_t mTileCacheSize;
+    size_t mTileCacheBudget;
+    int mTileUploadsPerFrame;
+    bool mTilesPending;
+    uint32_t mFrame;
+    std::vector<uint8_t> mTileData;
+    /// Context the tiles were uploaded to
+    NVGcontext* mContext;
 
     // Image display parameters.
     float mScale;
@@ -158,6 +286,11 @@ private:
     bool mFixedScale;
     bool mFixedOffset;
 
+    // Tone mapping parameters.
+    float mExposure = 0;
+    float mGamma = 1;
+    bool mFalseColor = false;
+
     // Fine-tuning parameters.
     float mZoomSensitivity = 1.1f;
 
@@ -168,8 +301,17 @@ private:
     // Image pixel data display members.
     std::function<std::pair<std::string, Color>(const Vector2i&)> mPixelInfoCallback;
     float mFontScaleFactor = 0.2f;
+
+    // Numeric pixel value display members.
+    PixelValueCallback mPixelValueCallback;
+    int mPixelValueChannels = 0;
+    int mPixelValueDecimals = 0;
+    /// Values of the visible pixels, reused from frame to frame
+    mutable std::vector<float> mPixelValues;
+    /// Destination and atlas rectangles of the glyphs to draw
+    mutable std::vector<float> mGlyphRects;
 };
 
 NAMESPACE_END(nanogui)
 
-#endif NG_IMAGEVIEW
+#endif
@@ -139,6 +139,45 @@ protected:
     int mGroupIndent;
 };
 
+/**
+ * \class LayoutCellCache layout.h nanogui/layout.h
+ *
+ * \brief Contiguous per-cell measurements used by the grid layouts.
+ *
+ * Stores the visible children of a container together with their target
+ * sizes (the fixed size where specified, the preferred size otherwise), so
+ * that the solver can work on flat arrays instead of repeatedly querying the
+ * widget hierarchy. When caching is enabled, measurements are kept across
+ * layout passes and only cells that were explicitly invalidated (or a changed
+ * set of visible children) cause widgets to be re-measured.
+ */
+struct NANOGUI_EXPORT LayoutCellCache {
+    /// Visible children of the measured container (in order)
+    std::vector<Widget *> widgets;
+    /// Target size of each entry of \ref widgets
+    std::vector<Vector2i> sizes;
+    /// Widgets whose cached measurement is stale
+    std::vector<const Widget *> dirty;
+    /// Container that was measured last
+    const Widget *owner = nullptr;
+    /// Keep measurements across layout passes?
+    bool enabled = false;
+    /// Are the cached measurements usable?
+    bool valid = false;
+
+    /// Discard all cached measurements
+    void invalidate() { valid = false; dirty.clear(); }
+
+    /// Mark the measurement of a single widget as stale
+    void invalidate(const Widget *widget) {
+        if (valid)
+            dirty.push_back(widget);
+    }
+
+    /// Refresh the measurements of the visible children of \c widget
+    void update(NVGcontext *ctx, const Widget *widget);
+};
+
 /**
  * \class GridLayout layout.h nanogui/layout.h
  *
@@ -188,6 +227,23 @@ public:
     void setColAlignment(const std::vector<Alignment> &value) { mAlignment[0] = value; }
     void setRowAlignment(const std::vector<Alignment> &value) { mAlignment[1] = value; }
 
+    /**
+     * \brief Reuse cell measurements across layout passes
+     *
+     * When enabled, widgets are only re-measured when the set of visible
+     * children changes or when they were passed to \ref invalidate(const Widget *).
+     * This makes relayouts of large grids (e.g. property sheets with
+     * thousands of rows) cheap when only a single cell changed.
+     */
+    void setCaching(bool caching) { mCache.enabled = caching; mCache.invalidate(); }
+    /// Return whether cell measurements are reused across layout passes
+    bool caching() const { return mCache.enabled; }
+
+    /// Discard all cached cell measurements
+    void invalidate() { mCache.invalidate(); }
+    /// Re-measure only the given widget during the next layout pass
+    void invalidate(const Widget *widget) { mCache.invalidate(widget); }
+
     /* Implementation of the layout interface */
     virtual Vector2i preferredSize(NVGcontext *ctx, const Widget *widget) const override;
     virtual void performLayout(NVGcontext *ctx, Widget *widget) const override;
@@ -204,6 +260,7 @@ protected:
     int mResolution;
     Vector2i mSpacing;
     int mMargin;
+    mutable LayoutCellCache mCache;
 };
 
 /**
@@ -248,15 +305,15 @@ public:
      * \brief Helper struct to coordinate anchor points for the layout.
      */
     struct Anchor {
-        uint8_t pos[2];
-        uint8_t size[2];
+        uint16_t pos[2];
+        uint16_t size[2];
         Alignment align[2];
 
         Anchor() { }
 
         Anchor(int x, int y, Alignment horiz = Alignment::Fill,
               Alignment vert = Alignment::Fill) {
-            pos[0] = (uint8_t) x; pos[1] = (uint8_t) y;
+            pos[0] = (uint16_t) x; pos[1] = (uint16_t) y;
             size[0] = size[1] = 1;
             align[0] = horiz; align[1] = vert;
         }
@@ -264,8 +321,8 @@ public:
         Anchor(int x, int y, int w, int h,
               Alignment horiz = Alignment::Fill,
               Alignment vert = Alignment::Fill) {
-            pos[0] = (uint8_t) x; pos[1] = (uint8_t) y;
-            size[0] = (uint8_t) w; size[1] = (uint8_t) h;
+            pos[0] = (uint16_t) x; pos[1] = (uint16_t) y;
+            size[0] = (uint16_t) w; size[1] = (uint16_t) h;
             align[0] = horiz; align[1] = vert;
         }
 
@@ -301,7 +358,20 @@ public:
     void setColStretch(int index, float stretch) { mColStretch.at(index) = stretch; }
 
     /// Specify the anchor data structure for a given widget
-    void setAnchor(const Widget *widget, const Anchor &anchor) { mAnchor[widget] = anchor; }
+    void setAnchor(const Widget *widget, const Anchor &anchor) {
+        mAnchor[widget] = anchor;
+        mCache.invalidate();
+    }
+
+    /// Reuse cell measurements across layout passes (see \ref GridLayout::setCaching())
+    void setCaching(bool caching) { mCache.enabled = caching; mCache.invalidate(); }
+    /// Return whether cell measurements are reused across layout passes
+    bool caching() const { return mCache.enabled; }
+
+    /// Discard all cached cell measurements
+    void invalidate() { mCache.invalidate(); }
+    /// Re-measure only the given widget during the next layout pass
+    void invalidate(const Widget *widget) { mCache.invalidate(widget); }
 
     /// Retrieve the anchor data structure for a given widget
     Anchor anchor(const Widget *widget) const {
@@ -324,6 +394,9 @@ protected:
     std::vector<float> mColStretch, mRowStretch;
     std::unordered_map<const Widget *, Anchor> mAnchor;
     int mMargin;
+    mutable LayoutCellCache mCache;
+    /// Anchors of the cached cells (parallel to \ref LayoutCellCache::widgets)
+    mutable std::vector<Anchor> mCellAnchor;
 };
 
 NAMESPACE_END(nanogui)
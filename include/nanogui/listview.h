@@ -0,0 +1,143 @@
+/*
+    nanogui/listview.h -- Virtualized list that only instantiates widgets
+    for the rows that are currently visible
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_LISTVIEW
+#define NG_LISTVIEW
+
+#include <nanogui/widget.h>
+#include <functional>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class ListView listview.h nanogui/listview.h
+ *
+ * \brief Virtualized list that only instantiates widgets for the rows that
+ *        are currently visible.
+ *
+ * The rows are provided by a data source: a row count, a factory that creates
+ * a row widget, and a binder that configures a row widget to display a given
+ * row. Row widgets are recycled while scrolling, hence memory usage and frame
+ * time do not depend on the number of rows.
+ *
+ * Rows either have a fixed height (\ref setRowHeight()) or a variable height
+ * reported by a callback (\ref setRowHeightCallback()). Variable heights are
+ * queried once when a row first becomes visible and cached in a Fenwick tree,
+ * so that offsets and the row at a given offset are found in O(log n).
+ */
+class NANOGUI_EXPORT ListView : public Widget {
+public:
+    ListView(Widget *parent);
+
+    /// Return the number of rows
+    int rowCount() const { return mRowCount; }
+    /// Set the number of rows; all visible rows are bound again
+    void setRowCount(int rowCount);
+
+    /// Return the function that creates a row widget (as a child of the given list)
+    std::function<Widget *(ListView *)> rowFactory() const { return mRowFactory; }
+    /// Set the function that creates a row widget (as a child of the given list)
+    void setRowFactory(const std::function<Widget *(ListView *)> &rowFactory);
+
+    /// Return the function that configures a row widget to display a row
+    std::function<void(Widget *, int)> rowBinder() const { return mRowBinder; }
+    /// Set the function that configures a row widget to display a row
+    void setRowBinder(const std::function<void(Widget *, int)> &rowBinder);
+
+    /// Return the fixed row height (or the estimate for unmeasured variable-height rows)
+    int rowHeight() const { return mRowHeight; }
+    /// Set the fixed row height (or the estimate for unmeasured variable-height rows)
+    void setRowHeight(int rowHeight);
+
+    /// Return the callback reporting the height of a row (if any)
+    std::function<int(int)> rowHeightCallback() const { return mRowHeightCallback; }
+    /// Set a callback reporting the height of a row, which enables variable row heights
+    void setRowHeightCallback(const std::function<int(int)> &callback);
+
+    /// Discard the cached height of a row and bind it again if it is visible
+    void invalidateRow(int row);
+    /// Bind all visible rows again, e.g. after the underlying data changed
+    void reloadData();
+
+    /// Return the scroll offset in pixels
+    int scrollOffset() const { return mScrollOffset; }
+    /// Set the scroll offset in pixels
+    void setScrollOffset(int offset);
+    /// Scroll such that the given row is visible
+    void scrollToRow(int row);
+
+    /// Return the vertical offset of a row within the content
+    int rowOffset(int row) const;
+    /// Return the row at the given vertical offset within the content
+    int rowAt(int offset) const;
+    /// Return the height of all rows combined
+    int contentHeight() const { return rowOffset(mRowCount); }
+
+    /// Return the range of rows with instantiated widgets as <tt>[first, last)</tt>
+    std::pair<int, int> visibleRows() const;
+    /// Return the widget showing the given row (or \c nullptr if it is not visible)
+    Widget *rowWidget(int row) const;
+
+    virtual void performLayout(NVGcontext *ctx) override;
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual void draw(NVGcontext *ctx) override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    /// Instantiate, recycle and position the row widgets for the current scroll offset
+    void updateRows(NVGcontext *ctx);
+    /// Query and cache the height of a variable-height row
+    void measureRow(int row);
+    /// Return the (cached) height of a row
+    int heightOf(int row) const;
+    /// Reset the cached row heights to the estimate
+    void resetHeights();
+    /// Return a row widget from the pool, or create a new one
+    Widget *acquireRow();
+    /// Hide all row widgets and return them to the pool
+    void releaseRows();
+    /// Remove all row widgets, including the pooled ones
+    void clearRows();
+
+protected:
+    /// Row widget along with the row it currently displays
+    struct VisibleRow {
+        int row;
+        Widget *widget;
+        bool bound;
+    };
+
+    int mRowCount;
+    int mRowHeight;
+    int mScrollOffset;
+    std::function<Widget *(ListView *)> mRowFactory;
+    std::function<void(Widget *, int)> mRowBinder;
+    std::function<int(int)> mRowHeightCallback;
+
+    /* Variable row heights: cached values and a Fenwick tree over them */
+    std::vector<int> mHeights;
+    std::vector<int> mHeightTree;
+    std::vector<uint8_t> mHeightKnown;
+
+    /// Rows with instantiated widgets, sorted by row
+    std::vector<VisibleRow> mRows;
+    /// Hidden row widgets available for reuse
+    std::vector<Widget *> mFreeRows;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
@@ -0,0 +1,197 @@
+/*
+    nanogui/logview.h -- Scrolling log console that accepts lines from
+    any thread and filters them in the background
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_LOGVIEW
+#define NG_LOGVIEW
+
+#include <nanogui/widget.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class LogView logview.h nanogui/logview.h
+ *
+ * \brief Scrolling log console that accepts lines from any thread and filters
+ *        them in the background.
+ *
+ * Any number of threads may call \ref append() concurrently: submitted text
+ * is pushed onto a lock-free list, which the UI thread drains when the view is
+ * drawn. The most recent \ref maxLines() lines are kept in a ring buffer, and
+ * older lines are discarded.
+ *
+ * Only the visible lines are drawn; the width of each line is measured once,
+ * when it is first drawn. While following the tail (the default), the view
+ * stays scrolled to the most recent line; scrolling up stops following, and
+ * scrolling back to the bottom resumes it.
+ *
+ * When a filter is set, only the lines containing it (ignoring ASCII case)
+ * are shown. The matching runs on a worker thread, in chunks, so filtering a
+ * full buffer does not stall the UI: matches appear as they are found, and
+ * new lines are filtered as they arrive.
+ */
+class NANOGUI_EXPORT LogView : public Widget {
+public:
+    LogView(Widget *parent, size_t maxLines = 10000);
+
+    /**
+     * \brief Submit text from any thread (lock-free)
+     *
+     * Line breaks split the text into several lines. When the UI thread falls
+     * behind by more than \ref maxLines() submissions, further text is
+     * dropped and counted in \ref droppedLines().
+     */
+    void append(const std::string &text);
+
+    /// Return the number of submissions dropped because the view fell behind
+    uint64_t droppedLines() const { return mDropped.load(std::memory_order_relaxed); }
+
+    /**
+     * \brief Set a function that is called when new lines or filter results arrive
+     *
+     * The callback runs on the thread calling \ref append() (when it adds
+     * text to a drained list, i.e. once per drawn frame at most) or on the
+     * filter thread, after it published a chunk of matches. See \ref Screen
+     * for waking up the UI thread. The callback may be changed while other
+     * threads append text.
+     */
+    void setDataCallback(const std::function<void()> &callback);
+    std::function<void()> dataCallback() const { return mDataCallback; }
+
+    /// Return the maximum number of lines kept
+    size_t maxLines() const { return mLines.size(); }
+    /// Set the maximum number of lines kept, discarding the oldest lines if needed
+    void setMaxLines(size_t maxLines);
+
+    /// Discard all lines
+    void clear();
+
+    /// Return the number of lines kept (after moving submitted text into the view)
+    size_t lineCount() { drainPending(); return mLineCount; }
+    /// Return a line, where 0 is the oldest line kept
+    const std::string &line(size_t index) { drainPending(); return *lineAt(mFirstLine + index).text; }
+
+    /// Return the filter (empty if all lines are shown)
+    const std::string &filter() const { return mFilter; }
+    /// Show only the lines containing \c filter, ignoring ASCII case
+    void setFilter(const std::string &filter);
+    /// Return whether the filter thread is still looking for matches
+    bool filtering() const;
+
+    /// Return the number of lines shown (the matching lines when filtering)
+    size_t visibleLineCount() const { return mFilter.empty() ? mLineCount : mMatches.size(); }
+
+    /// Return whether the view stays scrolled to the most recent line
+    bool followTail() const { return mFollowTail; }
+    /// Set whether the view stays scrolled to the most recent line
+    void setFollowTail(bool followTail) { mFollowTail = followTail; }
+
+    /// Return the height of a line in pixels
+    int lineHeight() const { return (int) std::ceil(fontSize() * 1.2f); }
+
+    /// Return the scroll offset in pixels
+    const Vector2i &scrollOffset() const { return mScrollOffset; }
+    /// Set the scroll offset in pixels; the view follows the tail if scrolled to the bottom
+    void setScrollOffset(const Vector2i &offset);
+
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual void draw(NVGcontext *ctx) override;
+    virtual bool needsRedraw() override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    virtual ~LogView();
+
+    /// Text submitted through \ref append() that was not moved into the view yet
+    struct PendingText {
+        std::string text;
+        PendingText *next;
+    };
+
+    struct Line {
+        /// Shared with the filter thread
+        std::shared_ptr<const std::string> text;
+        /// Measured width, or a negative value if the line was not drawn yet
+        float width;
+    };
+
+    /// Line to be matched by the filter thread
+    struct FilterItem {
+        uint64_t index;
+        std::shared_ptr<const std::string> text;
+    };
+
+    /// Move submitted text into the ring buffer (UI thread)
+    void drainPending();
+    /// Append a line to the ring buffer, discarding the oldest line if it is full
+    void addLine(std::string &&text, std::vector<FilterItem> &filterItems);
+    /// Collect the matches found by the filter thread
+    void collectMatches();
+    /// Return a line by its sequence number
+    Line &lineAt(uint64_t index) { return mLines[(size_t) (index % mLines.size())]; }
+    /// Return the sequence number of the line shown in a row
+    uint64_t rowLine(size_t row) const {
+        return mFilter.empty() ? mFirstLine + row : mMatches[row];
+    }
+    int contentHeight() const;
+    /// Body of the filter thread
+    void filterThread();
+
+protected:
+    /* Lock-free list of submitted text, most recent first */
+    std::atomic<PendingText *> mPending;
+    std::atomic<size_t> mPendingCount;
+    /// Maximum number of pending submissions (the maximum number of lines)
+    std::atomic<size_t> mPendingLimit;
+    std::atomic<uint64_t> mDropped;
+    std::function<void()> mDataCallback;
+
+    /* Ring buffer of lines, numbered in order of arrival */
+    std::vector<Line> mLines;
+    uint64_t mFirstLine;
+    size_t mLineCount;
+    float mMaxLineWidth;
+
+    std::string mFilter;
+    /// Sequence numbers of the matching lines found so far (in order)
+    std::deque<uint64_t> mMatches;
+
+    /* State shared with the filter thread */
+    std::thread mFilterThread;
+    mutable std::mutex mFilterMutex;
+    std::condition_variable mFilterCondition;
+    std::string mFilterPattern;
+    uint64_t mFilterGeneration;
+    std::deque<FilterItem> mFilterQueue;
+    std::vector<uint64_t> mFilterResults;
+    bool mFilterBusy;
+    bool mFilterStop;
+
+    bool mFollowTail;
+    Vector2i mScrollOffset;
+    bool mDragScrollbar;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
@@ -29,10 +29,16 @@
 #include <nanogui/entypo.h>
 #include <nanogui/messagedialog.h>
 #include <nanogui/textbox.h>
+#include <nanogui/textarea.h>
 #include <nanogui/slider.h>
+#include <nanogui/imageloader.h>
 #include <nanogui/imagepanel.h>
 #include <nanogui/imageview.h>
 #include <nanogui/vscrollpanel.h>
+#include <nanogui/listview.h>
+#include <nanogui/tableview.h>
+#include <nanogui/treeview.h>
+#include <nanogui/logview.h>
 #include <nanogui/colorwheel.h>
 #include <nanogui/graph.h>
 #include <nanogui/formhelper.h>
@@ -40,5 +46,7 @@
 #include <nanogui/tabheader.h>
 #include <nanogui/tabwidget.h>
 #include <nanogui/glcanvas.h>
+#include <nanogui/rendercanvas.h>
+#include <nanogui/bgfxutil.h>
 
 #endif
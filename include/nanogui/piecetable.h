@@ -0,0 +1,152 @@
+/*
+    nanogui/piecetable.h -- Text buffer with logarithmic-time edits and
+    line lookups, and an undo history that does not copy text
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_PIECETABLE
+#define NG_PIECETABLE
+
+#include <nanogui/common.h>
+#include <string>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class PieceTable piecetable.h nanogui/piecetable.h
+ *
+ * \brief Text buffer with logarithmic-time edits and line lookups, and an
+ *        undo history that does not copy text.
+ *
+ * The text is a sequence of pieces, each referring to a range of either the
+ * original text or an append-only buffer receiving all inserted text. The
+ * pieces are kept in an implicit treap augmented with the length and number
+ * of line breaks of each subtree, and the positions of all line breaks of
+ * both buffers are indexed. Inserting, erasing, and converting between byte
+ * offsets and line numbers therefore take O(log n) expected time, where n is
+ * the number of pieces.
+ *
+ * Buffers are never modified in place, so the undo history only records
+ * pieces: undoing an erase re-inserts the removed pieces.
+ */
+class NANOGUI_EXPORT PieceTable {
+public:
+    PieceTable();
+
+    /// Replace the text and clear the undo history
+    void setText(const std::string &text);
+    /// Return the entire text
+    std::string text() const { return text(0, length()); }
+    /// Return (at most) \c length bytes of text starting at \c offset
+    std::string text(size_t offset, size_t length) const;
+
+    /// Return the length of the text in bytes
+    size_t length() const;
+    /// Return the number of lines (one more than the number of line breaks)
+    size_t lineCount() const;
+    /// Return the offset of the first byte of a line
+    size_t lineStart(size_t line) const;
+    /// Return the offset of the line break ending a line (or the text length for the last line)
+    size_t lineEnd(size_t line) const;
+    /// Return the line containing the byte at \c offset
+    size_t lineOf(size_t offset) const;
+
+    /**
+     * \brief Replace \c length bytes starting at \c offset by \c text
+     *
+     * The replacement is undone in a single step. When \c mergeUndo is set and
+     * an insertion directly continues the previous one, both are undone
+     * together (e.g. for typing).
+     */
+    void replace(size_t offset, size_t length, const std::string &text, bool mergeUndo = false);
+    /// Insert text at the given offset
+    void insert(size_t offset, const std::string &text, bool mergeUndo = false) {
+        replace(offset, 0, text, mergeUndo);
+    }
+    /// Erase \c length bytes starting at \c offset
+    void erase(size_t offset, size_t length) { replace(offset, length, std::string()); }
+
+    bool canUndo() const { return !mUndo.empty(); }
+    bool canRedo() const { return !mRedo.empty(); }
+    /// Revert the last edit; \c cursor receives the offset after the restored text
+    bool undo(size_t *cursor = nullptr);
+    /// Reapply the last reverted edit; \c cursor receives the offset after the new text
+    bool redo(size_t *cursor = nullptr);
+    void clearHistory() { mUndo.clear(); mRedo.clear(); }
+
+    /// Return a counter that is incremented by every modification
+    uint64_t revision() const { return mRevision; }
+
+protected:
+    struct Piece {
+        uint32_t buffer;
+        size_t start;
+        size_t length;
+    };
+
+    struct Node {
+        Piece piece;
+        size_t newlines;
+        size_t totalLength;
+        size_t totalNewlines;
+        int left, right;
+        uint32_t priority;
+    };
+
+    /// Edit that replaced the pieces \c removed by \c inserted at \c offset
+    struct Edit {
+        size_t offset;
+        std::vector<Piece> removed;
+        std::vector<Piece> inserted;
+    };
+
+    /// Count the line breaks in a range of a buffer
+    size_t newlinesIn(uint32_t buffer, size_t start, size_t length) const;
+    /// Return the offset of the k-th (1-based) line break
+    size_t findNewline(size_t k) const;
+    void appendToBuffer(uint32_t buffer, const std::string &text);
+
+    int createNode(const Piece &piece);
+    void update(int t);
+    int merge(int a, int b);
+    void split(int t, size_t offset, int &left, int &right);
+    void collect(int t, std::vector<Piece> &pieces) const;
+    void release(int t);
+    void extract(int t, size_t offset, size_t length, std::string &out) const;
+    /// Grow the piece ending at \c offset by \c count bytes, if it ends where the add buffer did
+    bool extend(int t, size_t offset, size_t count);
+
+    /// Remove a range and return its pieces
+    std::vector<Piece> removeRange(size_t offset, size_t length);
+    /// Remove a range and return the treap holding it
+    int removeRangeTree(size_t offset, size_t length);
+    /// Insert pieces at the given offset
+    void insertPieces(size_t offset, const std::vector<Piece> &pieces);
+    static size_t totalLength(const std::vector<Piece> &pieces);
+
+protected:
+    /// Original text (0) and append-only buffer of inserted text (1)
+    std::string mBuffers[2];
+    /// Offsets of all line breaks in each buffer
+    std::vector<size_t> mNewlines[2];
+
+    std::vector<Node> mNodes;
+    std::vector<int> mFreeNodes;
+    int mRoot;
+    uint32_t mRandomState;
+
+    std::vector<Edit> mUndo, mRedo;
+    uint64_t mRevision;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
@@ -0,0 +1,105 @@
+/*
+    nanogui/rendercanvas.h -- Canvas widget rendering bgfx content into an
+    offscreen framebuffer
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_RENDERCANVAS
+#define NG_RENDERCANVAS
+
+#include <nanogui/widget.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class RenderCanvas rendercanvas.h nanogui/rendercanvas.h
+ *
+ * \brief Canvas widget rendering bgfx content into an offscreen framebuffer.
+ *
+ * The canvas owns a bgfx view (reserved with \ref Screen::acquireViewId())
+ * and a framebuffer of the size of the widget. Each frame, the view is
+ * cleared with the background color and \ref drawCanvas() submits the user
+ * content to it; the framebuffer is then drawn as a NanoVG image like any
+ * other widget. Unlike \ref GLCanvas, the NanoVG frame is never interrupted
+ * and no OpenGL call is made, so the canvas works with every bgfx renderer.
+ *
+ * \ref renderScale() sets the resolution of the framebuffer relative to the
+ * framebuffer pixels covered by the widget: expensive 3D content can be
+ * rendered at a reduced resolution and stretched to the widget.
+ *
+ * Usage: override \ref drawCanvas() in subclasses to provide custom drawing code.
+ */
+class NANOGUI_EXPORT RenderCanvas : public Widget {
+public:
+    RenderCanvas(Widget *parent);
+
+    /// Return the background color
+    const Color &backgroundColor() const { return mBackgroundColor; }
+    /// Set the background color
+    void setBackgroundColor(const Color &backgroundColor) { mBackgroundColor = backgroundColor; }
+
+    /// Set whether to draw the widget border or not
+    void setDrawBorder(const bool bDrawBorder) { mDrawBorder = bDrawBorder; }
+    /// Return whether the widget border gets drawn or not
+    const bool &drawBorder() const { return mDrawBorder; }
+
+    /// Return the resolution of the framebuffer relative to the pixels of the widget (1 by default)
+    float renderScale() const { return mRenderScale; }
+    /// Set the resolution of the framebuffer relative to the pixels of the widget
+    void setRenderScale(float renderScale) { mRenderScale = renderScale > 0.01f ? renderScale : 0.01f; }
+
+    /// Return the bgfx view of the canvas (-1 before it is first drawn)
+    int viewId() const { return mViewId; }
+
+    /// Return the size of the framebuffer in pixels
+    const Vector2i &framebufferSize() const { return mFramebufferSize; }
+
+    /// Draw the canvas
+    virtual void draw(NVGcontext *ctx) override;
+
+    /**
+     * \brief Submit the content of the canvas to its view
+     *
+     * Override this method to draw the actual content. The view is bound to
+     * the framebuffer, cleared, and its rectangle covers the \c size pixels
+     * of the framebuffer; set its transforms with \c bgfx::setViewTransform().
+     * Renderers whose textures start at the bottom
+     * (\c bgfx::Caps::originBottomLeft) show the framebuffer flipped, so that
+     * the content appears upright with the usual projection of each renderer.
+     */
+    virtual void drawCanvas(uint8_t /* viewId */, const Vector2i & /* size */) { }
+
+    /// Save and load widget properties
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    virtual ~RenderCanvas();
+
+    /// Internal helper function for drawing the widget border
+    void drawWidgetBorder(NVGcontext* ctx) const;
+    /// Release the framebuffer and the view
+    void releaseFramebuffer();
+
+protected:
+    Color mBackgroundColor;
+    bool mDrawBorder;
+    float mRenderScale;
+
+    NVGLUframebuffer *mFramebuffer;
+    Vector2i mFramebufferSize;
+    int mViewId;
+    /// Screen the view was reserved from
+    Screen *mScreen;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
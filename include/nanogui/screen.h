@@ -15,6 +15,8 @@
 #pragma once
 
 #include <nanogui/widget.h>
+#include <nanogui/imageloader.h>
+#include <memory>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -23,6 +25,14 @@ NAMESPACE_BEGIN(nanogui)
  *
  * \brief Represents a display surface (i.e. a full-screen or windowed GLFW window)
  * and forms the root element of a hierarchy of nanogui widgets.
+ *
+ * Widgets fed from other threads (\ref Graph, \ref LogView, \ref ImageLoader
+ * and \ref ImagePanel) only pick up new data when the screen is drawn. Each
+ * of them takes a data callback, which it invokes off the UI thread when it
+ * has something new to show. An application that does not redraw
+ * continuously can post an event to its window loop from that callback
+ * (e.g. \c glfwPostEmptyEvent()), and thus redraw on demand instead of at a
+ * fixed rate.
  */
 class NANOGUI_EXPORT Screen : public Widget {
     friend class Widget;
@@ -79,6 +89,24 @@ public:
     /// Return a pointer to the underlying nanoVG draw context
     NVGcontext *nvgContext() { return mNVGContext; }
 
+    /// Return the number of widgets skipped during the last frame because they were clipped away (their descendants are not visited, hence not counted)
+    int culledWidgets() const { return mCulledWidgets; }
+
+    /// Return the loader decoding images in the background, which is updated at the start of each frame
+    ImageLoader *imageLoader();
+
+    /**
+     * \brief Reserve a bgfx view for rendering offscreen content
+     *
+     * bgfx renders views in the order of their ids, and the user interface
+     * is drawn by the last view (255). Views are handed out downwards from
+     * 254 so that they are rendered before the user interface, which leaves
+     * the low ids to the application. Throws if no view is left.
+     */
+    uint8_t acquireViewId();
+    /// Give back a view reserved by \ref acquireViewId()
+    void releaseViewId(uint8_t viewId);
+
     using Widget::performLayout;
 
     /// Compute the layout of all widgets
@@ -118,6 +146,13 @@ protected:
     Color mBackground;
     std::string mCaption;
     bool mFullscreen;
+    int mCulledWidgets;
+    /// Widgets culled so far while drawing the current frame
+    int mFrameCulledWidgets;
+    std::unique_ptr<ImageLoader> mImageLoader;
+    /// Next view id handed out when no released id is left
+    int mNextViewId;
+    std::vector<uint8_t> mFreeViewIds;
 };
 
 NAMESPACE_END(nanogui)
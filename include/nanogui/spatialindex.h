@@ -0,0 +1,60 @@
+/*
+    nanogui/spatialindex.h -- Uniform grid over the children of a widget,
+    used to accelerate hit testing
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_SPATIALINDEX
+#define NG_SPATIALINDEX
+
+#include <nanogui/common.h>
+#include <utility>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class SpatialIndex spatialindex.h nanogui/spatialindex.h
+ *
+ * \brief Uniform grid over the bounding rectangles of a list of widgets.
+ *
+ * Every grid cell stores the (ascending) indices of the widgets overlapping
+ * it. The cells are kept in a single compressed array, so a point query
+ * returns a contiguous range without any allocations. The cell size is
+ * chosen such that each cell holds roughly one widget on average.
+ *
+ * See \ref Widget::setSpatialIndex().
+ */
+class NANOGUI_EXPORT SpatialIndex {
+public:
+    /// Range of widget indices (ascending) returned by \ref query()
+    typedef std::pair<const int *, const int *> Range;
+
+    SpatialIndex();
+
+    /// Rebuild the index from the rectangles of the given widgets
+    void build(const std::vector<Widget *> &widgets);
+
+    /// Return the indices of all widgets whose rectangle may contain \c p
+    Range query(const Vector2i &p) const;
+
+    /// Return the number of cells along each axis
+    const Vector2i &dimensions() const { return mDim; }
+
+protected:
+    Vector2i mOrigin;
+    Vector2i mCellSize;
+    Vector2i mDim;
+    std::vector<int> mCellStart;
+    std::vector<int> mEntries;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
@@ -0,0 +1,184 @@
+/*
+    nanogui/tableview.h -- Virtualized table with a frozen header that
+    draws its cells directly from columnar data callbacks
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_TABLEVIEW
+#define NG_TABLEVIEW
+
+#include <nanogui/widget.h>
+#include <functional>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TableView tableview.h nanogui/tableview.h
+ *
+ * \brief Virtualized table with a frozen header that draws its cells directly
+ *        from columnar data callbacks.
+ *
+ * Cells are not widgets: every column provides a callback returning the text
+ * of a row, and only the cells inside the viewport are drawn, in a single
+ * pass. The text of each drawn cell is cached along with its measured width
+ * and its truncated form for the current column width, so steady-state frames
+ * neither call back into the data source nor measure text. When the data
+ * changes, \ref invalidateCell(), \ref invalidateRow() or \ref invalidateColumn()
+ * refetch only the affected cells.
+ *
+ * Rows are addressed by their index in the data source ("model row"), while
+ * the table displays them in sorted order. Clicking a column header sorts by
+ * that column; dragging the right edge of a header resizes the column.
+ */
+class NANOGUI_EXPORT TableView : public Widget {
+public:
+    TableView(Widget *parent);
+
+    /// Append a column whose cells are provided by \c text (called with the model row)
+    int addColumn(const std::string &title, const std::function<std::string(int)> &text,
+                  int width = 100);
+    /// Return the number of columns
+    int columnCount() const { return (int) mColumns.size(); }
+
+    const std::string &columnTitle(int column) const { return mColumns[column].title; }
+    void setColumnTitle(int column, const std::string &title) { mColumns[column].title = title; }
+
+    int columnWidth(int column) const { return mColumns[column].width; }
+    void setColumnWidth(int column, int width);
+
+    /// Return the horizontal alignment of a column (\c NVG_ALIGN_LEFT, \c NVG_ALIGN_CENTER or \c NVG_ALIGN_RIGHT)
+    int columnAlignment(int column) const { return mColumns[column].alignment; }
+    /// Set the horizontal alignment of a column (\c NVG_ALIGN_LEFT, \c NVG_ALIGN_CENTER or \c NVG_ALIGN_RIGHT)
+    void setColumnAlignment(int column, int alignment) { mColumns[column].alignment = alignment; }
+
+    /**
+     * \brief Set a "less than" comparison of two model rows used to sort by a column
+     *
+     * Columns without a comparator are sorted by their text.
+     */
+    void setColumnComparator(int column, const std::function<bool(int, int)> &comparator) {
+        mColumns[column].comparator = comparator;
+    }
+
+    /// Return the number of rows
+    int rowCount() const { return mRowCount; }
+    /// Set the number of rows; the cached cell text is discarded and the rows are sorted again
+    void setRowCount(int rowCount);
+
+    int rowHeight() const { return mRowHeight; }
+    void setRowHeight(int rowHeight) { mRowHeight = std::max(rowHeight, 1); }
+
+    int headerHeight() const { return mHeaderHeight; }
+    void setHeaderHeight(int headerHeight) { mHeaderHeight = std::max(headerHeight, 0); }
+
+    /// Sort the rows by a column (-1: data source order)
+    void sortByColumn(int column, bool ascending = true);
+    int sortColumn() const { return mSortColumn; }
+    bool sortAscending() const { return mSortAscending; }
+
+    /// Return the model row displayed at the given position
+    int modelRow(int viewRow) const { return mOrder[viewRow]; }
+
+    /// Return the selected model row (or -1)
+    int selectedRow() const { return mSelectedRow; }
+    /// Select a model row (or -1 to clear the selection)
+    void setSelectedRow(int row) { mSelectedRow = row; }
+
+    /// Return the function called with the model row when the selection changes
+    std::function<void(int)> selectionCallback() const { return mSelectionCallback; }
+    /// Set the function called with the model row when the selection changes
+    void setSelectionCallback(const std::function<void(int)> &callback) { mSelectionCallback = callback; }
+
+    /// Refetch the text of a single cell the next time it is drawn
+    void invalidateCell(int row, int column);
+    /// Refetch the text of all cells of a model row the next time they are drawn
+    void invalidateRow(int row);
+    /// Refetch the text of all cells of a column the next time they are drawn
+    void invalidateColumn(int column);
+    /// Refetch the text of all cells and sort the rows again
+    void invalidate();
+
+    /// Return the scroll offset in pixels
+    const Vector2i &scrollOffset() const { return mScrollOffset; }
+    /// Set the scroll offset in pixels
+    void setScrollOffset(const Vector2i &offset);
+
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
+    virtual bool mouseMotionEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual void draw(NVGcontext *ctx) override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    /// Cached text of a cell, along with its form truncated to the column width
+    struct CellText {
+        std::string text;
+        std::string display;
+        float width = 0.f;
+        int fitWidth = -1;
+        bool valid = false;
+        uint32_t lastUsed = 0;
+    };
+
+    struct Column {
+        std::string title;
+        std::function<std::string(int)> text;
+        std::function<bool(int, int)> comparator;
+        int width;
+        int alignment;
+    };
+
+    /// Compute the size of the area showing cells and which scroll bars are needed
+    Vector2i bodySize(bool *vscroll = nullptr, bool *hscroll = nullptr) const;
+    /// Return the cached text of a cell, fetching and measuring it if needed
+    const CellText &cellText(NVGcontext *ctx, int row, int column, int available);
+    /// Return the column whose right header edge is close to \c x (or -1)
+    int resizeHandleAt(int x) const;
+    /// Reorder the rows according to the current sort column
+    void applySort();
+    /// Discard cached cell text that has not been drawn recently
+    void trimCache(size_t visibleCells);
+
+    static uint64_t cellKey(int row, int column) {
+        return ((uint64_t) (uint32_t) row << 32) | (uint32_t) column;
+    }
+
+protected:
+    std::vector<Column> mColumns;
+    int mRowCount;
+    int mRowHeight;
+    int mHeaderHeight;
+    int mSortColumn;
+    bool mSortAscending;
+    int mSelectedRow;
+    std::function<void(int)> mSelectionCallback;
+    Vector2i mScrollOffset;
+
+    /// View order: model row displayed at each position
+    std::vector<int> mOrder;
+
+    std::unordered_map<uint64_t, CellText> mCellCache;
+    uint32_t mFrame;
+    /// Font size the cached text was measured with
+    int mCacheFontSize;
+
+    /* Interaction state */
+    int mResizeColumn;
+    int mPressedColumn;
+    int mDragScrollbar;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
@@ -0,0 +1,161 @@
+/*
+    nanogui/textarea.h -- Multi-line text editor backed by a piece table
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_TEXTAREA
+#define NG_TEXTAREA
+
+#include <nanogui/widget.h>
+#include <nanogui/piecetable.h>
+#include <functional>
+#include <map>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TextArea textarea.h nanogui/textarea.h
+ *
+ * \brief Multi-line text editor backed by a piece table.
+ *
+ * The text is stored in a \ref PieceTable, so edits, undo, and the mapping
+ * between byte offsets and lines take logarithmic time regardless of the
+ * size of the text. The glyph positions of a line are computed when it first
+ * becomes visible and cached until the line is edited; only the visible
+ * lines are laid out and drawn. Lines are not wrapped.
+ *
+ * The cursor and selection are byte offsets into the UTF-8 text.
+ */
+class NANOGUI_EXPORT TextArea : public Widget {
+public:
+    TextArea(Widget *parent, const std::string &value = "");
+
+    /// Return the entire text (this copies the text; see \ref buffer())
+    std::string value() const { return mText.text(); }
+    /// Replace the text, clearing the undo history
+    void setValue(const std::string &value);
+
+    /// Return the underlying text buffer
+    const PieceTable &buffer() const { return mText; }
+
+    bool editable() const { return mEditable; }
+    void setEditable(bool editable);
+
+    /// Return the function called whenever the text is modified
+    std::function<void()> callback() const { return mCallback; }
+    /// Set the function called whenever the text is modified
+    void setCallback(const std::function<void()> &callback) { mCallback = callback; }
+
+    /// Return the cursor position (a byte offset)
+    size_t cursorPosition() const { return mCursorPos; }
+    /// Move the cursor to a byte offset and clear the selection
+    void setCursorPosition(size_t position);
+    /// Select the range between two byte offsets, leaving the cursor at \c end
+    void select(size_t begin, size_t end);
+
+    /// Return the selected text
+    std::string selectedText() const;
+    /// Replace the selection (or insert at the cursor) by the given text
+    void insertText(const std::string &text);
+
+    /// Undo the last edit
+    bool undo();
+    /// Redo the last undone edit
+    bool redo();
+
+    /// Return the height of a line in pixels
+    int lineHeight() const { return (int) std::ceil(fontSize() * 1.25f); }
+
+    /// Return the scroll offset in pixels
+    const Vector2i &scrollOffset() const { return mScrollOffset; }
+    /// Set the scroll offset in pixels
+    void setScrollOffset(const Vector2i &offset);
+
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual bool keyboardEvent(int key, int scancode, int action, int modifiers) override;
+    virtual bool keyboardCharacterEvent(unsigned int codepoint) override;
+    virtual void draw(NVGcontext *ctx) override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    /// Cached glyph positions of a line
+    struct LineLayout {
+        std::string text;
+        /// Byte offset of every glyph within the line, followed by the length of the line
+        std::vector<size_t> offsets;
+        /// Horizontal position of every glyph, followed by the width of the line
+        std::vector<float> positions;
+        uint32_t lastUsed;
+    };
+
+    /// Return the NanoVG context of the screen containing this widget (or \c nullptr)
+    NVGcontext *context();
+    /// Return the layout of a line, computing it if needed
+    const LineLayout &lineLayout(NVGcontext *ctx, size_t line);
+    /// Discard the cached layouts of all lines starting from \c line
+    void invalidateLines(size_t line);
+
+    /// Return the horizontal position of a byte offset
+    float offsetToX(NVGcontext *ctx, size_t offset);
+    /// Return the byte offset within a line closest to a horizontal position
+    size_t xToOffset(NVGcontext *ctx, size_t line, float x);
+    /// Return the byte offset closest to a point in widget coordinates
+    size_t positionAt(const Vector2i &p);
+
+    /// Return the byte offset of the character before/after \c offset
+    size_t previousCharacter(size_t offset) const;
+    size_t nextCharacter(size_t offset) const;
+
+    /// Move the cursor, extending the selection if \c select is set
+    void moveCursor(size_t position, bool select);
+    /// Move the cursor by the given number of lines, keeping its horizontal position
+    void moveCursorLines(long lines, bool select);
+    /// Replace a range of text, maintaining the layout cache and the cursor
+    void replaceRange(size_t begin, size_t end, const std::string &text, bool mergeUndo);
+    bool hasSelection() const { return mSelectionPos != std::string::npos && mSelectionPos != mCursorPos; }
+    bool deleteSelection();
+    bool copySelection();
+    void pasteFromClipboard();
+
+    /// Return the size of the text area, excluding the scroll bar
+    Vector2i viewSize() const;
+    /// Scroll such that the cursor is visible
+    void scrollToCursor(NVGcontext *ctx);
+
+protected:
+    PieceTable mText;
+    bool mEditable;
+    std::function<void()> mCallback;
+
+    size_t mCursorPos;
+    /// Anchor of the selection (\c std::string::npos if nothing is selected)
+    size_t mSelectionPos;
+    /// Horizontal position kept while moving the cursor vertically (negative if unset)
+    float mPreferredX;
+    bool mScrollToCursor;
+
+    Vector2i mScrollOffset;
+    /// Width of the widest line laid out so far
+    float mMaxLineWidth;
+    bool mDragScrollbar;
+
+    std::map<size_t, LineLayout> mLayouts;
+    uint32_t mFrame;
+    /// Font size the cached layouts were computed with
+    int mLayoutFontSize;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
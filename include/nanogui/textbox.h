@@ -88,12 +88,25 @@ protected:
     void pasteFromClipboard();
     bool deleteSelection();
 
-    void updateCursor(NVGcontext *ctx, float lastx,
-                      const NVGglyphPosition *glyphs, int size);
-    float cursorIndex2Position(int index, float lastx,
-                               const NVGglyphPosition *glyphs, int size);
-    int position2CursorIndex(float posx, float lastx,
-                             const NVGglyphPosition *glyphs, int size);
+    /**
+     * \brief Record that \c removed bytes at \c position of the edited text
+     * were replaced by \c inserted bytes
+     *
+     * The cached glyph positions are updated around the edited range only,
+     * the next time the text box is drawn.
+     */
+    void textEdited(int position, int removed, int inserted);
+    /// Discard the cached glyph positions of the edited text
+    void invalidateGlyphs() { mGlyphsValid = false; }
+    /// Bring the cached glyph positions up to date with the edited text
+    void updateGlyphs(NVGcontext *ctx);
+    /// Return the number of glyphs of the edited text
+    int glyphCount() const { return (int) mGlyphX.size() - 1; }
+
+    /// Handle pending mouse events, given the position of the first glyph
+    void updateCursor(float originX);
+    float cursorIndex2Position(int index, float originX) const;
+    int position2CursorIndex(float posx, float originX) const;
 
     /// The location (if any) for the spin area.
     enum class SpinArea { None, Top, Bottom };
@@ -120,6 +133,16 @@ protected:
     int mMouseDownModifier;
     float mTextOffset;
     double mLastClick;
+
+    /* Glyph positions of the edited text, relative to its first glyph */
+    /// Byte offset of every glyph, followed by the length of the text
+    std::vector<int> mGlyphOffsets;
+    /// Horizontal position of every glyph, followed by the width of the text
+    std::vector<float> mGlyphX;
+    bool mGlyphsValid;
+    int mGlyphFontSize;
+    /// Edited range since the last update: [begin, oldEnd) in the cached text is now [begin, newEnd)
+    int mDirtyBegin, mDirtyOldEnd, mDirtyNewEnd;
 };
 
 /**
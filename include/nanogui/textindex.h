@@ -0,0 +1,69 @@
+/*
+    nanogui/textindex.h -- Trigram index for case-insensitive substring
+    search over a list of strings
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_TEXTINDEX
+#define NG_TEXTINDEX
+
+#include <nanogui/common.h>
+#include <string>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TextIndex textindex.h nanogui/textindex.h
+ *
+ * \brief Trigram index for case-insensitive substring search over a list of
+ *        strings.
+ *
+ * Every trigram (three consecutive bytes, ASCII letters folded to lower case)
+ * maps to the ascending list of strings containing it. The lists are kept in
+ * a single compressed array. A query intersects the lists of its trigrams,
+ * starting with the shortest one, and only verifies the remaining candidates.
+ * Queries shorter than three bytes fall back to a linear scan.
+ *
+ * The index refers to strings by position, hence it must be rebuilt when the
+ * list changes. See \ref ComboBox::setSearchable().
+ */
+class NANOGUI_EXPORT TextIndex {
+public:
+    TextIndex();
+
+    /// Rebuild the index for the given strings
+    void build(const std::vector<std::string> &items);
+
+    /// Remove all entries
+    void clear();
+
+    /// Return the number of strings covered by the index
+    size_t size() const { return mItemCount; }
+
+    /**
+     * \brief Find all strings that contain \c query (ignoring case)
+     *
+     * \c items must be the list the index was built from (this is not needed
+     * for queries shorter than three bytes). The indices of the matching
+     * strings are stored in ascending order in \c result.
+     */
+    void find(const std::vector<std::string> &items, const std::string &query,
+              std::vector<int> &result) const;
+
+protected:
+    size_t mItemCount;
+    std::vector<uint32_t> mTrigrams;
+    std::vector<uint32_t> mOffsets;
+    std::vector<int> mPostings;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
@@ -0,0 +1,93 @@
+/*
+    nanogui/tiledimage.h -- Image split into a pyramid of tiles that are
+    produced on demand
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_TILEDIMAGE
+#define NG_TILEDIMAGE
+
+#include <nanogui/object.h>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TiledImage tiledimage.h nanogui/tiledimage.h
+ *
+ * \brief Image split into a pyramid of tiles that are produced on demand.
+ *
+ * Level 0 of the pyramid is the full resolution image, and every following
+ * level halves the size of the previous one (rounding up), down to the first
+ * level that fits in a single tile. Each level is cut into square tiles of
+ * \ref tileSize() pixels; the tiles along the right and bottom edges of a
+ * level may be smaller.
+ *
+ * Subclasses implement \ref loadTile() to produce the pixels of a tile, for
+ * instance by reading them from a file or by downsampling the tiles of the
+ * previous level. An \ref ImageView showing a tiled image only requests the
+ * tiles that are visible, at the level matching its scale.
+ */
+class NANOGUI_EXPORT TiledImage : public Object {
+public:
+    TiledImage(const Vector2i &size, int tileSize = 256)
+        : mSize(size), mTileSize(tileSize), mLevelCount(1) {
+        if (size.x() <= 0 || size.y() <= 0 || tileSize <= 0)
+            throw std::runtime_error("TiledImage: invalid image or tile size!");
+        while (levelSize(mLevelCount - 1).maxCoeff() > mTileSize)
+            ++mLevelCount;
+    }
+
+    /// Return the size of the full resolution image
+    const Vector2i &size() const { return mSize; }
+
+    /// Return the width and height of a tile in pixels
+    int tileSize() const { return mTileSize; }
+
+    /// Return the number of levels of the pyramid
+    int levelCount() const { return mLevelCount; }
+
+    /// Return the size of a level in pixels
+    Vector2i levelSize(int level) const {
+        return Vector2i(((mSize.x() - 1) >> level) + 1, ((mSize.y() - 1) >> level) + 1);
+    }
+
+    /// Return the number of tiles along each axis of a level
+    Vector2i tileCount(int level) const {
+        return ((levelSize(level).array() + mTileSize - 1) / mTileSize).matrix();
+    }
+
+    /// Return the size of a tile in pixels
+    Vector2i tileExtent(int level, const Vector2i &tile) const {
+        Vector2i begin = tile * mTileSize;
+        return (levelSize(level) - begin).cwiseMin(mTileSize);
+    }
+
+    /**
+     * \brief Produce the pixels of a tile
+     *
+     * \c data receives <tt>tileExtent(level, tile)</tt> pixels in row-major
+     * order, as 8-bit RGBA values with straight (not premultiplied) alpha.
+     * This function is called on the thread drawing the user interface.
+     */
+    virtual void loadTile(int level, const Vector2i &tile, uint8_t *data) = 0;
+
+protected:
+    virtual ~TiledImage() { }
+
+protected:
+    Vector2i mSize;
+    int mTileSize;
+    int mLevelCount;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
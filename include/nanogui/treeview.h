@@ -0,0 +1,182 @@
+/*
+    nanogui/treeview.h -- Virtualized tree that loads the children of a
+    node only when it is expanded
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#ifndef NG_TREEVIEW
+#define NG_TREEVIEW
+
+#include <nanogui/widget.h>
+#include <functional>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TreeView treeview.h nanogui/treeview.h
+ *
+ * \brief Virtualized tree that loads the children of a node only when it is
+ *        expanded.
+ *
+ * Nodes are identified by opaque ids chosen by the model. The children of a
+ * node are requested from the model the first time the node is expanded, and
+ * labels are requested when a row is first drawn. Only the visible rows are
+ * drawn, directly and without per-row widgets.
+ *
+ * The visible rows (the pre-order sequence of all nodes whose ancestors are
+ * expanded) are kept in an implicit treap. Looking up the node shown in a row,
+ * and the row showing a node, takes O(log n) expected time; expanding a node
+ * splices the rows of its visible subtree in as a whole.
+ */
+class NANOGUI_EXPORT TreeView : public Widget {
+public:
+    typedef uint64_t NodeId;
+
+    TreeView(Widget *parent);
+
+    /// Set the function returning the children of a node (called once per node, on first expansion)
+    void setChildrenCallback(const std::function<std::vector<NodeId>(NodeId)> &callback) {
+        mChildrenCallback = callback;
+        reload();
+    }
+    std::function<std::vector<NodeId>(NodeId)> childrenCallback() const { return mChildrenCallback; }
+
+    /**
+     * \brief Set the function reporting whether a node has children
+     *
+     * This lets the tree omit the expander of leaves without loading their
+     * (empty) list of children. Without it, every node that was not expanded
+     * yet shows an expander.
+     */
+    void setHasChildrenCallback(const std::function<bool(NodeId)> &callback) { mHasChildrenCallback = callback; }
+    std::function<bool(NodeId)> hasChildrenCallback() const { return mHasChildrenCallback; }
+
+    /// Set the function returning the label of a node
+    void setLabelCallback(const std::function<std::string(NodeId)> &callback) { mLabelCallback = callback; }
+    std::function<std::string(NodeId)> labelCallback() const { return mLabelCallback; }
+
+    /// Return the id of the (hidden) root node, whose children form the top level
+    NodeId rootId() const { return mRootId; }
+    /// Set the id of the (hidden) root node and reload the tree
+    void setRootId(NodeId id) { mRootId = id; reload(); }
+
+    /// Discard all loaded nodes and request the top level from the model again
+    void reload();
+    /// Request the labels of all nodes from the model again when they are drawn
+    void invalidateLabels();
+
+    /// Return the number of visible rows
+    int rowCount() const { return treapSize(mTreapRoot); }
+    /// Return the node shown in a row
+    NodeId nodeAt(int row) const { return mNodes[nodeIndexAt(row)].id; }
+    /// Return the depth of the node shown in a row (0 for the top level)
+    int depth(int row) const { return mNodes[nodeIndexAt(row)].depth; }
+
+    /// Return whether the node shown in a row is expanded
+    bool expanded(int row) const { return mNodes[nodeIndexAt(row)].expanded; }
+    /// Expand or collapse the node shown in a row
+    void setExpanded(int row, bool expanded);
+
+    /// Return the row of the selected node (or -1 if nothing visible is selected)
+    int selectedRow() const;
+    /// Select the node shown in a row (or -1 to clear the selection)
+    void setSelectedRow(int row);
+
+    /// Return the function called with the id of a node when it is selected
+    std::function<void(NodeId)> selectionCallback() const { return mSelectionCallback; }
+    /// Set the function called with the id of a node when it is selected
+    void setSelectionCallback(const std::function<void(NodeId)> &callback) { mSelectionCallback = callback; }
+
+    int rowHeight() const { return mRowHeight; }
+    void setRowHeight(int rowHeight) { mRowHeight = std::max(rowHeight, 1); }
+
+    /// Return the horizontal indentation per tree level
+    int indentation() const { return mIndentation; }
+    /// Set the horizontal indentation per tree level
+    void setIndentation(int indentation) { mIndentation = std::max(indentation, 0); }
+
+    /// Return the scroll offset in pixels
+    int scrollOffset() const { return mScrollOffset; }
+    /// Set the scroll offset in pixels
+    void setScrollOffset(int offset);
+    /// Scroll such that the given row is visible
+    void scrollToRow(int row);
+
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual void draw(NVGcontext *ctx) override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    struct Node {
+        NodeId id;
+        int parent;
+        int depth;
+        /// Position among the children of the parent
+        int indexInParent;
+        std::vector<int> children;
+        bool loaded;
+        bool expanded;
+        /// Whether the node has children: 1, 0, or -1 if unknown
+        int8_t hasChildren;
+        bool labelValid;
+        std::string label;
+
+        /* Implicit treap over the visible rows */
+        int left, right, up;
+        int size;
+        uint32_t priority;
+    };
+
+    /// Add a node (without linking it into the visible rows)
+    int createNode(NodeId id, int parent, int indexInParent);
+    /// Request the children of a node from the model, if this was not done yet
+    void loadChildren(int index);
+    /// Return whether a node has (or may have) children
+    bool hasChildren(int index);
+    void expandNode(int index);
+    void collapseNode(int index);
+
+    /// Return the index of the node shown in a row
+    int nodeIndexAt(int row) const;
+    /// Return the row showing a (visible) node
+    int rowOfNode(int index) const;
+
+    int treapSize(int t) const { return t < 0 ? 0 : mNodes[t].size; }
+    void treapUpdate(int t);
+    int treapMerge(int a, int b);
+    void treapSplit(int t, int count, int &left, int &right);
+    /// Concatenate the given nodes (in order) into a new treap
+    int treapBuild(const std::vector<int> &indices);
+
+protected:
+    std::function<std::vector<NodeId>(NodeId)> mChildrenCallback;
+    std::function<bool(NodeId)> mHasChildrenCallback;
+    std::function<std::string(NodeId)> mLabelCallback;
+    std::function<void(NodeId)> mSelectionCallback;
+
+    NodeId mRootId;
+    /// All loaded nodes; index 0 is the hidden root
+    std::vector<Node> mNodes;
+    int mTreapRoot;
+    uint32_t mRandomState;
+    int mSelected;
+
+    int mRowHeight;
+    int mIndentation;
+    int mScrollOffset;
+};
+
+NAMESPACE_END(nanogui)
+
+#endif
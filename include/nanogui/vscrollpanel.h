@@ -28,17 +28,56 @@ class NANOGUI_EXPORT VScrollPanel : public Widget {
 public:
     VScrollPanel(Widget *parent);
 
+    /// Return the current scroll amount as a value between 0 and 1 (0: top, 1: bottom)
+    float scroll() const { return mScroll; }
+    /// Set the scroll amount to a value between 0 and 1 (0: top, 1: bottom)
+    void setScroll(float scroll);
+
+    /**
+     * \brief Request the child to be measured and laid out again before the next frame
+     *
+     * Scrolling only translates the child; its preferred size is cached. Call
+     * this function when the size of the scrolled content has changed.
+     */
+    void markContentDirty() { mUpdateLayout = true; }
+
+    /// Return whether mouse wheel scrolling is animated
+    bool smoothScrolling() const { return mSmoothScrolling; }
+    /// Set whether mouse wheel scrolling is animated
+    void setSmoothScrolling(bool smoothScrolling) { mSmoothScrolling = smoothScrolling; }
+
+    /// Return whether the content keeps moving (with friction) after a drag is released
+    bool kineticScrolling() const { return mKineticScrolling; }
+    /// Set whether the content keeps moving (with friction) after a drag is released
+    void setKineticScrolling(bool kineticScrolling) { mKineticScrolling = kineticScrolling; }
+
     virtual void performLayout(NVGcontext *ctx) override;
     virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
     virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
     virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
     virtual void draw(NVGcontext *ctx) override;
+    virtual bool needsRedraw() override;
     virtual void save(Serializer &s) const override;
     virtual bool load(Serializer &s) override;
+
+protected:
+    /// Advance smooth and kinetic scrolling to the current time
+    void animate();
+    /// Translate the child according to the current scroll amount
+    void updateChildPosition();
+
 protected:
     int mChildPreferredHeight;
     float mScroll;
+    float mScrollTarget;
+    float mVelocity;
+    double mLastAnimationTime;
+    double mLastDragTime;
     bool mUpdateLayout;
+    bool mSmoothScrolling;
+    bool mKineticScrolling;
+    bool mDragging;
 };
 
 NAMESPACE_END(nanogui)
@@ -14,6 +14,8 @@
 #define NG_WIDGET
 
 #include <nanogui/object.h>
+#include <nanogui/spatialindex.h>
+#include <memory>
 #include <vector>
 
 NAMESPACE_BEGIN(nanogui)
@@ -39,7 +41,7 @@ public:
     /// Return the parent widget
     const Widget *parent() const { return mParent; }
     /// Set the parent widget
-    void setParent(Widget *parent) { mParent = parent; }
+    void setParent(Widget *parent) { mParent = parent; invalidateGeometry(); }
 
     /// Return the used \ref Layout generator
     Layout *layout() { return mLayout; }
@@ -58,28 +60,59 @@ public:
     /// Return the position relative to the parent widget
     const Vector2i &position() const { return mPos; }
     /// Set the position relative to the parent widget
-    void setPosition(const Vector2i &pos) { mPos = pos; }
+    void setPosition(const Vector2i &pos) {
+        if (mPos == pos)
+            return;
+        mPos = pos;
+        invalidateGeometry();
+        if (mParent)
+            mParent->invalidateSpatialIndex();
+    }
 
-    /// Return the absolute position on screen
+    /// Return the absolute position on screen (cached until this widget or an ancestor is moved or resized)
     Vector2i absolutePosition() const {
-        return mParent ?
-            (parent()->absolutePosition() + mPos) : mPos;
+        updateGeometry();
+        return mAbsolutePos;
+    }
+
+    /**
+     * \brief Return the absolute position of the visible part of this widget
+     *
+     * Widgets are clipped against the rectangles of all their parents. The
+     * result is cached along with \ref absolutePosition().
+     */
+    Vector2i clipPosition() const {
+        updateGeometry();
+        return mClipPos;
+    }
+
+    /// Return the size of the visible part of this widget (zero when it is clipped away entirely)
+    Vector2i clipSize() const {
+        updateGeometry();
+        return mClipSize;
     }
 
     /// Return the size of the widget
     const Vector2i &size() const { return mSize; }
     /// set the size of the widget
-    void setSize(const Vector2i &size) { mSize = size; }
+    void setSize(const Vector2i &size) {
+        if (mSize == size)
+            return;
+        mSize = size;
+        invalidateGeometry();
+        if (mParent)
+            mParent->invalidateSpatialIndex();
+    }
 
     /// Return the width of the widget
     int width() const { return mSize.x(); }
     /// Set the width of the widget
-    void setWidth(int width) { mSize.x() = width; }
+    void setWidth(int width) { setSize(Vector2i(width, mSize.y())); }
 
     /// Return the height of the widget
     int height() const { return mSize.y(); }
     /// Set the height of the widget
-    void setHeight(int height) { mSize.y() = height; }
+    void setHeight(int height) { setSize(Vector2i(mSize.x(), height)); }
 
     /**
      * \brief Set the fixed size of this widget
@@ -163,6 +196,14 @@ public:
     /// Walk up the hierarchy and return the parent window
     Window *window();
 
+    /**
+     * \brief Render the cached layers of the windows containing this widget again
+     *
+     * For changes of the appearance that are not caused by an event the
+     * window invalidates its layer for anyway (see \ref Window).
+     */
+    void invalidateLayers();
+
     /// Associate this widget with an ID value (optional)
     void setId(const std::string &id) { mId = id; }
     /// Return the ID value associated with this widget, if any
@@ -204,6 +245,21 @@ public:
     /// Determine the widget located at the given position value (recursive)
     Widget *findWidget(const Vector2i &p);
 
+    /**
+     * \brief Accelerate hit testing among the children of this widget
+     *
+     * When enabled, \ref findWidget() and the default mouse and scroll event
+     * handlers only visit children looked up in a \ref SpatialIndex instead of
+     * scanning all children. The index is rebuilt lazily after children were
+     * added, removed, moved or resized (e.g. by a layout). This is worthwhile
+     * for containers with thousands of children such as image grids.
+     */
+    void setSpatialIndex(bool enabled);
+    /// Return whether hit testing among the children uses a \ref SpatialIndex
+    bool spatialIndex() const { return (bool) mSpatialIndex; }
+    /// Request a rebuild of the spatial index before its next use
+    void invalidateSpatialIndex() { mSpatialIndexDirty = true; }
+
     /// Handle a mouse button event (default implementation: propagate to children)
     virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers);
 
@@ -237,6 +293,15 @@ public:
     /// Draw the widget (and all child widgets)
     virtual void draw(NVGcontext *ctx);
 
+    /**
+     * \brief Return whether the widget changed by itself since it was last drawn
+     *
+     * Overridden by widgets that animate or show data produced by other
+     * threads. Windows caching their layer check their visible widgets before
+     * each frame, since these are not drawn while the layer is valid.
+     */
+    virtual bool needsRedraw() { return false; }
+
     /// Save the state of the widget into the given \ref Serializer instance
     virtual void save(Serializer &s) const;
 
@@ -247,7 +312,29 @@ protected:
     /// Free all resources used by the widget and any children
     virtual ~Widget();
 
+    /// Return the up-to-date spatial index over the children, or \c nullptr if disabled
+    const SpatialIndex *updateSpatialIndex();
+
+    /**
+     * \brief Draw a scroll bar in the style of \ref VScrollPanel
+     *
+     * The track is 8 pixels wide and \c length long, starting at (\c x, \c y).
+     * The thumb is \c thumb long and placed at the relative \c scroll
+     * position (in [0, 1]) along the track.
+     */
+    static void drawScrollBar(NVGcontext *ctx, float x, float y, float length,
+                              float thumb, float scroll, bool vertical);
+
+    /// Recompute the cached absolute position and clip rectangle if stale
+    void updateGeometry() const;
+
+    /// Invalidate the cached geometry of this widget and its descendants (call after assigning \c mPos or \c mSize directly)
+    void invalidateGeometry();
+
 protected:
+    /// Screen drawing the current frame, whose culling statistics \ref draw() updates
+    static Screen *sDrawingScreen;
+
     Widget *mParent;
     ref<Theme> mTheme;
     ref<Layout> mLayout;
@@ -259,6 +346,13 @@ protected:
     std::string mTooltip;
     int mFontSize;
     Cursor mCursor;
+    std::unique_ptr<SpatialIndex> mSpatialIndex;
+    bool mSpatialIndexDirty;
+
+    /* Cached absolute geometry. The descendants of a widget whose geometry
+       is dirty are dirty as well, so invalidation stops at dirty widgets */
+    mutable Vector2i mAbsolutePos, mClipPos, mClipSize;
+    mutable bool mGeometryDirty;
 };
 
 NAMESPACE_END(nanogui)
@@ -21,6 +21,17 @@ NAMESPACE_BEGIN(nanogui)
  * \class Window window.h nanogui/window.h
  *
  * \brief Top-level window widget.
+ *
+ * A window can cache its contents in an offscreen layer (see
+ * \ref setLayerCached()). The layer is rendered into a framebuffer before the
+ * frame, only when the window changed, and is otherwise drawn as a single
+ * textured quad; moving the window only moves the quad. Button and scroll
+ * events received by the window, the mouse entering or leaving any of its
+ * widgets and keyboard, focus and drag events of its widgets invalidate the
+ * layer, and so do widgets that change by themselves (see
+ * \ref Widget::invalidateLayers() and \ref Widget::needsRedraw()). Changes
+ * made by the application, such as setting a caption or adding a widget, must
+ * be followed by \ref invalidateLayer(). Popups are not cached.
  */
 class NANOGUI_EXPORT Window : public Widget {
     friend class Popup;
@@ -49,6 +60,16 @@ public:
     /// Center the window in the current \ref Screen
     void center();
 
+    /// Return whether the contents of the window are cached in an offscreen layer
+    bool layerCached() const { return mLayerCached; }
+    /// Set whether the contents of the window are cached in an offscreen layer
+    void setLayerCached(bool layerCached);
+    /// Render the cached layer again before the next frame
+    void invalidateLayer() { mLayerDirty = true; }
+
+    /// Render the layer if it is out of date (called by \ref Screen before each frame)
+    void renderLayer(NVGcontext *ctx);
+
     /// Draw the window
     virtual void draw(NVGcontext *ctx) override;
     /// Handle window drag events
@@ -59,19 +80,49 @@ public:
     virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
     /// Compute the preferred size of the widget
     virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    /// Invalidate the layer when the mouse enters or leaves the window
+    virtual bool mouseEnterEvent(const Vector2i &p, bool enter) override;
     /// Invoke the associated layout generator to properly place child widgets, if any
     virtual void performLayout(NVGcontext *ctx) override;
+    virtual void setTheme(Theme *theme) override;
     virtual void save(Serializer &s) const override;
     virtual bool load(Serializer &s) override;
 protected:
+    virtual ~Window();
+
     /// Internal helper function to maintain nested window position values; overridden in \ref Popup
     virtual void refreshRelativePlacement();
+    /// Return the screen showing the window (or \c nullptr)
+    Screen *screen();
+    /// Return whether the layer shows the current contents of the window
+    bool layerValid(const Screen *screen) const;
+    /// Release the framebuffer and the view of the layer
+    void releaseLayer();
 protected:
     std::string mTitle;
     Widget *mButtonPanel;
     bool mFullscreen;
     bool mModal;
     bool mDrag;
+
+    /* Layer cache */
+    bool mLayerCached;
+    bool mLayerDirty;
+    /// Set when the window was drawn with caching enabled, so that the next frame renders its layer
+    bool mLayerRequested;
+    /// Set while the contents are drawn into the layer
+    bool mLayerRendering;
+    NVGLUframebuffer *mLayer;
+    int mLayerViewId;
+    Screen *mLayerScreen;
+    /// Margin around the window covering its drop shadow
+    int mLayerMargin;
+    Vector2i mLayerFramebufferSize;
+    /// Size of the window and pixel ratio the layer was rendered with
+    Vector2i mLayerWindowSize;
+    float mLayerRatio;
+    /// Visible part of the window (relative to it) when the layer was rendered
+    Vector2i mLayerClipPosition, mLayerClipSize;
 };
 
 NAMESPACE_END(nanogui)
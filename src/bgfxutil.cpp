@@ -0,0 +1,306 @@
+/*
+    src/bgfxutil.cpp -- Convenience classes for rendering with bgfx
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/bgfxutil.h>
+#include <algorithm>
+
+NAMESPACE_BEGIN(nanogui)
+
+static const std::string indicesName = "indices";
+
+void BGFXShader::init(const std::string &name, bgfx::ProgramHandle program) {
+    free();
+    if (!bgfx::isValid(program))
+        throw std::runtime_error("BGFXShader::init(" + name + "): invalid program!");
+    mName = name;
+    mProgram = program;
+}
+
+void BGFXShader::init(const std::string &name, bgfx::ShaderHandle vertexShader,
+                      bgfx::ShaderHandle fragmentShader) {
+    init(name, bgfx::createProgram(vertexShader, fragmentShader, true));
+}
+
+void BGFXShader::free() {
+    for (auto &buf : mBuffers)
+        destroyBuffer(buf.second);
+    mBuffers.clear();
+    for (auto &uniform : mUniforms)
+        bgfx::destroyUniform(uniform.second);
+    mUniforms.clear();
+    if (bgfx::isValid(mProgram)) {
+        bgfx::destroyProgram(mProgram);
+        mProgram.idx = bgfx::invalidHandle;
+    }
+}
+
+void BGFXShader::destroyBuffer(Buffer &buffer) {
+    if (bgfx::isValid(buffer.vertexBuffer))
+        bgfx::destroyDynamicVertexBuffer(buffer.vertexBuffer);
+    if (bgfx::isValid(buffer.indexBuffer))
+        bgfx::destroyDynamicIndexBuffer(buffer.indexBuffer);
+    buffer.vertexBuffer.idx = bgfx::invalidHandle;
+    buffer.indexBuffer.idx = bgfx::invalidHandle;
+}
+
+bgfx::UniformHandle BGFXShader::uniform(const std::string &name, bgfx::UniformType::Enum type,
+                                        uint16_t num) {
+    auto it = mUniforms.find(name);
+    if (it != mUniforms.end())
+        return it->second;
+    bgfx::UniformHandle handle = bgfx::createUniform(name.c_str(), type, num);
+    if (!bgfx::isValid(handle))
+        throw std::runtime_error("BGFXShader::uniform(" + mName + ", " + name + "): could not create the uniform!");
+    mUniforms[name] = handle;
+    return handle;
+}
+
+void BGFXShader::uploadAttrib(const std::string &name, bgfx::Attrib::Enum attrib, uint32_t size,
+                              int dim, uint32_t compSize, bgfx::AttribType::Enum type,
+                              bool normalized, const void *data, int version) {
+    if (dim < 1 || dim > 4)
+        throw std::runtime_error("BGFXShader::uploadAttrib(" + mName + ", " + name + "): attributes have 1 to 4 components!");
+
+    auto it = mBuffers.find(name);
+    if (it != mBuffers.end()) {
+        Buffer &buffer = it->second;
+        bool compatible = bgfx::isValid(buffer.vertexBuffer) && buffer.dim == (uint32_t) dim &&
+                          buffer.compSize == compSize && buffer.type == type &&
+                          buffer.normalized == normalized && buffer.decl.has(attrib);
+        if (compatible && version != -1 && buffer.version == version && buffer.size == size)
+            return; /* The data on the GPU is up to date */
+        if (!compatible) {
+            destroyBuffer(buffer);
+            mBuffers.erase(it);
+            it = mBuffers.end();
+        }
+    }
+
+    if (it == mBuffers.end()) {
+        Buffer buffer;
+        buffer.decl.begin().add(attrib, (uint8_t) dim, type, normalized).end();
+        buffer.vertexBuffer = bgfx::createDynamicVertexBuffer(std::max(size, 1u), buffer.decl,
+                                                              BGFX_BUFFER_ALLOW_RESIZE);
+        buffer.indexBuffer.idx = bgfx::invalidHandle;
+        if (!bgfx::isValid(buffer.vertexBuffer))
+            throw std::runtime_error("BGFXShader::uploadAttrib(" + mName + ", " + name + "): could not create the buffer!");
+        buffer.dim = (uint32_t) dim;
+        buffer.compSize = compSize;
+        buffer.type = type;
+        buffer.normalized = normalized;
+        buffer.size = 0;
+        buffer.capacity = std::max(size, 1u);
+        it = mBuffers.insert(std::make_pair(name, buffer)).first;
+    }
+
+    Buffer &buffer = it->second;
+    if (size > 0)
+        bgfx::update(buffer.vertexBuffer, 0, bgfx::copy(data, size * buffer.dim * compSize));
+    buffer.size = size;
+    buffer.capacity = std::max(buffer.capacity, size);
+    buffer.version = version;
+}
+
+void BGFXShader::updateAttrib(const std::string &name, uint32_t first, uint32_t count, int dim,
+                              uint32_t compSize, const void *data, int version) {
+    auto it = mBuffers.find(name);
+    if (it == mBuffers.end() || !bgfx::isValid(it->second.vertexBuffer))
+        throw std::runtime_error("BGFXShader::updateAttrib(" + mName + ", " + name + "): attribute not found!");
+    Buffer &buffer = it->second;
+    if (buffer.dim != (uint32_t) dim || buffer.compSize != compSize)
+        throw std::runtime_error("BGFXShader::updateAttrib(" + mName + ", " + name + "): layout does not match the uploaded data!");
+    if (count > 0)
+        bgfx::update(buffer.vertexBuffer, first, bgfx::copy(data, count * buffer.dim * compSize));
+    buffer.size = std::max(buffer.size, first + count);
+    buffer.capacity = std::max(buffer.capacity, buffer.size);
+    buffer.version = version;
+}
+
+void BGFXShader::uploadIndices(uint32_t size, uint32_t compSize, const void *data, int version) {
+    if (compSize != 2 && compSize != 4)
+        throw std::runtime_error("BGFXShader::uploadIndices(" + mName + "): indices must be 16 or 32 bit!");
+
+    auto it = mBuffers.find(indicesName);
+    if (it != mBuffers.end()) {
+        Buffer &buffer = it->second;
+        bool compatible = bgfx::isValid(buffer.indexBuffer) && buffer.compSize == compSize;
+        if (compatible && version != -1 && buffer.version == version && buffer.size == size)
+            return; /* The data on the GPU is up to date */
+        if (!compatible) {
+            destroyBuffer(buffer);
+            mBuffers.erase(it);
+            it = mBuffers.end();
+        }
+    }
+
+    if (it == mBuffers.end()) {
+        Buffer buffer;
+        buffer.vertexBuffer.idx = bgfx::invalidHandle;
+        buffer.indexBuffer = bgfx::createDynamicIndexBuffer(
+            std::max(size, 1u), BGFX_BUFFER_ALLOW_RESIZE | (compSize == 4 ? BGFX_BUFFER_INDEX32 : 0));
+        if (!bgfx::isValid(buffer.indexBuffer))
+            throw std::runtime_error("BGFXShader::uploadIndices(" + mName + "): could not create the buffer!");
+        buffer.dim = 1;
+        buffer.compSize = compSize;
+        buffer.type = bgfx::AttribType::Count;
+        buffer.normalized = false;
+        buffer.size = 0;
+        buffer.capacity = std::max(size, 1u);
+        it = mBuffers.insert(std::make_pair(indicesName, buffer)).first;
+    }
+
+    Buffer &buffer = it->second;
+    if (size > 0)
+        bgfx::update(buffer.indexBuffer, 0, bgfx::copy(data, size * compSize));
+    buffer.size = size;
+    buffer.capacity = std::max(buffer.capacity, size);
+    buffer.version = version;
+}
+
+void BGFXShader::updateIndices(uint32_t first, uint32_t count, uint32_t compSize,
+                               const void *data, int version) {
+    auto it = mBuffers.find(indicesName);
+    if (it == mBuffers.end() || !bgfx::isValid(it->second.indexBuffer))
+        throw std::runtime_error("BGFXShader::updateIndices(" + mName + "): no indices were uploaded!");
+    Buffer &buffer = it->second;
+    if (buffer.compSize != compSize)
+        throw std::runtime_error("BGFXShader::updateIndices(" + mName + "): index size does not match the uploaded data!");
+    if (count > 0)
+        bgfx::update(buffer.indexBuffer, first, bgfx::copy(data, count * compSize));
+    buffer.size = std::max(buffer.size, first + count);
+    buffer.capacity = std::max(buffer.capacity, buffer.size);
+    buffer.version = version;
+}
+
+void BGFXShader::freeAttrib(const std::string &name) {
+    auto it = mBuffers.find(name);
+    if (it != mBuffers.end()) {
+        destroyBuffer(it->second);
+        mBuffers.erase(it);
+    }
+}
+
+void BGFXShader::invalidateAttribs() {
+    for (auto &buffer : mBuffers)
+        buffer.second.version = -1;
+}
+
+void BGFXShader::setUniform(const std::string &name, const Matrix4f &mat) {
+    bgfx::setUniform(uniform(name, bgfx::UniformType::Mat4), mat.data());
+}
+
+void BGFXShader::setUniform(const std::string &name, const Matrix3f &mat) {
+    bgfx::setUniform(uniform(name, bgfx::UniformType::Mat3), mat.data());
+}
+
+void BGFXShader::setUniform(const std::string &name, const Vector4f &v) {
+    bgfx::setUniform(uniform(name, bgfx::UniformType::Vec4), v.data());
+}
+
+void BGFXShader::setTexture(uint8_t stage, const std::string &name, bgfx::TextureHandle texture,
+                            uint32_t flags) {
+    bgfx::setTexture(stage, uniform(name, bgfx::UniformType::Int1), texture, flags);
+}
+
+void BGFXShader::bindBuffers(uint32_t first, uint32_t count) {
+    if (!bgfx::isValid(mProgram))
+        throw std::runtime_error("BGFXShader: the shader was not initialized!");
+    uint8_t stream = 0;
+    for (auto const &buf : mBuffers) {
+        const Buffer &buffer = buf.second;
+        if (!bgfx::isValid(buffer.vertexBuffer))
+            continue;
+        if (count == UINT32_MAX)
+            bgfx::setVertexBuffer(stream++, buffer.vertexBuffer, 0, buffer.size);
+        else if (first + count > buffer.size)
+            throw std::runtime_error("BGFXShader(" + mName + "): attribute \"" + buf.first + "\" is too short!");
+        else
+            bgfx::setVertexBuffer(stream++, buffer.vertexBuffer, first, count);
+    }
+}
+
+void BGFXShader::drawArray(uint8_t viewId, uint32_t offset, uint32_t count, uint64_t state) {
+    if (count == 0)
+        return;
+    bindBuffers(offset, count);
+    bgfx::setState(state);
+    bgfx::submit(viewId, mProgram);
+}
+
+void BGFXShader::drawIndexed(uint8_t viewId, uint32_t offset, uint32_t count, uint64_t state) {
+    if (count == 0)
+        return;
+    auto it = mBuffers.find(indicesName);
+    if (it == mBuffers.end() || !bgfx::isValid(it->second.indexBuffer))
+        throw std::runtime_error("BGFXShader::drawIndexed(" + mName + "): no indices were uploaded!");
+    if (offset + count > it->second.size)
+        throw std::runtime_error("BGFXShader::drawIndexed(" + mName + "): range out of bounds!");
+    bindBuffers(0, UINT32_MAX);
+    bgfx::setIndexBuffer(it->second.indexBuffer, offset, count);
+    bgfx::setState(state);
+    bgfx::submit(viewId, mProgram);
+}
+
+//  ----------------------------------------------------
+
+void BGFXFramebuffer::init(const Vector2i &size, int nSamples,
+                           bgfx::TextureFormat::Enum colorFormat) {
+    free();
+
+    uint32_t msaa;
+    switch (nSamples) {
+        case 1: msaa = 0; break;
+        case 2: msaa = BGFX_TEXTURE_RT_MSAA_X2; break;
+        case 4: msaa = BGFX_TEXTURE_RT_MSAA_X4; break;
+        case 8: msaa = BGFX_TEXTURE_RT_MSAA_X8; break;
+        case 16: msaa = BGFX_TEXTURE_RT_MSAA_X16; break;
+        default: throw std::runtime_error("BGFXFramebuffer::init(): unsupported number of samples!");
+    }
+
+    bgfx::TextureHandle textures[] = {
+        bgfx::createTexture2D((uint16_t) size.x(), (uint16_t) size.y(), false, 1, colorFormat,
+                              BGFX_TEXTURE_RT | msaa),
+        bgfx::createTexture2D((uint16_t) size.x(), (uint16_t) size.y(), false, 1,
+                              bgfx::TextureFormat::D24S8,
+                              BGFX_TEXTURE_RT | BGFX_TEXTURE_RT_WRITE_ONLY | msaa)
+    };
+    mFramebuffer = bgfx::createFrameBuffer(2, textures, true);
+    if (!bgfx::isValid(mFramebuffer)) {
+        for (auto texture : textures) {
+            if (bgfx::isValid(texture))
+                bgfx::destroyTexture(texture);
+        }
+        throw std::runtime_error("BGFXFramebuffer::init(): could not create the framebuffer!");
+    }
+    mSize = size;
+    mSamples = nSamples;
+}
+
+void BGFXFramebuffer::free() {
+    if (bgfx::isValid(mFramebuffer)) {
+        bgfx::destroyFrameBuffer(mFramebuffer);
+        mFramebuffer.idx = bgfx::invalidHandle;
+    }
+    mSize = Vector2i::Zero();
+    mSamples = 0;
+}
+
+void BGFXFramebuffer::bind(uint8_t viewId) {
+    bgfx::setViewFrameBuffer(viewId, mFramebuffer);
+    bgfx::setViewRect(viewId, 0, 0, (uint16_t) mSize.x(), (uint16_t) mSize.y());
+}
+
+void BGFXFramebuffer::release(uint8_t viewId) {
+    bgfx::FrameBufferHandle invalid = BGFX_INVALID_HANDLE;
+    bgfx::setViewFrameBuffer(viewId, invalid);
+}
+
+NAMESPACE_END(nanogui)
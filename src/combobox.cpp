@@ -11,32 +11,124 @@
 
 #include <nanogui/combobox.h>
 #include <nanogui/layout.h>
+#include <nanogui/listview.h>
+#include <nanogui/textbox.h>
+#include <nanogui/theme.h>
 #include <nanogui/serializer/core.h>
 #include <cassert>
 
 NAMESPACE_BEGIN(nanogui)
 
+/* Search field that reports every edit instead of only committed values */
+class ComboSearchBox : public TextBox {
+public:
+    ComboSearchBox(Widget *parent) : TextBox(parent, "") {
+        setEditable(true);
+        setAlignment(TextBox::Alignment::Left);
+        setDefaultValue("");
+    }
+
+    /// Focus the field and append a character typed elsewhere
+    void type(unsigned int codepoint) {
+        if (!focused())
+            requestFocus();
+        mCursorPos = (int) mValueTemp.size();
+        mSelectionPos = -1;
+        keyboardCharacterEvent(codepoint);
+    }
+
+    virtual bool keyboardEvent(int key, int scancode, int action, int modifiers) override {
+        if (key == NG_KEY_ENTER && action == NG_PRESS && focused() && mSubmitCallback) {
+            mSubmitCallback();
+            return true;
+        }
+        bool result = TextBox::keyboardEvent(key, scancode, action, modifiers);
+        notify();
+        return result;
+    }
+
+    virtual bool keyboardCharacterEvent(unsigned int codepoint) override {
+        bool result = TextBox::keyboardCharacterEvent(codepoint);
+        notify();
+        return result;
+    }
+
+    std::function<void(const std::string &)> mEditCallback;
+    std::function<void()> mSubmitCallback;
+
+protected:
+    void notify() {
+        if (focused() && mEditCallback)
+            mEditCallback(mValueTemp);
+    }
+};
+
 ComboBox::ComboBox(Widget *parent) : PopupButton(parent), mSelectedIndex(0) {
+    initializePopup();
 }
 
 ComboBox::ComboBox(Widget *parent, const std::vector<std::string> &items)
     : PopupButton(parent), mSelectedIndex(0) {
+    initializePopup();
     setItems(items);
 }
 
 ComboBox::ComboBox(Widget *parent, const std::vector<std::string> &items, const std::vector<std::string> &itemsShort)
     : PopupButton(parent), mSelectedIndex(0) {
+    initializePopup();
     setItems(items, itemsShort);
 }
 
+void ComboBox::initializePopup() {
+    mSearchable = false;
+    mPopupItemCount = 10;
+    mIndexDirty = true;
+
+    mPopup->setLayout(new GroupLayout(10));
+
+    ComboSearchBox *searchBox = new ComboSearchBox(mPopup);
+    searchBox->mEditCallback = [this](const std::string &query) {
+        if (query != mQuery)
+            setQuery(query);
+    };
+    searchBox->mSubmitCallback = [this] {
+        if (mList->rowCount() > 0)
+            selectItem(itemAt(0));
+    };
+    searchBox->setVisible(false);
+    mSearchBox = searchBox;
+
+    mList = new ListView(mPopup);
+    mList->setRowFactory([](ListView *list) -> Widget * {
+        Button *button = new Button(list, "");
+        button->setFlags(Button::RadioButton);
+        return button;
+    });
+    mList->setRowBinder([this](Widget *widget, int row) {
+        Button *button = (Button *) widget;
+        int index = itemAt(row);
+        button->setCaption(mItems[index]);
+        button->setPushed(index == mSelectedIndex);
+        button->setCallback([this, index] { selectItem(index); });
+    });
+}
+
 void ComboBox::setSelectedIndex(int idx) {
     if (mItemsShort.empty())
         return;
-    const std::vector<Widget *> &children = popup()->children();
-    ((Button *) children[mSelectedIndex])->setPushed(false);
-    ((Button *) children[idx])->setPushed(true);
     mSelectedIndex = idx;
     setCaption(mItemsShort[idx]);
+    mList->reloadData();
+}
+
+void ComboBox::selectItem(int index) {
+    mSelectedIndex = index;
+    setCaption(mItemsShort[index]);
+    setPushed(false);
+    popup()->setVisible(false);
+    mList->reloadData();
+    if (mCallback)
+        mCallback(index);
 }
 
 void ComboBox::setItems(const std::vector<std::string> &items, const std::vector<std::string> &itemsShort) {
@@ -45,26 +137,49 @@ void ComboBox::setItems(const std::vector<std::string> &items, const std::vector
     mItemsShort = itemsShort;
     if (mSelectedIndex < 0 || mSelectedIndex >= (int) items.size())
         mSelectedIndex = 0;
-    while (mPopup->childCount() != 0)
-        mPopup->removeChild(mPopup->childCount()-1);
-    mPopup->setLayout(new GroupLayout(10));
-    int index = 0;
-    for (const auto &str: items) {
-        Button *button = new Button(mPopup, str);
-        button->setFlags(Button::RadioButton);
-        button->setCallback([&, index] {
-            mSelectedIndex = index;
-            setCaption(mItemsShort[index]);
-            setPushed(false);
-            popup()->setVisible(false);
-            if (mCallback)
-                mCallback(index);
-        });
-        index++;
-    }
+
+    /* The search index is only built once a query needs it */
+    mIndex.clear();
+    mIndexDirty = true;
+    setQuery(mQuery);
     setSelectedIndex(mSelectedIndex);
 }
 
+void ComboBox::setSearchable(bool searchable) {
+    mSearchable = searchable;
+    mSearchBox->setVisible(searchable);
+    if (!searchable) {
+        mSearchBox->setValue("");
+        setQuery("");
+    }
+}
+
+void ComboBox::setQuery(const std::string &query) {
+    mQuery = query;
+    mFiltered.clear();
+    if (!mQuery.empty()) {
+        /* Short queries scan the items linearly and do not need the index */
+        if (mIndexDirty && mQuery.size() >= 3) {
+            mIndex.build(mItems);
+            mIndexDirty = false;
+        }
+        mIndex.find(mItems, mQuery, mFiltered);
+    }
+    mList->setRowCount(mQuery.empty() ? (int) mItems.size() : (int) mFiltered.size());
+    mList->setScrollOffset(0);
+}
+
+void ComboBox::performLayout(NVGcontext *ctx) {
+    /* Size the list before the popup (a later sibling of the parent window)
+       is laid out; its height does not change while filtering */
+    int rowHeight = mTheme->mButtonFontSize + 10;
+    int rows = std::max(1, std::min(mPopupItemCount, (int) mItems.size()));
+    mList->setRowHeight(rowHeight);
+    mList->setFixedSize(Vector2i(std::max(mSize.x(), 150), rows * rowHeight));
+    mSearchBox->setFixedWidth(std::max(mSize.x(), 150));
+    PopupButton::performLayout(ctx);
+}
+
 bool ComboBox::scrollEvent(const Vector2i &p, const Vector2f &rel) {
     if (rel.y() < 0) {
         setSelectedIndex(std::min(mSelectedIndex+1, (int)(items().size()-1)));
@@ -80,6 +195,15 @@ bool ComboBox::scrollEvent(const Vector2i &p, const Vector2f &rel) {
     return Widget::scrollEvent(p, rel);
 }
 
+bool ComboBox::keyboardCharacterEvent(unsigned int codepoint) {
+    /* Type-to-filter: forward characters to the search field of the open popup */
+    if (mSearchable && mPushed && mEnabled) {
+        ((ComboSearchBox *) mSearchBox)->type(codepoint);
+        return true;
+    }
+    return PopupButton::keyboardCharacterEvent(codepoint);
+}
+
 void ComboBox::save(Serializer &s) const {
     Widget::save(s);
     s.set("items", mItems);
@@ -92,6 +216,9 @@ bool ComboBox::load(Serializer &s) {
     if (!s.get("items", mItems)) return false;
     if (!s.get("itemsShort", mItemsShort)) return false;
     if (!s.get("selectedIndex", mSelectedIndex)) return false;
+    mIndex.clear();
+    mIndexDirty = true;
+    setQuery(mQuery);
     return true;
 }
 
@@ -247,11 +247,11 @@ public:
         }
 
         // Set the first texture
-        auto imageView = new ImageView(imageWindow, mImagesData[0].first.texture());
+        auto imageView = new ImageView(imageWindow, icons[0].first);
         mCurrentImage = 0;
         // Change the active textures.
-        imgPanel->setCallback([this, imageView, imgPanel](int i) {
-            imageView->bindImage(mImagesData[i].first.texture());
+        imgPanel->setCallback([this, imageView, imgPanel, icons](int i) {
+            imageView->bindImage(icons[i].first);
             mCurrentImage = i;
             cout << "Selected item " << i << '\n';
         });
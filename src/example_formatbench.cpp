@@ -0,0 +1,112 @@
+/*
+    src/example_formatbench.cpp -- benchmark of the TextBox format validation,
+    comparing a regular expression compiled per call (the former behavior)
+    with the hand-written validators of the IntBox/FloatBox formats and the
+    cached regular expressions used for other formats.
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/textbox.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace nanogui;
+
+/* Exposes the protected validation entry point of TextBox */
+class ValidatingTextBox : public TextBox {
+public:
+    ValidatingTextBox() : TextBox(nullptr) { }
+    using TextBox::checkFormat;
+};
+
+/* Random inputs: mostly well-formed numbers, with some noise characters */
+static std::vector<std::string> makeInputs(size_t count, std::mt19937 &rng) {
+    const char alphabet[] = "0123456789.-+eE";
+    std::uniform_int_distribution<int> length(1, 12), kind(0, 3),
+        digit(0, 9), noise(0, (int) sizeof(alphabet) - 2);
+    std::vector<std::string> inputs;
+    inputs.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string s;
+        int n = length(rng);
+        if (kind(rng) == 0) {
+            for (int j = 0; j < n; ++j)
+                s += alphabet[noise(rng)];
+        } else {
+            if (kind(rng) == 0)
+                s += '-';
+            for (int j = 0; j < n; ++j)
+                s += (char) ('0' + digit(rng));
+            if (kind(rng) == 0)
+                s += "." + std::to_string(digit(rng));
+            if (kind(rng) == 0)
+                s += "e-" + std::to_string(digit(rng));
+        }
+        inputs.push_back(s);
+    }
+    return inputs;
+}
+
+/* Run \c f on every input and return the average time per call in microseconds */
+template <typename Func>
+static double timePerCall(const std::vector<std::string> &inputs, size_t &matches, Func f) {
+    matches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &input : inputs)
+        matches += f(input) ? 1 : 0;
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / inputs.size();
+}
+
+int main(int argc, char **argv) {
+    size_t count = argc > 1 ? (size_t) std::stoul(argv[1]) : 100000;
+    std::mt19937 rng(1234);
+    std::vector<std::string> inputs = makeInputs(count, rng);
+
+    ref<ValidatingTextBox> textBox = new ValidatingTextBox();
+
+    struct Format { const char *name, *format; } formats[] = {
+        { "IntBox<int>", "[-]?[0-9]*" },
+        { "IntBox<unsigned>", "[0-9]*" },
+        { "FloatBox", "[-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?" },
+        { "custom", "[-]?[0-9]+(\\.[0-9]{1,2})?" }
+    };
+
+    printf("%zu inputs, average time per call\n\n", inputs.size());
+    printf("%-18s %16s %16s %10s\n", "format", "regex per call", "checkFormat", "agree");
+    bool allAgree = true;
+    for (const auto &format : formats) {
+        /* The former behavior is slow, hence it only runs on a subset */
+        std::vector<std::string> subset(inputs.begin(),
+            inputs.begin() + std::min(inputs.size(), (size_t) 10000));
+        size_t expected, matches;
+        double perCall = timePerCall(subset, expected, [&](const std::string &input) {
+            std::regex regex(format.format);
+            return std::regex_match(input, regex);
+        });
+        double cached = timePerCall(inputs, matches, [&](const std::string &input) {
+            return textBox->checkFormat(input, format.format);
+        });
+
+        /* Every input must be classified like std::regex_match does */
+        std::regex regex(format.format);
+        bool agree = true;
+        for (const auto &input : inputs)
+            agree &= std::regex_match(input, regex) == textBox->checkFormat(input, format.format);
+        allAgree &= agree;
+
+        printf("%-18s %13.3f us %13.3f us %10s\n", format.name, perCall, cached,
+               agree ? "yes" : "NO");
+    }
+    return allAgree ? 0 : 1;
+}
@@ -58,13 +58,22 @@ void GLCanvas::draw(NVGcontext *ctx) {
                                        screenSize[1] - positionInScreen[1] -
                                        (float) mSize[1]) * pixelRatio).cast<int>();
 
+    /* Only touch the part of the canvas that is not clipped by a parent */
+    Vector2i visiblePos = clipPosition(), visibleSize = clipSize();
+    if (visibleSize.x() == 0 || visibleSize.y() == 0)
+        return;
+    Vector2i scissorSize = (visibleSize.cast<float>() * pixelRatio).cast<int>(),
+             scissorPosition = (Vector2f(visiblePos[0],
+                                         screenSize[1] - visiblePos[1] -
+                                         (float) visibleSize[1]) * pixelRatio).cast<int>();
+
     GLint storedViewport[4];
     glGetIntegerv(GL_VIEWPORT, storedViewport);
 
     glViewport(imagePosition[0], imagePosition[1], size[0] , size[1]);
 
     glEnable(GL_SCISSOR_TEST);
-    glScissor(imagePosition[0], imagePosition[1], size[0], size[1]);
+    glScissor(scissorPosition[0], scissorPosition[1], scissorSize[0], scissorSize[1]);
     glClearColor(mBackgroundColor[0], mBackgroundColor[1],
                  mBackgroundColor[2], mBackgroundColor[3]);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
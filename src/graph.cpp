@@ -13,11 +13,16 @@
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
 #include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 NAMESPACE_BEGIN(nanogui)
 
 Graph::Graph(Widget *parent, const std::string &caption)
-    : Widget(parent), mCaption(caption) {
+    : Widget(parent), mCaption(caption), mValueCount(-1), mDecimation(true), mPyramidSize(0),
+      mPyramidDirty(true), mStreamCapacity(0), mStreamOverwrite(true),
+      mStreamHead(0), mStreamReserved(0), mStreamTail(0) {
     mBackgroundColor = Color(20, 128);
     mForegroundColor = Color(255, 192, 0, 128);
     mTextColor = Color(240, 192);
@@ -27,6 +32,176 @@ Vector2i Graph::preferredSize(NVGcontext *) const {
     return Vector2i(180, 45);
 }
 
+void Graph::appendValues(const float *values, size_t count) {
+    if (count == 0)
+        return;
+    /* The storage grows geometrically, so that appending is amortized O(count) */
+    Eigen::Index size = valueCount(), newSize = size + (Eigen::Index) count;
+    if (newSize > mValues.size())
+        mValues.conservativeResize(std::max(newSize, 2 * size));
+    std::copy(values, values + count, mValues.data() + size);
+    mValueCount = newSize;
+}
+
+void Graph::setStreamCapacity(size_t capacity, bool overwrite) {
+    mStream.reset(capacity > 0 ? new std::atomic<float>[capacity] : nullptr);
+    mStreamCapacity = capacity;
+    mStreamOverwrite = overwrite;
+    mStreamHead = mStreamReserved = mStreamTail = 0;
+    mStreamValues.clear();
+    mStreamValues.reserve(2 * capacity);
+    mPyramidDirty = true;
+}
+
+size_t Graph::append(const float *values, size_t count) {
+    if (!mStream)
+        throw std::runtime_error("Graph::append(): streaming mode is disabled!");
+
+    uint64_t head = mStreamHead.load(std::memory_order_relaxed),
+             tail = mStreamTail.load(std::memory_order_acquire);
+    size_t capacity = mStreamCapacity;
+
+    if (mStreamOverwrite) {
+        /* Announce the slots that are about to be overwritten, so that a
+           concurrent drainStream() can discard samples it may have torn */
+        mStreamReserved.store(head + count, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    } else {
+        count = std::min(count, capacity - (size_t) (head - tail));
+    }
+
+    /* Only the last 'capacity' samples can survive */
+    size_t skip = count > capacity ? count - capacity : 0;
+    for (size_t i = skip; i < count; ++i)
+        mStream[(head + i) % capacity].store(values[i], std::memory_order_relaxed);
+    mStreamHead.store(head + count, std::memory_order_release);
+
+    if (count > 0 && head == tail) {
+        std::function<void()> callback;
+        {
+            std::lock_guard<std::mutex> guard(mDataCallbackMutex);
+            callback = mDataCallback;
+        }
+        if (callback)
+            callback();
+    }
+    return count;
+}
+
+void Graph::setDataCallback(const std::function<void()> &callback) {
+    std::lock_guard<std::mutex> guard(mDataCallbackMutex);
+    mDataCallback = callback;
+}
+
+void Graph::drainStream() {
+    uint64_t head = mStreamHead.load(std::memory_order_acquire),
+             tail = mStreamTail.load(std::memory_order_relaxed);
+    if (head == tail)
+        return;
+    size_t capacity = mStreamCapacity;
+    if (head - tail > capacity)
+        tail = head - capacity;
+
+    size_t offset = mStreamValues.size(), count = (size_t) (head - tail);
+    mStreamValues.resize(offset + count);
+    for (size_t i = 0; i < count; ++i)
+        mStreamValues[offset + i] =
+            mStream[(tail + i) % capacity].load(std::memory_order_relaxed);
+
+    if (mStreamOverwrite) {
+        /* Drop samples whose slots the producer has started overwriting */
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t reserved = mStreamReserved.load(std::memory_order_relaxed);
+        if (reserved > tail + capacity) {
+            size_t torn = (size_t) std::min<uint64_t>(reserved - capacity - tail, count);
+            mStreamValues.erase(mStreamValues.begin() + offset,
+                                mStreamValues.begin() + offset + torn);
+        }
+    }
+    mStreamTail.store(head, std::memory_order_release);
+
+    /* Discard samples that scrolled out of the plotted window in batches,
+       which keeps the pyramid updates incremental most of the time */
+    if (mStreamValues.size() >= 2 * capacity) {
+        mStreamValues.erase(mStreamValues.begin(),
+                            mStreamValues.end() - capacity);
+        mPyramidDirty = true;
+    }
+}
+
+void Graph::updatePyramid(const float *data, size_t n) {
+    if (mPyramidDirty) {
+        mPyramidMin.clear();
+        mPyramidMax.clear();
+        mPyramidSize = 0;
+        mPyramidDirty = false;
+    }
+    if (mPyramidSize == n)
+        return;
+
+    /* Only recompute the entries that cover new samples */
+    size_t first = mPyramidSize, count = n, level = 0;
+    while (count > 1) {
+        size_t parentCount = (count + 1) / 2;
+        first /= 2;
+        if (mPyramidMin.size() <= level) {
+            mPyramidMin.emplace_back();
+            mPyramidMax.emplace_back();
+        }
+        std::vector<float> &pmin = mPyramidMin[level], &pmax = mPyramidMax[level];
+        pmin.resize(parentCount);
+        pmax.resize(parentCount);
+
+        for (size_t j = first; j < parentCount; ++j) {
+            size_t c0 = 2 * j, c1 = std::min(2 * j + 1, count - 1);
+            if (level == 0) {
+                float v0 = data[c0], v1 = data[c1];
+                pmin[j] = std::min(v0, v1);
+                pmax[j] = std::max(v0, v1);
+            } else {
+                const std::vector<float> &cmin = mPyramidMin[level - 1],
+                                         &cmax = mPyramidMax[level - 1];
+                pmin[j] = std::min(cmin[c0], cmin[c1]);
+                pmax[j] = std::max(cmax[c0], cmax[c1]);
+            }
+        }
+        count = parentCount;
+        level++;
+    }
+    mPyramidSize = n;
+}
+
+void Graph::valueRange(const float *data, size_t begin, size_t end,
+                       float &min, float &max) const {
+    min = std::numeric_limits<float>::infinity();
+    max = -std::numeric_limits<float>::infinity();
+    while (begin < end) {
+        /* Largest aligned block starting at 'begin' that fits into the range */
+        size_t level = 0;
+        while (level < mPyramidMin.size() &&
+               (begin & ((size_t(2) << level) - 1)) == 0 &&
+               begin + (size_t(2) << level) <= end)
+            level++;
+
+        if (level == 0) {
+            float value = data[begin];
+            min = std::min(min, value);
+            max = std::max(max, value);
+            begin++;
+        } else {
+            size_t index = begin >> level;
+            min = std::min(min, mPyramidMin[level - 1][index]);
+            max = std::max(max, mPyramidMax[level - 1][index]);
+            begin += size_t(1) << level;
+        }
+    }
+}
+
+bool Graph::needsRedraw() {
+    return mStream && mStreamHead.load(std::memory_order_relaxed) !=
+                      mStreamTail.load(std::memory_order_relaxed);
+}
+
 void Graph::draw(NVGcontext *ctx) {
     Widget::draw(ctx);
 
@@ -35,16 +210,57 @@ void Graph::draw(NVGcontext *ctx) {
     nvgFillColor(ctx, mBackgroundColor);
     nvgFill(ctx);
 
-    if (mValues.size() < 2)
+    const float *data = mValues.data();
+    size_t n = (size_t) valueCount(), offset = 0;
+    if (mStream) {
+        drainStream();
+        data = mStreamValues.data();
+        n = mStreamValues.size();
+        offset = n > mStreamCapacity ? n - mStreamCapacity : 0;
+    }
+
+    if (n - offset < 2)
         return;
 
+    size_t count = n - offset;
+    int columns = mSize.x();
+
     nvgBeginPath(ctx);
     nvgMoveTo(ctx, mPos.x(), mPos.y()+mSize.y());
-    for (size_t i = 0; i < (size_t) mValues.size(); i++) {
-        float value = mValues[i];
-        float vx = mPos.x() + i * mSize.x() / (float) (mValues.size() - 1);
-        float vy = mPos.y() + (1-value) * mSize.y();
-        nvgLineTo(ctx, vx, vy);
+    if (mDecimation && columns > 0 && count > 4 * (size_t) (columns + 1)) {
+        /* M4 aggregation: first, min, max and last value per pixel column */
+        updatePyramid(data, n);
+        double samplesPerColumn = (count - 1) / (double) columns;
+        size_t begin = offset;
+        for (int c = 0; c <= columns && begin < n; ++c) {
+            size_t end = c == columns ? n : std::min(n, offset +
+                (size_t) std::ceil((c + 1) * samplesPerColumn));
+            if (end <= begin)
+                continue;
+
+            float first = data[begin], last = data[end - 1], vmin, vmax;
+            valueRange(data, begin, end, vmin, vmax);
+
+            float vx = (float) (mPos.x() + c);
+            nvgLineTo(ctx, vx, mPos.y() + (1-first) * mSize.y());
+            /* Visit the extremum further away from the last value first */
+            if (std::abs(last - vmin) < std::abs(last - vmax)) {
+                nvgLineTo(ctx, vx, mPos.y() + (1-vmax) * mSize.y());
+                nvgLineTo(ctx, vx, mPos.y() + (1-vmin) * mSize.y());
+            } else {
+                nvgLineTo(ctx, vx, mPos.y() + (1-vmin) * mSize.y());
+                nvgLineTo(ctx, vx, mPos.y() + (1-vmax) * mSize.y());
+            }
+            nvgLineTo(ctx, vx, mPos.y() + (1-last) * mSize.y());
+            begin = end;
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            float value = data[offset + i];
+            float vx = mPos.x() + i * mSize.x() / (float) (count - 1);
+            float vy = mPos.y() + (1-value) * mSize.y();
+            nvgLineTo(ctx, vx, vy);
+        }
     }
 
     nvgLineTo(ctx, mPos.x() + mSize.x(), mPos.y() + mSize.y());
@@ -90,7 +306,7 @@ void Graph::save(Serializer &s) const {
     s.set("backgroundColor", mBackgroundColor);
     s.set("foregroundColor", mForegroundColor);
     s.set("textColor", mTextColor);
-    s.set("values", mValues);
+    s.set("values", VectorXf(values()));
 }
 
 bool Graph::load(Serializer &s) {
@@ -102,6 +318,8 @@ bool Graph::load(Serializer &s) {
     if (!s.get("foregroundColor", mForegroundColor)) return false;
     if (!s.get("textColor", mTextColor)) return false;
     if (!s.get("values", mValues)) return false;
+    mValueCount = -1;
+    mPyramidDirty = true;
     return true;
 }
 
@@ -0,0 +1,172 @@
+/*
+    src/imageloader.cpp -- Decodes images on worker threads and uploads
+    them in the background
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/imageloader.h>
+#include <nanogui/opengl.h>
+#include "nanovg_bgfx.h"
+#include <algorithm>
+
+NAMESPACE_BEGIN(nanogui)
+
+ImageLoader::ImageLoader(NVGcontext *ctx, int threadCount)
+    : mContext(ctx), mUploadBudget(8 * 1024 * 1024), mReloadable(false), mNextTicket(0),
+      mThreadCount(threadCount), mStop(false) {
+    if (mThreadCount <= 0)
+        mThreadCount = std::max(1, (int) std::thread::hardware_concurrency() - 1);
+}
+
+ImageLoader::~ImageLoader() {
+    for (auto &item : mNames) {
+        if (mReady.count(item.first) != 0)
+            nvgSetImageReloadable(mContext, item.first, nullptr, nullptr);
+    }
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+    for (auto &thread : mThreads)
+        thread.join();
+}
+
+void ImageLoader::setDecoder(const Decoder &decoder) {
+    std::lock_guard<std::mutex> guard(mMutex);
+    mDecoder = decoder;
+}
+
+void ImageLoader::setDataCallback(const std::function<void()> &callback) {
+    std::lock_guard<std::mutex> guard(mMutex);
+    mDataCallback = callback;
+}
+
+int ImageLoader::load(const std::string &name, int imageFlags) {
+    if (!mDecoder)
+        throw std::runtime_error("ImageLoader::load(): no decoder was set!");
+
+    const uint8_t placeholder[4] = { 128, 128, 128, 64 };
+    int image = nvgCreateImageRGBA(mContext, 1, 1, imageFlags, placeholder);
+    if (image == 0)
+        throw std::runtime_error("ImageLoader::load(): could not create an image!");
+
+    mNames[image] = name;
+    mReady.erase(image);
+    enqueue(image);
+    return image;
+}
+
+void ImageLoader::enqueue(int image) {
+    uint64_t ticket = ++mNextTicket;
+    mPending[image] = ticket;
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mJobs.push_back(Job{ image, ticket, mNames[image] });
+        if (mThreads.empty()) {
+            for (int i = 0; i < mThreadCount; ++i)
+                mThreads.emplace_back([this] { workerThread(); });
+        }
+    }
+    mCondition.notify_one();
+}
+
+void ImageLoader::reloadImage(void *loader, int image) {
+    ImageLoader *self = (ImageLoader *) loader;
+    if (self->mNames.count(image) != 0 && self->mPending.count(image) == 0)
+        self->enqueue(image);
+}
+
+void ImageLoader::cancel(int image) {
+    if (mNames.erase(image) != 0 && mReady.count(image) != 0)
+        nvgSetImageReloadable(mContext, image, nullptr, nullptr);
+    mReady.erase(image);
+
+    auto it = mPending.find(image);
+    if (it == mPending.end())
+        return;
+    uint64_t ticket = it->second;
+    mPending.erase(it);
+
+    /* A job that is being decoded is discarded by update() */
+    std::lock_guard<std::mutex> guard(mMutex);
+    mJobs.erase(std::remove_if(mJobs.begin(), mJobs.end(),
+        [ticket](const Job &job) { return job.ticket == ticket; }), mJobs.end());
+}
+
+bool ImageLoader::update() {
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        size_t bytes = 0;
+        while (!mResults.empty() && (results.empty() || bytes + mResults.front().pixels.size() <= mUploadBudget)) {
+            bytes += mResults.front().pixels.size();
+            results.push_back(std::move(mResults.front()));
+            mResults.pop_front();
+        }
+    }
+
+    bool uploaded = false;
+    for (auto &result : results) {
+        auto it = mPending.find(result.image);
+        if (it == mPending.end() || it->second != result.ticket)
+            continue; /* Cancelled */
+
+        /* Still pending while filled, so that an evicted image is not queued again */
+        bool success = result.success &&
+            nvgReplaceImageRGBA(mContext, result.image, result.size.x(),
+                                result.size.y(), result.pixels.data()) != 0;
+        mPending.erase(result.image);
+        if (success) {
+            uploaded = true;
+            mReady.insert(result.image);
+            if (mReloadable)
+                nvgSetImageReloadable(mContext, result.image, &ImageLoader::reloadImage, this);
+        }
+        if (mCallback)
+            mCallback(result.image, success);
+    }
+    return uploaded;
+}
+
+void ImageLoader::workerThread() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mCondition.wait(lock, [this] { return mStop || !mJobs.empty(); });
+        if (mStop)
+            return;
+        Job job = std::move(mJobs.front());
+        mJobs.pop_front();
+        Decoder decoder = mDecoder;
+        lock.unlock();
+
+        Result result { job.image, job.ticket, false, Vector2i::Zero(), { } };
+        try {
+            result.success = decoder(job.name, result.size, result.pixels) &&
+                result.size.x() > 0 && result.size.y() > 0 &&
+                result.pixels.size() == (size_t) result.size.x() * (size_t) result.size.y() * 4;
+        } catch (const std::exception &) {
+            result.success = false;
+        }
+        if (!result.success)
+            result.pixels.clear();
+
+        lock.lock();
+        mResults.push_back(std::move(result));
+        bool notify = mResults.size() == 1;
+        std::function<void()> callback = mDataCallback;
+        lock.unlock();
+        /* Wake up the UI thread once per batch of results */
+        if (notify && callback)
+            callback();
+        lock.lock();
+    }
+}
+
+NAMESPACE_END(nanogui)
@@ -11,19 +11,252 @@
 */
 
 #include <nanogui/imagepanel.h>
+#include <nanogui/screen.h>
 #include <nanogui/opengl.h>
+#include <algorithm>
+#include <cmath>
 
 NAMESPACE_BEGIN(nanogui)
 
+namespace {
+    /// Extent of the drop shadow around each icon
+    const int ShadowSize = 5;
+    /// Samples averaged per axis for each thumbnail pixel
+    const int MaxSamples = 4;
+
+    /// Signed distance to a rounded rectangle, as computed by the NanoVG shaders
+    float sdRoundRect(const Vector2f &p, const Vector2f &center, float halfSize, float radius) {
+        Vector2f d = (p - center).cwiseAbs() - Vector2f::Constant(halfSize - radius);
+        return std::min(std::max(d.x(), d.y()), 0.0f) + d.cwiseMax(0.0f).norm() - radius;
+    }
+
+    /**
+     * Downscale the centered square of an image into premultiplied thumbnail
+     * pixels (box filter), clipped to the rounded corners of the icon
+     */
+    bool downscaleThumbnail(const Vector2i &size, const std::vector<uint8_t> &pixels,
+                            int thumbSize, int thumbPixels, float ratio,
+                            std::vector<uint8_t> &out) {
+        if (size.x() <= 0 || size.y() <= 0 || pixels.size() < (size_t) size.prod() * 4)
+            return false;
+        int crop = size.minCoeff();
+        Vector2i offset = (size - Vector2i::Constant(crop)) / 2;
+        Vector2f center = Vector2f::Constant(thumbSize * 0.5f);
+        out.resize((size_t) thumbPixels * thumbPixels * 4);
+        uint8_t *dst = out.data();
+
+        for (int y = 0; y < thumbPixels; ++y) {
+            int y0 = offset.y() + (int) ((int64_t) y * crop / thumbPixels),
+                y1 = std::max(y0 + 1, offset.y() + (int) ((int64_t) (y + 1) * crop / thumbPixels)),
+                ystep = std::max(1, (y1 - y0) / MaxSamples);
+            for (int x = 0; x < thumbPixels; ++x, dst += 4) {
+                int x0 = offset.x() + (int) ((int64_t) x * crop / thumbPixels),
+                    x1 = std::max(x0 + 1, offset.x() + (int) ((int64_t) (x + 1) * crop / thumbPixels)),
+                    xstep = std::max(1, (x1 - x0) / MaxSamples);
+                float sum[4] = { 0.f, 0.f, 0.f, 0.f };
+                int count = 0;
+                for (int sy = y0; sy < y1; sy += ystep) {
+                    const uint8_t *src = &pixels[((size_t) sy * size.x() + x0) * 4];
+                    for (int sx = x0; sx < x1; sx += xstep, src += xstep * 4) {
+                        float alpha = src[3] * (1.f / 255.f);
+                        sum[0] += src[0] * alpha;
+                        sum[1] += src[1] * alpha;
+                        sum[2] += src[2] * alpha;
+                        sum[3] += src[3];
+                        ++count;
+                    }
+                }
+
+                Vector2f p = Vector2f(x + 0.5f, y + 0.5f) / ratio;
+                float coverage = std::min(std::max(
+                    0.5f - sdRoundRect(p, center, thumbSize * 0.5f, 5.f) * ratio, 0.f), 1.f);
+                for (int c = 0; c < 4; ++c)
+                    dst[c] = (uint8_t) (sum[c] / count * coverage + 0.5f);
+            }
+        }
+        return true;
+    }
+
+    /* Skyline bin packer, following the glyph atlas of fontstash. Each node
+       is an (x, y, width) segment of the skyline. */
+
+    int skylineRectFits(const std::vector<Vector3i> &nodes, int pageSize,
+                        int i, int w, int h) {
+        int x = nodes[i].x(), y = nodes[i].y();
+        if (x + w > pageSize)
+            return -1;
+        for (int spaceLeft = w; spaceLeft > 0; ++i) {
+            if (i == (int) nodes.size())
+                return -1;
+            y = std::max(y, nodes[i].y());
+            if (y + h > pageSize)
+                return -1;
+            spaceLeft -= nodes[i].z();
+        }
+        return y;
+    }
+
+    void skylineAddLevel(std::vector<Vector3i> &nodes, int idx, int x, int y,
+                         int w, int h) {
+        nodes.insert(nodes.begin() + idx, Vector3i(x, y + h, w));
+
+        /* Shrink or remove the nodes now covered by the new one */
+        for (int i = idx + 1; i < (int) nodes.size(); ++i) {
+            int prevEnd = nodes[i - 1].x() + nodes[i - 1].z();
+            if (nodes[i].x() >= prevEnd)
+                break;
+            int shrink = prevEnd - nodes[i].x();
+            nodes[i].x() += shrink;
+            nodes[i].z() -= shrink;
+            if (nodes[i].z() > 0)
+                break;
+            nodes.erase(nodes.begin() + i);
+            --i;
+        }
+
+        /* Merge neighboring nodes at the same height */
+        for (int i = 0; i < (int) nodes.size() - 1; ++i) {
+            if (nodes[i].y() == nodes[i + 1].y()) {
+                nodes[i].z() += nodes[i + 1].z();
+                nodes.erase(nodes.begin() + i + 1);
+                --i;
+            }
+        }
+    }
+
+    bool skylineAddRect(std::vector<Vector3i> &nodes, int pageSize, int w, int h,
+                        Vector2i &pos) {
+        int bestw = pageSize, besth = pageSize, besti = -1, bestx = -1, besty = -1;
+
+        /* Bottom left fit heuristic */
+        for (int i = 0; i < (int) nodes.size(); ++i) {
+            int y = skylineRectFits(nodes, pageSize, i, w, h);
+            if (y != -1 && (y + h < besth || (y + h == besth && nodes[i].z() < bestw))) {
+                besti = i;
+                bestw = nodes[i].z();
+                besth = y + h;
+                bestx = nodes[i].x();
+                besty = y;
+            }
+        }
+        if (besti == -1)
+            return false;
+
+        skylineAddLevel(nodes, besti, bestx, besty, w, h);
+        pos = Vector2i(bestx, besty);
+        return true;
+    }
+}
+
 ImagePanel::ImagePanel(Widget *parent)
     : Widget(parent), mThumbSize(64), mSpacing(10), mMargin(10),
-      mMouseIndex(-1) {}
+      mMouseIndex(-1), mAtlasPageSize(1024), mAtlasPageLimit(4),
+      mThumbnailsPerFrame(8), mThumbnailsPending(false), mDecorationImage(0),
+      mAtlasRatio(0.f), mFrame(0), mContext(nullptr), mImageCount(-1),
+      mGeneration(0), mThreadCount(1), mStop(false) {}
+
+ImagePanel::~ImagePanel() {
+    stopWorkers();
+    releaseAtlas();
+}
+
+void ImagePanel::setImages(const Images &data) {
+    stopWorkers();
+    mImages = data;
+    mImageCount = -1;
+    clearAtlas();
+}
+
+void ImagePanel::setThumbnailSource(const ThumbnailSource &source) {
+    stopWorkers();
+    mThumbnailSource = source;
+    clearAtlas();
+}
+
+void ImagePanel::setDataSource(int count, const ThumbnailSource &source, int threadCount) {
+    stopWorkers();
+    mImages.clear();
+    mImageCount = std::max(0, count);
+    mThumbnailSource = source;
+    mThreadCount = threadCount > 0 ? threadCount :
+        std::max(1, (int) std::thread::hardware_concurrency() - 1);
+    clearAtlas();
+}
+
+void ImagePanel::setDataCallback(const std::function<void()> &callback) {
+    std::lock_guard<std::mutex> guard(mMutex);
+    mDataCallback = callback;
+}
+
+void ImagePanel::setAtlasPageSize(int atlasPageSize) {
+    if (atlasPageSize == mAtlasPageSize)
+        return;
+    mAtlasPageSize = atlasPageSize;
+    clearAtlas();
+}
+
+void ImagePanel::updateThumbnail(int index) {
+    /* The old thumbnail stays in its page until the page is cleared */
+    mThumbnails.erase(index);
+}
+
+void ImagePanel::retryFailedThumbnails() {
+    for (auto it = mThumbnails.begin(); it != mThumbnails.end(); ) {
+        if (it->second.page < 0)
+            it = mThumbnails.erase(it);
+        else
+            ++it;
+    }
+}
+
+void ImagePanel::clearAtlas() {
+    releaseAtlas();
+    mThumbnails.clear();
+
+    /* Requests being served are discarded by collectResults() */
+    ++mGeneration;
+    mRequested.clear();
+    std::lock_guard<std::mutex> guard(mMutex);
+    mRequests.clear();
+    mResults.clear();
+}
+
+void ImagePanel::releaseAtlas() {
+    if (mContext) {
+        for (auto &page : mPages)
+            nvgDeleteImage(mContext, page.image);
+        if (mDecorationImage)
+            nvgDeleteImage(mContext, mDecorationImage);
+    }
+    mPages.clear();
+    mDecorationImage = 0;
+}
+
+void ImagePanel::releasePage(int page) {
+    for (auto it = mThumbnails.begin(); it != mThumbnails.end(); ) {
+        if (it->second.page == page)
+            it = mThumbnails.erase(it);
+        else
+            ++it;
+    }
+    nvgDeleteImage(mContext, mPages[page].image);
+
+    /* Move the last page into the free slot */
+    int last = (int) mPages.size() - 1;
+    if (page != last) {
+        mPages[page] = std::move(mPages[last]);
+        for (auto &item : mThumbnails)
+            if (item.second.page == last)
+                item.second.page = page;
+    }
+    mPages.pop_back();
+}
 
 Vector2i ImagePanel::gridSize() const {
     int nCols = 1 + std::max(0,
         (int) ((mSize.x() - 2 * mMargin - mThumbSize) /
         (float) (mThumbSize + mSpacing)));
-    int nRows = ((int) mImages.size() + nCols - 1) / nCols;
+    int nRows = (imageCount() + nCols - 1) / nCols;
     return Vector2i(nCols, nRows);
 }
 
@@ -36,15 +269,28 @@ int ImagePanel::indexForPosition(const Vector2i &p) const {
     Vector2i gridPos = pp.cast<int>(), grid = gridSize();
     overImage &= ((gridPos.array() >= 0).all() &&
                  (gridPos.array() < grid.array()).all());
-    return overImage ? (gridPos.x() + gridPos.y() * grid.x()) : -1;
+    int index = gridPos.x() + gridPos.y() * grid.x();
+    return overImage && index < imageCount() ? index : -1;
 }
 
 bool ImagePanel::mouseMotionEvent(const Vector2i &p, const Vector2i & /* rel */,
                               int /* button */, int /* modifiers */) {
-    mMouseIndex = indexForPosition(p);
+    int index = indexForPosition(p);
+    if (index != mMouseIndex) {
+        mMouseIndex = index;
+        invalidateLayers();
+    }
     return true;
 }
 
+bool ImagePanel::needsRedraw() {
+    /* In data-source mode, pending thumbnails are waited for */
+    if (!dataSourceMode())
+        return mThumbnailsPending;
+    std::lock_guard<std::mutex> guard(mMutex);
+    return !mResults.empty();
+}
+
 bool ImagePanel::mouseButtonEvent(const Vector2i &p, int /* button */, bool down,
                                   int /* modifiers */) {
     int index = indexForPosition(p);
@@ -62,6 +308,13 @@ Vector2i ImagePanel::preferredSize(NVGcontext *) const {
 }
 
 void ImagePanel::draw(NVGcontext* ctx) {
+    if (mThumbnailSource)
+        drawAtlas(ctx);
+    else
+        drawImages(ctx);
+}
+
+void ImagePanel::drawImages(NVGcontext* ctx) {
     Vector2i grid = gridSize();
 
     for (size_t i=0; i<mImages.size(); ++i) {
@@ -110,4 +363,378 @@ void ImagePanel::draw(NVGcontext* ctx) {
     }
 }
 
+void ImagePanel::drawAtlas(NVGcontext* ctx) {
+    mContext = ctx;
+    mThumbnailsPending = false;
+
+    /* Thumbnails are generated at the resolution of the framebuffer */
+    const Widget *root = this;
+    while (root->parent())
+        root = root->parent();
+    const Screen *screen = dynamic_cast<const Screen *>(root);
+    float ratio = screen ? screen->pixelRatio() : 1.f;
+    if (ratio != mAtlasRatio) {
+        clearAtlas();
+        mAtlasRatio = ratio;
+    }
+    if (!mDecorationImage)
+        createDecoration(ctx);
+
+    Vector2i clipSize = this->clipSize();
+    if (clipSize.x() == 0 || clipSize.y() == 0 || imageCount() == 0) {
+        if (dataSourceMode())
+            requestThumbnails(std::vector<int>());
+        return;
+    }
+    ++mFrame;
+
+    /* Range of grid cells whose icon or shadow is visible */
+    Vector2i grid = gridSize();
+    int stride = mThumbSize + mSpacing;
+    Vector2i clipMin = clipPosition() - absolutePosition() -
+                       Vector2i::Constant(mMargin + mThumbSize + ShadowSize),
+             clipMax = clipMin + clipSize +
+                       Vector2i::Constant(mThumbSize + 2 * ShadowSize);
+    Vector2i cellMin = ((clipMin.array() + stride).max(0) / stride).matrix(),
+             cellMax = (clipMax.array() / stride + 1).min(grid.array()).matrix();
+
+    /* Failed thumbnails are only remembered while visible, and retried when they show up again */
+    for (auto it = mThumbnails.begin(); it != mThumbnails.end(); ) {
+        Vector2i cell(it->first % grid.x(), it->first / grid.x());
+        if (it->second.page < 0 && ((cell.array() < cellMin.array()).any() ||
+                                    (cell.array() >= cellMax.array()).any()))
+            it = mThumbnails.erase(it);
+        else
+            ++it;
+    }
+
+    std::vector<std::pair<int, Thumbnail>> visible;
+    std::vector<int> missing;
+    int budget = mThumbnailsPerFrame;
+    for (int y = cellMin.y(); y < cellMax.y(); ++y) {
+        for (int x = cellMin.x(); x < cellMax.x(); ++x) {
+            int index = x + y * grid.x();
+            if (index >= imageCount())
+                break;
+            const Thumbnail *thumb = thumbnail(ctx, index, budget);
+            Thumbnail entry = { -1, Vector2i::Zero() };
+            visible.push_back(std::make_pair(index, thumb ? *thumb : entry));
+            if (!thumb && dataSourceMode())
+                missing.push_back(index);
+        }
+    }
+
+    if (dataSourceMode()) {
+        /* Collected after the lookups above so that the pages of the
+           visible thumbnails are not cleared to make room */
+        collectResults(ctx, cellMin, cellMax);
+        for (auto &v : visible) {
+            auto it = v.second.page < 0 ? mThumbnails.find(v.first) : mThumbnails.end();
+            if (it != mThumbnails.end())
+                v.second = it->second;
+        }
+        missing.erase(std::remove_if(missing.begin(), missing.end(),
+            [this](int index) { return mThumbnails.count(index) != 0; }), missing.end());
+        requestThumbnails(missing);
+        mThumbnailsPending = !missing.empty();
+    }
+
+    /* Upload the regions of the pages written by this frame */
+    for (auto &page : mPages) {
+        if ((page.dirtyMin.array() > page.dirtyMax.array()).any())
+            continue;
+        nvgUpdateImageRegion(ctx, page.image, page.dirtyMin.x(), page.dirtyMin.y(),
+                             page.dirtyMax.x() - page.dirtyMin.x(),
+                             page.dirtyMax.y() - page.dirtyMin.y(), page.pixels.data());
+        page.dirtyMin = Vector2i::Constant(mAtlasPageSize);
+        page.dirtyMax = Vector2i::Zero();
+    }
+
+    auto cellPosition = [&](int index) -> Vector2f {
+        return (mPos + Vector2i::Constant(mMargin) +
+                Vector2i(index % grid.x(), index / grid.x()) * stride).cast<float>();
+    };
+    auto addRect = [&](const Vector2f &p, float size, const Vector2i &src, int srcSize) {
+        float rect[8] = { p.x(), p.y(), size, size,
+                          (float) src.x(), (float) src.y(), (float) srcSize, (float) srcSize };
+        mRects.insert(mRects.end(), rect, rect + 8);
+    };
+    int thumbPixels = std::max(1, (int) std::round(mThumbSize * mAtlasRatio));
+
+    /* One call per page for the icons, and one for the hovered icon */
+    for (size_t i = 0; i < mPages.size(); ++i) {
+        mRects.clear();
+        for (auto const &v : visible)
+            if (v.second.page == (int) i && v.first != mMouseIndex)
+                addRect(cellPosition(v.first), mThumbSize, v.second.pos, thumbPixels);
+        if (!mRects.empty())
+            nvgImageRects(ctx, mPages[i].image, mRects.data(), (int) mRects.size() / 8, 0.7f);
+    }
+    for (auto const &v : visible) {
+        if (v.first != mMouseIndex || v.second.page < 0)
+            continue;
+        mRects.clear();
+        addRect(cellPosition(v.first), mThumbSize, v.second.pos, thumbPixels);
+        nvgImageRects(ctx, mPages[v.second.page].image, mRects.data(), 1, 1.f);
+    }
+
+    /* One call for the shadows and borders */
+    if (mDecorationImage) {
+        int decorationPixels;
+        nvgImageSize(ctx, mDecorationImage, &decorationPixels, &decorationPixels);
+        mRects.clear();
+        for (auto const &v : visible)
+            addRect(cellPosition(v.first) - Vector2f::Constant(ShadowSize),
+                    mThumbSize + 2 * ShadowSize, Vector2i::Zero(), decorationPixels);
+        nvgImageRects(ctx, mDecorationImage, mRects.data(), (int) mRects.size() / 8, 1.f);
+    }
+
+    /* Release the pages beyond the limit that are not drawn */
+    while ((int) mPages.size() > mAtlasPageLimit) {
+        int page = -1;
+        for (size_t i = 0; i < mPages.size(); ++i) {
+            if (mPages[i].lastUsed != mFrame &&
+                (page < 0 || mPages[i].lastUsed < mPages[page].lastUsed))
+                page = (int) i;
+        }
+        if (page < 0)
+            break;
+        releasePage(page);
+    }
+}
+
+const ImagePanel::Thumbnail *ImagePanel::thumbnail(NVGcontext *ctx, int index, int &budget) {
+    auto it = mThumbnails.find(index);
+    if (it != mThumbnails.end()) {
+        if (it->second.page >= 0)
+            mPages[it->second.page].lastUsed = mFrame;
+        return &it->second;
+    }
+    if (dataSourceMode())
+        return nullptr;
+    if (budget <= 0) {
+        mThumbnailsPending = true;
+        return nullptr;
+    }
+    --budget;
+
+    Vector2i size = Vector2i::Zero();
+    std::vector<uint8_t> pixels;
+    mThumbData.clear();
+    int thumbPixels = std::max(1, (int) std::round(mThumbSize * mAtlasRatio));
+    if (!mThumbnailSource(index, size, mThumbData) ||
+        !downscaleThumbnail(size, mThumbData, mThumbSize, thumbPixels, mAtlasRatio, pixels))
+        pixels.clear();
+    return storeThumbnail(ctx, index, pixels);
+}
+
+const ImagePanel::Thumbnail *ImagePanel::storeThumbnail(NVGcontext *ctx, int index,
+                                                        const std::vector<uint8_t> &pixels) {
+    Thumbnail thumb = { -1, Vector2i::Zero() };
+    int thumbPixels = std::max(1, (int) std::round(mThumbSize * mAtlasRatio));
+    if (pixels.size() != (size_t) thumbPixels * thumbPixels * 4 || !allocateThumbnail(ctx, thumb))
+        return &(mThumbnails[index] = thumb);
+
+    AtlasPage &page = mPages[thumb.page];
+    for (int y = 0; y < thumbPixels; ++y)
+        std::copy(&pixels[(size_t) y * thumbPixels * 4], &pixels[(size_t) (y + 1) * thumbPixels * 4],
+                  &page.pixels[((size_t) (thumb.pos.y() + y) * mAtlasPageSize + thumb.pos.x()) * 4]);
+
+    Vector2i end = thumb.pos + Vector2i::Constant(thumbPixels);
+    page.dirtyMin = page.dirtyMin.cwiseMin(thumb.pos);
+    page.dirtyMax = page.dirtyMax.cwiseMax(end);
+    return &(mThumbnails[index] = thumb);
+}
+
+bool ImagePanel::allocateThumbnail(NVGcontext *ctx, Thumbnail &thumb) {
+    /* Keep a transparent gutter so that filtering does not pick up neighbors */
+    int cell = std::max(1, (int) std::round(mThumbSize * mAtlasRatio)) + 1;
+    if (cell > mAtlasPageSize)
+        return false;
+
+    for (size_t i = 0; i < mPages.size(); ++i) {
+        if (skylineAddRect(mPages[i].skyline, mAtlasPageSize, cell, cell, thumb.pos)) {
+            thumb.page = (int) i;
+            mPages[i].lastUsed = mFrame;
+            return true;
+        }
+    }
+
+    /* Reuse the least recently drawn page once the limit is reached */
+    int index = -1;
+    if ((int) mPages.size() >= mAtlasPageLimit) {
+        for (size_t i = 0; i < mPages.size(); ++i) {
+            if (mPages[i].lastUsed != mFrame &&
+                (index < 0 || mPages[i].lastUsed < mPages[index].lastUsed))
+                index = (int) i;
+        }
+    }
+
+    if (index >= 0) {
+        for (auto it = mThumbnails.begin(); it != mThumbnails.end(); ) {
+            if (it->second.page == index)
+                it = mThumbnails.erase(it);
+            else
+                ++it;
+        }
+        std::fill(mPages[index].pixels.begin(), mPages[index].pixels.end(), 0);
+    } else {
+        /* Pages drawn in this frame are never cleared, so the limit may be exceeded */
+        AtlasPage page;
+        page.image = nvgCreateImageRGBA(ctx, mAtlasPageSize, mAtlasPageSize,
+                                        NVG_IMAGE_PREMULTIPLIED, nullptr);
+        if (page.image == 0)
+            return false;
+        page.pixels.assign((size_t) mAtlasPageSize * mAtlasPageSize * 4, 0);
+        index = (int) mPages.size();
+        mPages.push_back(std::move(page));
+    }
+
+    AtlasPage &page = mPages[index];
+    page.skyline.assign(1, Vector3i(0, 0, mAtlasPageSize));
+    page.dirtyMin = Vector2i::Zero();
+    page.dirtyMax = Vector2i::Constant(mAtlasPageSize);
+    page.lastUsed = mFrame;
+    skylineAddRect(page.skyline, mAtlasPageSize, cell, cell, thumb.pos);
+    thumb.page = index;
+    return true;
+}
+
+void ImagePanel::collectResults(NVGcontext *ctx, const Vector2i &cellMin,
+                                const Vector2i &cellMax) {
+    std::deque<Result> results;
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        results.swap(mResults);
+    }
+
+    int columns = gridSize().x();
+    for (auto &result : results) {
+        if (result.generation != mGeneration)
+            continue;
+        mRequested.erase(result.index);
+
+        /* Thumbnails that scrolled out of view are requested again if needed */
+        Vector2i cell(result.index % columns, result.index / columns);
+        if ((cell.array() < cellMin.array()).any() || (cell.array() >= cellMax.array()).any())
+            continue;
+        if (!result.success)
+            result.pixels.clear();
+        storeThumbnail(ctx, result.index, result.pixels);
+    }
+}
+
+void ImagePanel::requestThumbnails(const std::vector<int> &indices) {
+    int thumbPixels = std::max(1, (int) std::round(mThumbSize * mAtlasRatio));
+    bool notify;
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+
+        /* Requests that were not started are cancelled, and issued again
+           (in grid order) if their cell is still visible */
+        for (auto const &request : mRequests)
+            mRequested.erase(request.index);
+        mRequests.clear();
+        for (int index : indices) {
+            if (mRequested.insert(index).second)
+                mRequests.push_back(Request{ index, mGeneration, mThumbSize, thumbPixels, mAtlasRatio });
+        }
+
+        notify = !mRequests.empty();
+        if (notify && mThreads.empty()) {
+            for (int i = 0; i < mThreadCount; ++i)
+                mThreads.emplace_back([this] { workerThread(); });
+        }
+    }
+    if (notify)
+        mCondition.notify_all();
+}
+
+void ImagePanel::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+    for (auto &thread : mThreads)
+        thread.join();
+    mThreads.clear();
+
+    std::lock_guard<std::mutex> guard(mMutex);
+    mStop = false;
+    mRequests.clear();
+    mResults.clear();
+    mRequested.clear();
+}
+
+void ImagePanel::workerThread() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mCondition.wait(lock, [this] { return mStop || !mRequests.empty(); });
+        if (mStop)
+            return;
+        Request request = mRequests.front();
+        mRequests.pop_front();
+        ThumbnailSource source = mThumbnailSource;
+        lock.unlock();
+
+        Result result { request.index, request.generation, false, { } };
+        try {
+            Vector2i size = Vector2i::Zero();
+            std::vector<uint8_t> pixels;
+            result.success = source(request.index, size, pixels) &&
+                downscaleThumbnail(size, pixels, request.thumbSize, request.thumbPixels,
+                                   request.ratio, result.pixels);
+        } catch (const std::exception &) {
+            result.success = false;
+        }
+
+        lock.lock();
+        mResults.push_back(std::move(result));
+        bool notify = mResults.size() == 1;
+        std::function<void()> callback = mDataCallback;
+        lock.unlock();
+        /* Wake up the UI thread once per batch of results */
+        if (notify && callback)
+            callback();
+        lock.lock();
+    }
+}
+
+void ImagePanel::createDecoration(NVGcontext *ctx) {
+    /* Rasterize the shadow and border that drawImages() draws around each icon */
+    int size = std::max(1, (int) std::round((mThumbSize + 2 * ShadowSize) * mAtlasRatio));
+    std::vector<uint8_t> pixels((size_t) size * size * 4);
+    float half = mThumbSize * 0.5f;
+    Vector2f center = Vector2f::Constant(half),
+             shadowCenter = center + Vector2f(0.f, 1.f);
+
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            Vector2f p = Vector2f(x + 0.5f, y + 0.5f) / mAtlasRatio -
+                         Vector2f::Constant(ShadowSize);
+
+            /* Box gradient outside of the rounded icon */
+            float hole = std::min(std::max(
+                0.5f + sdRoundRect(p, center, half, 6.f) * mAtlasRatio, 0.f), 1.f);
+            float gradient = std::min(std::max(
+                (sdRoundRect(p, shadowCenter, half + 1.f, 5.f) + 1.5f) / 3.f, 0.f), 1.f);
+            float shadow = (128.f / 255.f) * (1.f - gradient) * hole;
+
+            /* One pixel wide border */
+            float border = std::min(std::max(
+                (0.5f - std::abs(sdRoundRect(p, center, half - 0.5f, 3.5f))) * mAtlasRatio + 0.5f,
+                0.f), 1.f) * (80.f / 255.f);
+
+            float alpha = border + shadow * (1.f - border);
+            uint8_t *dst = &pixels[((size_t) y * size + x) * 4];
+            dst[0] = dst[1] = dst[2] = (uint8_t) (border * 255.f + 0.5f);
+            dst[3] = (uint8_t) (alpha * 255.f + 0.5f);
+        }
+    }
+
+    mDecorationImage = nvgCreateImageRGBA(ctx, size, size, NVG_IMAGE_PREMULTIPLIED,
+                                          pixels.data());
+}
+
 NAMESPACE_END(nanogui)
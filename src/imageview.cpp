@@ -15,7 +15,12 @@
 #include <nanogui/window.h>
 #include <nanogui/screen.h>
 #include <nanogui/theme.h>
+#include <nanogui/opengl.h>
+#include "nanovg_bgfx.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -33,64 +38,97 @@ namespace {
         return strings;
     }
 
-    constexpr char const *const defaultImageViewVertexShader =
-        R"(#version 330
-        uniform vec2 scaleFactor;
-        uniform vec2 position;
-        in vec2 vertex;
-        out vec2 uv;
-        void main() {
-            uv = vertex;
-            vec2 scaledVertex = (vertex * scaleFactor) + position;
-            gl_Position  = vec4(2.0*scaledVertex.x - 1.0,
-                                1.0 - 2.0*scaledVertex.y,
-                                0.0, 1.0);
-
-        })";
-
-    constexpr char const *const defaultImageViewFragmentShader =
-        R"(#version 330
-        uniform sampler2D image;
-        out vec4 color;
-        in vec2 uv;
-        void main() {
-            color = texture(image, uv);
-        })";
-
-}
-
-ImageView::ImageView(Widget* parent, GLuint imageID)
-    : Widget(parent), mImageID(imageID), mScale(1.0f), mOffset(Vector2f::Zero()),
-    mFixedScale(false), mFixedOffset(false), mPixelInfoCallback(nullptr) {
-    updateImageParameters();
-    mShader.init("ImageViewShader", defaultImageViewVertexShader,
-                 defaultImageViewFragmentShader);
-
-    MatrixXu indices(3, 2);
-    indices.col(0) << 0, 1, 2;
-    indices.col(1) << 2, 3, 1;
-
-    MatrixXf vertices(2, 4);
-    vertices.col(0) << 0, 0;
-    vertices.col(1) << 1, 0;
-    vertices.col(2) << 0, 1;
-    vertices.col(3) << 1, 1;
-
-    mShader.bind();
-    mShader.uploadIndices(indices);
-    mShader.uploadAttrib("vertex", vertices);
+    /// Characters produced by formatPixelValue()
+    const char pixelValueGlyphs[] = "0123456789.-+einfa";
+
+    /// Return the index of a character of pixelValueGlyphs
+    int pixelValueGlyph(char c) {
+        return c >= '0' && c <= '9' ? c - '0' : (int) (std::strchr(pixelValueGlyphs, c) - pixelValueGlyphs);
+    }
+
+    /// Format a value with a fixed number of decimals; \c buffer holds at least 32 characters
+    int formatPixelValue(float value, int decimals, char* buffer) {
+        if (std::isnan(value)) {
+            std::memcpy(buffer, "nan", 3);
+            return 3;
+        }
+        if (std::isinf(value)) {
+            std::memcpy(buffer, value < 0 ? "-inf" : "inf", value < 0 ? 4 : 3);
+            return value < 0 ? 4 : 3;
+        }
+        static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+        decimals = std::min(std::max(decimals, 0), 6);
+        double scaled = std::abs((double) value) * powers[decimals] + 0.5;
+        if (scaled >= 1e15)
+            return std::snprintf(buffer, 32, "%.*e", decimals, value);
+
+        /* Digits are written backwards, then reversed */
+        uint64_t digits = (uint64_t) scaled;
+        int length = 0;
+        for (int i = 0; i <= decimals || digits != 0; ++i) {
+            if (i == decimals && decimals > 0)
+                buffer[length++] = '.';
+            buffer[length++] = (char) ('0' + digits % 10);
+            digits /= 10;
+        }
+        if (value < 0 && (uint64_t) scaled != 0)
+            buffer[length++] = '-';
+        std::reverse(buffer, buffer + length);
+        return length;
+    }
+
+}
+
+ImageView::ImageView(Widget* parent, int image)
+    : Widget(parent), mImage(image), mImageSize(Vector2i::Zero()), mImageChanged(image != 0),
+    mScale(1.0f), mOffset(Vector2f::Zero()), mFixedScale(false), mFixedOffset(false),
+    mPixelInfoCallback(nullptr) {
+    mTileCacheSize = 0;
+    mTileCacheBudget = 128 * 1024 * 1024;
+    mTileUploadsPerFrame = 4;
+    mTilesPending = false;
+    mFrame = 0;
+    mContext = nullptr;
+}
+
+ImageView::ImageView(Widget* parent, TiledImage* image)
+    : ImageView(parent) {
+    mTiledImage = image;
+    if (image)
+        mImageSize = image->size();
 }
 
 ImageView::~ImageView() {
-    mShader.free();
+    clearTileCache();
+}
+
+void ImageView::bindImage(int image) {
+    clearTileCache();
+    mTiledImage = nullptr;
+    mImage = image;
+    mImageSize = Vector2i::Zero();
+    // The size of the image is only known once a NanoVG context is at hand.
+    mImageChanged = image != 0;
 }
 
-void ImageView::bindImage(GLuint imageId) {
-    mImageID = imageId;
-    updateImageParameters();
+void ImageView::bindImage(TiledImage* image) {
+    clearTileCache();
+    mTiledImage = image;
+    mImage = 0;
+    mImageSize = image ? image->size() : Vector2i::Zero();
+    mImageChanged = false;
     fit();
 }
 
+void ImageView::clearTileCache() {
+    for (auto& item : mTiles)
+        nvgDeleteImage(mContext, item.second.image);
+    mTiles.clear();
+    mTileOrder.clear();
+    mTileCacheSize = 0;
+    mTilesPending = false;
+}
+
 Vector2f ImageView::imageCoordinateAt(const Vector2f& position) const {
     auto imagePosition = position - mOffset;
     return imagePosition / mScale;
@@ -123,7 +161,7 @@ void ImageView::center() {
 
 void ImageView::fit() {
     // Calculate the appropriate scaling factor.
-    mScale = (sizeF().cwiseQuotient(imageSizeF())).minCoeff();
+    mScale = std::max(0.01f, (sizeF().cwiseQuotient(imageSizeF())).minCoeff());
     center();
 }
 
@@ -169,8 +207,14 @@ bool ImageView::gridVisible() const {
     return (mGridThreshold != -1) && (mScale > mGridThreshold);
 }
 
+void ImageView::setPixelValueCallback(int channels, const PixelValueCallback& callback) {
+    mPixelValueChannels = callback ? std::max(channels, 0) : 0;
+    mPixelValueCallback = callback;
+}
+
 bool ImageView::pixelInfoVisible() const {
-    return mPixelInfoCallback && (mPixelInfoThreshold != -1) && (mScale > mPixelInfoThreshold);
+    return (mPixelInfoCallback || mPixelValueCallback) && (mPixelInfoThreshold != -1) &&
+           (mScale > mPixelInfoThreshold);
 }
 
 bool ImageView::helpersVisible() const {
@@ -270,56 +314,202 @@ bool ImageView::keyboardCharacterEvent(unsigned int codepoint) {
     return false;
 }
 
-Vector2i ImageView::preferredSize(NVGcontext* /*ctx*/) const {
+Vector2i ImageView::preferredSize(NVGcontext* ctx) const {
+    if (mImage != 0) {
+        Vector2i size;
+        nvgImageSize(ctx, mImage, &size.x(), &size.y());
+        return size;
+    }
     return mImageSize;
 }
 
 void ImageView::performLayout(NVGcontext* ctx) {
     Widget::performLayout(ctx);
+    updateImageParameters(ctx);
     center();
 }
 
 void ImageView::draw(NVGcontext* ctx) {
     Widget::draw(ctx);
-    nvgEndFrame(ctx); // Flush the NanoVG draw stack, not necessary to call nvgBeginFrame afterwards.
+    updateImageParameters(ctx);
 
+    drawImage(ctx);
     drawWidgetBorder(ctx);
     drawImageBorder(ctx);
 
-    // Calculate several variables that need to be send to OpenGL in order for the image to be
-    // properly displayed inside the widget.
-    const Screen* screen = dynamic_cast<const Screen*>(this->window()->parent());
-    assert(screen);
-    Vector2f screenSize = screen->size().cast<float>();
-    Vector2f scaleFactor = mScale * imageSizeF().cwiseQuotient(screenSize);
-    Vector2f positionInScreen = absolutePosition().cast<float>();
-    Vector2f positionAfterOffset = positionInScreen + mOffset;
-    Vector2f imagePosition = positionAfterOffset.cwiseQuotient(screenSize);
-    glEnable(GL_SCISSOR_TEST);
-    float r = screen->pixelRatio();
-    glScissor(positionInScreen.x() * r, (screenSize.y() - positionInScreen.y() - size().y()) * r,
-              size().x()*r, size().y()*r);
-    mShader.bind();
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, mImageID);
-    mShader.setUniform("image", 0);
-    mShader.setUniform("scaleFactor", scaleFactor);
-    mShader.setUniform("position", imagePosition);
-    mShader.drawIndexed(GL_TRIANGLES, 0, 2);
-    glDisable(GL_SCISSOR_TEST);
-
     if (helpersVisible())
         drawHelpers(ctx);
 }
 
+void ImageView::updateImageParameters(NVGcontext* ctx) {
+    if (mImage == 0)
+        return;
+    // Query the size of the NanoVG image, which changes when an image loaded
+    // in the background replaces its placeholder, and show all of it.
+    Vector2i imageSize;
+    nvgImageSize(ctx, mImage, &imageSize.x(), &imageSize.y());
+    if (!mImageChanged && imageSize == mImageSize)
+        return;
+    mImageSize = imageSize;
+    mImageChanged = false;
+    fit();
+}
+
+int ImageView::cachedTile(int level, const Vector2i& tile) {
+    auto it = mTiles.find(tileKey(level, tile));
+    if (it == mTiles.end())
+        return 0;
+    Tile& cached = it->second;
+    cached.lastUsed = mFrame;
+    mTileOrder.splice(mTileOrder.begin(), mTileOrder, cached.order);
+    return cached.image;
+}
+
+int ImageView::uploadTile(NVGcontext* ctx, int level, const Vector2i& tile) {
+    Vector2i extent = mTiledImage->tileExtent(level, tile);
+    mTileData.resize((size_t) extent.x() * (size_t) extent.y() * 4);
+    mTiledImage->loadTile(level, tile, mTileData.data());
+
+    // Magnified full resolution tiles show crisp pixels (for the pixel grid) and no seams.
+    int image = nvgCreateImageRGBA(ctx, extent.x(), extent.y(),
+                                   level == 0 ? NVG_IMAGE_NEAREST : 0, mTileData.data());
+    if (image == 0)
+        throw std::runtime_error("ImageView: could not upload an image tile!");
+
+    uint64_t key = tileKey(level, tile);
+    mTileOrder.push_front(key);
+    Tile& cached = mTiles[key];
+    cached.image = image;
+    cached.bytes = mTileData.size();
+    cached.lastUsed = mFrame;
+    cached.order = mTileOrder.begin();
+    mTileCacheSize += cached.bytes;
+    return image;
+}
+
+void ImageView::evictTiles(NVGcontext* ctx) {
+    while (mTileCacheSize > mTileCacheBudget && !mTileOrder.empty()) {
+        auto it = mTiles.find(mTileOrder.back());
+        // The tiles drawn in this frame are all kept, even when they exceed the budget.
+        if (it->second.lastUsed == mFrame)
+            break;
+        nvgDeleteImage(ctx, it->second.image);
+        mTileCacheSize -= it->second.bytes;
+        mTiles.erase(it);
+        mTileOrder.pop_back();
+    }
+}
+
+void ImageView::drawImage(NVGcontext* ctx) {
+    Vector2f origin = positionF() + mOffset;
+    nvgSave(ctx);
+    nvgIntersectScissor(ctx, mPos.x(), mPos.y(), mSize.x(), mSize.y());
+    bool toneMap = toneMapped();
+    if (toneMap)
+        nvgToneMap(ctx, mExposure, mGamma, mFalseColor);
+    if (mTiledImage) {
+        drawTiles(ctx, origin);
+    } else if (mImage != 0) {
+        Vector2f size = scaledImageSizeF();
+        NVGpaint imgPaint = nvgImagePattern(ctx, origin.x(), origin.y(), size.x(), size.y(),
+                                            0, mImage, 1.0f);
+        nvgBeginPath(ctx);
+        nvgRect(ctx, origin.x(), origin.y(), size.x(), size.y());
+        nvgFillPaint(ctx, imgPaint);
+        nvgFill(ctx);
+    }
+    if (toneMap)
+        nvgToneMap(ctx, 0, 1, 0);
+    nvgRestore(ctx);
+}
+
+void ImageView::drawTiles(NVGcontext* ctx, const Vector2f& origin) {
+    if (mContext != ctx) {
+        clearTileCache();
+        mContext = ctx;
+    }
+    ++mFrame;
+    mTilesPending = false;
+
+    // Pick the coarsest level that still has at least one pixel per screen pixel.
+    int levelCount = mTiledImage->levelCount();
+    int level = 0;
+    while (level + 1 < levelCount && mScale * (1 << (level + 1)) <= 1.0f)
+        ++level;
+
+    // The single tile of the coarsest level is always uploaded, so that there
+    // is something to show in place of the tiles that are not uploaded yet.
+    if (cachedTile(levelCount - 1, Vector2i::Zero()) == 0)
+        uploadTile(ctx, levelCount - 1, Vector2i::Zero());
+
+    // Find the range of tiles covering the visible part of the image.
+    float tileSpan = (float) (mTiledImage->tileSize() << level);
+    Vector2f begin = clampedImageCoordinateAt(Vector2f::Zero());
+    Vector2f end = clampedImageCoordinateAt(sizeF());
+    if (begin.x() >= end.x() || begin.y() >= end.y()) {
+        evictTiles(ctx);
+        return;
+    }
+    Vector2i tileCount = mTiledImage->tileCount(level);
+    Vector2i firstTile = (begin / tileSpan).cast<int>();
+    Vector2i lastTile = (end / tileSpan).unaryExpr([](float x) { return std::ceil(x); })
+        .cast<int>().cwiseMin(tileCount) - Vector2i::Ones();
+
+    int uploads = mTileUploadsPerFrame;
+    Vector2i tile;
+    for (tile.y() = firstTile.y(); tile.y() <= lastTile.y(); ++tile.y()) {
+        for (tile.x() = firstTile.x(); tile.x() <= lastTile.x(); ++tile.x()) {
+            Vector2f clipBegin = tile.cast<float>() * tileSpan;
+            Vector2f clipEnd = (clipBegin + Vector2f::Constant(tileSpan)).cwiseMin(imageSizeF());
+
+            int image = cachedTile(level, tile);
+            if (image == 0 && uploads > 0) {
+                image = uploadTile(ctx, level, tile);
+                --uploads;
+            }
+            if (image != 0) {
+                drawTile(ctx, origin, level, tile, image, clipBegin, clipEnd);
+                continue;
+            }
+
+            // Show the area of the tile from the finest coarser level uploaded.
+            mTilesPending = true;
+            for (int coarser = level + 1; coarser < levelCount; ++coarser) {
+                Vector2i parent(tile.x() >> (coarser - level), tile.y() >> (coarser - level));
+                int parentImage = cachedTile(coarser, parent);
+                if (parentImage != 0) {
+                    drawTile(ctx, origin, coarser, parent, parentImage, clipBegin, clipEnd);
+                    break;
+                }
+            }
+        }
+    }
+
+    evictTiles(ctx);
+}
+
+void ImageView::drawTile(NVGcontext* ctx, const Vector2f& origin, int level, const Vector2i& tile,
+                         int image, const Vector2f& clipBegin, const Vector2f& clipEnd) const {
+    // Position and size of the tile on the widget.
+    float tileSpan = (float) (mTiledImage->tileSize() << level);
+    Vector2f tilePosition = origin + mScale * tileSpan * tile.cast<float>();
+    Vector2f tileSize = mScale * (float) (1 << level) *
+        mTiledImage->tileExtent(level, tile).cast<float>();
+    NVGpaint imgPaint = nvgImagePattern(ctx, tilePosition.x(), tilePosition.y(),
+                                        tileSize.x(), tileSize.y(), 0, image, 1.0f);
+
+    // Adjacent tiles overlap by a pixel so that their antialiased edges do not show seams.
+    Vector2f rectBegin = origin + mScale * clipBegin;
+    Vector2f rectEnd = origin + mScale * clipEnd;
+    if (clipEnd.x() < mImageSize.x())
+        rectEnd.x() += 1;
+    if (clipEnd.y() < mImageSize.y())
+        rectEnd.y() += 1;
 
-void ImageView::updateImageParameters() {
-    // Query the width of the OpenGL texture.
-    glBindTexture(GL_TEXTURE_2D, mImageID);
-    GLint w, h;
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
-    mImageSize = Vector2i(w, h);
+    nvgBeginPath(ctx);
+    nvgRect(ctx, rectBegin.x(), rectBegin.y(), rectEnd.x() - rectBegin.x(), rectEnd.y() - rectBegin.y());
+    nvgFillPaint(ctx, imgPaint);
+    nvgFill(ctx);
 }
 
 void ImageView::drawWidgetBorder(NVGcontext* ctx) const {
@@ -353,17 +543,24 @@ void ImageView::drawHelpers(NVGcontext* ctx) const {
     // We need to apply mPos after the transformation to account for the position of the widget
     // relative to the parent.
     Vector2f upperLeftCorner = positionForCoordinate(Vector2f(0, 0)) + positionF();
-    Vector2f lowerRightCorner = positionForCoordinate(imageSizeF()) + positionF();
     // Use the scissor method in NanoVG to display only the correct part of the grid.
     Vector2f scissorPosition = upperLeftCorner.array().max(positionF().array());
+    // Only draw the grid lines of the visible pixels, which matters for large images.
+    Vector2f firstPixel = clampedImageCoordinateAt(Vector2f::Zero()).unaryExpr([](float x) { return std::floor(x); });
+    Vector2f lastPixel = clampedImageCoordinateAt(sizeF()).unaryExpr([](float x) { return std::ceil(x); });
     Vector2f sizeOffsetDifference = sizeF() - mOffset;
     Vector2f scissorSize = sizeOffsetDifference.array().min(sizeF().array());
     nvgSave(ctx);
     nvgScissor(ctx, scissorPosition.x(), scissorPosition.y(), scissorSize.x(), scissorSize.y());
     if (gridVisible())
-        drawPixelGrid(ctx, upperLeftCorner, lowerRightCorner, mScale);
-    if (pixelInfoVisible())
-        drawPixelInfo(ctx, mScale);
+        drawPixelGrid(ctx, positionForCoordinate(firstPixel) + positionF(),
+                      positionForCoordinate(lastPixel) + positionF(), mScale);
+    if (pixelInfoVisible()) {
+        if (mPixelValueCallback)
+            drawPixelValues(ctx, mScale);
+        else
+            drawPixelInfo(ctx, mScale);
+    }
     nvgRestore(ctx);
 }
 
@@ -466,4 +663,76 @@ void ImageView::writePixelInfo(NVGcontext* ctx, const Vector2f& cellPosition,
     }
 }
 
+void ImageView::drawPixelValues(NVGcontext* ctx, const float stride) const {
+    // Read the values of all pixels that are at least partially visible.
+    Vector2i firstPixel = clampedImageCoordinateAt(Vector2f::Zero())
+        .unaryExpr([](float x) { return std::floor(x); }).cast<int>();
+    Vector2i lastPixel = clampedImageCoordinateAt(sizeF())
+        .unaryExpr([](float x) { return std::ceil(x); }).cast<int>();
+    Vector2i count = lastPixel - firstPixel;
+    int channels = mPixelValueChannels;
+    if (count.x() <= 0 || count.y() <= 0 || channels == 0)
+        return;
+    mPixelValues.resize((size_t) count.prod() * channels);
+    mPixelValueCallback(firstPixel, count, mPixelValues.data());
+
+    nvgSave(ctx);
+    nvgFontSize(ctx, std::min(stride * mFontScaleFactor, 30.0f));
+    nvgFontFace(ctx, "sans");
+
+    // The glyphs are requested every frame, since the font atlas may have been rebuilt.
+    const int glyphCount = sizeof(pixelValueGlyphs) - 1;
+    NVGglyphQuad glyphs[glyphCount];
+    int atlas = 0;
+    float ascender = 0, rowHeight = 0;
+    if (nvgTextGlyphQuads(ctx, pixelValueGlyphs, nullptr, glyphs, glyphCount, &atlas) != glyphCount) {
+        nvgRestore(ctx);
+        return;
+    }
+    nvgTextMetrics(ctx, &ascender, nullptr, &rowHeight);
+
+    // Show as many channels as fit in a cell, centered like the pixel info text.
+    auto padding = stride / 10;
+    auto maxSize = stride - 2 * padding;
+    int rows = channels;
+    float yOffset = (stride - rowHeight * rows) / 2;
+    if (rowHeight * rows > maxSize) {
+        rows = (int) (maxSize / rowHeight);
+        yOffset = padding;
+    }
+
+    mGlyphRects.clear();
+    Vector2f cellPosition = positionF() + positionForCoordinate(firstPixel.cast<float>());
+    const float* values = mPixelValues.data();
+    char text[32];
+    for (int y = 0; y < count.y(); ++y) {
+        for (int x = 0; x < count.x(); ++x, values += channels) {
+            Vector2f cell = cellPosition + Vector2f(x, y) * stride;
+            for (int c = 0; c < rows; ++c) {
+                int length = formatPixelValue(values[c], mPixelValueDecimals, text);
+                float width = 0;
+                for (int i = 0; i < length; ++i)
+                    width += glyphs[pixelValueGlyph(text[i])].advance;
+                float penX = cell.x() + (stride - width) / 2,
+                      penY = cell.y() + yOffset + c * rowHeight + ascender;
+                for (int i = 0; i < length; ++i) {
+                    const NVGglyphQuad& q = glyphs[pixelValueGlyph(text[i])];
+                    float rect[8] = { penX + q.x0, penY + q.y0, q.x1 - q.x0, q.y1 - q.y0,
+                                      q.s0, q.t0, q.s1 - q.s0, q.t1 - q.t0 };
+                    mGlyphRects.insert(mGlyphRects.end(), rect, rect + 8);
+                    penX += q.advance;
+                }
+            }
+        }
+    }
+
+    // A dark shadow keeps the text readable on top of bright pixels.
+    int rectCount = (int) mGlyphRects.size() / 8;
+    nvgTranslate(ctx, 1.0f, 1.0f);
+    nvgTintedImageRects(ctx, atlas, mGlyphRects.data(), rectCount, Color(0, 160));
+    nvgTranslate(ctx, -1.0f, -1.0f);
+    nvgTintedImageRects(ctx, atlas, mGlyphRects.data(), rectCount, Color(255, 255));
+    nvgRestore(ctx);
+}
+
 NAMESPACE_END(nanogui)
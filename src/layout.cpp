@@ -16,6 +16,7 @@
 #include <nanogui/window.h>
 #include <nanogui/theme.h>
 #include <nanogui/label.h>
+#include <algorithm>
 #include <numeric>
 
 NAMESPACE_BEGIN(nanogui)
@@ -194,6 +195,52 @@ void GroupLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     }
 }
 
+void LayoutCellCache::update(NVGcontext *ctx, const Widget *widget) {
+    auto measure = [ctx](const Widget *w) {
+        Vector2i ps = w->preferredSize(ctx), fs = w->fixedSize();
+        return Vector2i(
+            fs[0] ? fs[0] : ps[0],
+            fs[1] ? fs[1] : ps[1]
+        );
+    };
+
+    /* Can the previous measurements be reused? Only if the set of visible
+       children is unchanged (a cheap pointer comparison) */
+    bool reuse = enabled && valid && owner == widget;
+    if (reuse) {
+        size_t index = 0;
+        for (auto w : widget->children()) {
+            if (!w->visible())
+                continue;
+            if (index >= widgets.size() || widgets[index] != w) {
+                reuse = false;
+                break;
+            }
+            ++index;
+        }
+        reuse &= index == widgets.size();
+    }
+
+    if (!reuse) {
+        widgets.clear();
+        sizes.clear();
+        for (auto w : widget->children()) {
+            if (!w->visible())
+                continue;
+            widgets.push_back(w);
+            sizes.push_back(measure(w));
+        }
+        owner = widget;
+        valid = true;
+    } else if (!dirty.empty()) {
+        for (size_t i = 0; i < widgets.size(); ++i) {
+            if (std::find(dirty.begin(), dirty.end(), widgets[i]) != dirty.end())
+                sizes[i] = measure(widgets[i]);
+        }
+    }
+    dirty.clear();
+}
+
 Vector2i GridLayout::preferredSize(NVGcontext *ctx,
                                    const Widget *widget) const {
     /* Compute minimum row / column sizes */
@@ -216,37 +263,23 @@ Vector2i GridLayout::preferredSize(NVGcontext *ctx,
 
 void GridLayout::computeLayout(NVGcontext *ctx, const Widget *widget, std::vector<int> *grid) const {
     int axis1 = (int) mOrientation, axis2 = (axis1 + 1) % 2;
-    size_t numChildren = widget->children().size(), visibleChildren = 0;
-    for (auto w : widget->children())
-        visibleChildren += w->visible() ? 1 : 0;
+
+    mCache.update(ctx, widget);
+    const std::vector<Vector2i> &sizes = mCache.sizes;
+    int numCells = (int) sizes.size();
 
     Vector2i dim;
     dim[axis1] = mResolution;
-    dim[axis2] = (int) ((visibleChildren + mResolution - 1) / mResolution);
+    dim[axis2] = (numCells + mResolution - 1) / mResolution;
 
-    grid[axis1].clear(); grid[axis1].resize(dim[axis1], 0);
-    grid[axis2].clear(); grid[axis2].resize(dim[axis2], 0);
+    grid[axis1].assign(dim[axis1], 0);
+    grid[axis2].assign(dim[axis2], 0);
 
-    size_t child = 0;
-    for (int i2 = 0; i2 < dim[axis2]; i2++) {
-        for (int i1 = 0; i1 < dim[axis1]; i1++) {
-            Widget *w = nullptr;
-            do {
-                if (child >= numChildren)
-                    return;
-                w = widget->children()[child++];
-            } while (!w->visible());
-
-            Vector2i ps = w->preferredSize(ctx);
-            Vector2i fs = w->fixedSize();
-            Vector2i targetSize(
-                fs[0] ? fs[0] : ps[0],
-                fs[1] ? fs[1] : ps[1]
-            );
-
-            grid[axis1][i1] = std::max(grid[axis1][i1], targetSize[axis1]);
-            grid[axis2][i2] = std::max(grid[axis2][i2], targetSize[axis2]);
-        }
+    /* Single sweep over the contiguous cell sizes */
+    for (int i = 0; i < numCells; ++i) {
+        int i1 = i % mResolution, i2 = i / mResolution;
+        grid[axis1][i1] = std::max(grid[axis1][i1], sizes[i][axis1]);
+        grid[axis2][i2] = std::max(grid[axis2][i2], sizes[i][axis2]);
     }
 }
 
@@ -262,6 +295,11 @@ void GridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     computeLayout(ctx, widget, grid);
     int dim[2] = { (int) grid[0].size(), (int) grid[1].size() };
 
+    /* Copy the cells, since the same layout instance may be shared
+       with (and thus be re-run by) one of the children below */
+    std::vector<Widget *> widgets = mCache.widgets;
+    std::vector<Vector2i> sizes = mCache.sizes;
+
     Vector2i extra = Vector2i::Zero();
     const Window *window = dynamic_cast<const Window *>(widget);
     if (window && !window->title().empty())
@@ -291,26 +329,18 @@ void GridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     int axis1 = (int) mOrientation, axis2 = (axis1 + 1) % 2;
     Vector2i start = Vector2i::Constant(mMargin) + extra;
 
-    size_t numChildren = widget->children().size();
+    size_t numChildren = widgets.size();
     size_t child = 0;
 
     Vector2i pos = start;
     for (int i2 = 0; i2 < dim[axis2]; i2++) {
         pos[axis1] = start[axis1];
         for (int i1 = 0; i1 < dim[axis1]; i1++) {
-            Widget *w = nullptr;
-            do {
-                if (child >= numChildren)
-                    return;
-                w = widget->children()[child++];
-            } while (!w->visible());
-
-            Vector2i ps = w->preferredSize(ctx);
+            if (child >= numChildren)
+                return;
+            Widget *w = widgets[child];
             Vector2i fs = w->fixedSize();
-            Vector2i targetSize(
-                fs[0] ? fs[0] : ps[0],
-                fs[1] ? fs[1] : ps[1]
-            );
+            Vector2i targetSize = sizes[child++];
 
             Vector2i itemPos(pos);
             for (int j = 0; j < 2; j++) {
@@ -368,6 +398,12 @@ void AdvancedGridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     std::vector<int> grid[2];
     computeLayout(ctx, widget, grid);
 
+    /* Copy the cells, since the same layout instance may be shared
+       with (and thus be re-run by) one of the children below */
+    std::vector<Widget *> widgets = mCache.widgets;
+    std::vector<Vector2i> sizes = mCache.sizes;
+    std::vector<Anchor> anchors = mCellAnchor;
+
     grid[0].insert(grid[0].begin(), mMargin);
     const Window *window = dynamic_cast<const Window *>(widget);
     if (window && !window->title().empty())
@@ -378,16 +414,18 @@ void AdvancedGridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     for (int axis=0; axis<2; ++axis) {
         for (size_t i=1; i<grid[axis].size(); ++i)
             grid[axis][i] += grid[axis][i-1];
+    }
 
-        for (Widget *w : widget->children()) {
-            if (!w->visible())
-                continue;
-            Anchor anchor = this->anchor(w);
+    for (size_t i = 0; i < widgets.size(); ++i) {
+        Widget *w = widgets[i];
+        const Anchor &anchor = anchors[i];
+        Vector2i pos, size;
 
+        for (int axis=0; axis<2; ++axis) {
             int itemPos = grid[axis][anchor.pos[axis]];
             int cellSize  = grid[axis][anchor.pos[axis] + anchor.size[axis]] - itemPos;
-            int ps = w->preferredSize(ctx)[axis], fs = w->fixedSize()[axis];
-            int targetSize = fs ? fs : ps;
+            int fs = w->fixedSize()[axis];
+            int targetSize = sizes[i][axis];
 
             switch (anchor.align[axis]) {
                 case Alignment::Minimum:
@@ -403,13 +441,13 @@ void AdvancedGridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
                     break;
             }
 
-            Vector2i pos = w->position(), size = w->size();
             pos[axis] = itemPos;
             size[axis] = targetSize;
-            w->setPosition(pos);
-            w->setSize(size);
-            w->performLayout(ctx);
         }
+
+        w->setPosition(pos);
+        w->setSize(size);
+        w->performLayout(ctx);
     }
 }
 
@@ -428,50 +466,63 @@ void AdvancedGridLayout::computeLayout(NVGcontext *ctx, const Widget *widget,
 
     containerSize -= extra;
 
+    /* Gather the per-cell constraints into contiguous arrays */
+    mCache.update(ctx, widget);
+    const std::vector<Vector2i> &cellSizes = mCache.sizes;
+    size_t numCells = cellSizes.size();
+    mCellAnchor.resize(numCells);
+    for (size_t i = 0; i < numCells; ++i)
+        mCellAnchor[i] = anchor(mCache.widgets[i]);
+
+    std::vector<size_t> spanning;
     for (int axis=0; axis<2; ++axis) {
         std::vector<int> &grid = _grid[axis];
         const std::vector<int> &sizes = axis == 0 ? mCols : mRows;
         const std::vector<float> &stretch = axis == 0 ? mColStretch : mRowStretch;
         grid = sizes;
 
-        for (int phase = 0; phase < 2; ++phase) {
-            for (auto pair : mAnchor) {
-                const Widget *w = pair.first;
-                if (!w->visible())
-                    continue;
-                const Anchor &anchor = pair.second;
-                if ((anchor.size[axis] == 1) != (phase == 0))
-                    continue;
-                int ps = w->preferredSize(ctx)[axis], fs = w->fixedSize()[axis];
-                int targetSize = fs ? fs : ps;
-
-                if (anchor.pos[axis] + anchor.size[axis] > (int) grid.size())
-                    throw std::runtime_error(
-                        "Advanced grid layout: widget is out of bounds: " +
-                        (std::string) anchor);
-
-                int currentSize = 0;
-                float totalStretch = 0;
-                for (int i = anchor.pos[axis];
-                     i < anchor.pos[axis] + anchor.size[axis]; ++i) {
-                    if (sizes[i] == 0 && anchor.size[axis] == 1)
-                        grid[i] = std::max(grid[i], targetSize);
-                    currentSize += grid[i];
-                    totalStretch += stretch[i];
-                }
-                if (targetSize <= currentSize)
-                    continue;
-                if (totalStretch == 0)
-                    throw std::runtime_error(
-                        "Advanced grid layout: no space to place widget: " +
-                        (std::string) anchor);
-                float amt = (targetSize - currentSize) / totalStretch;
-                for (int i = anchor.pos[axis];
-                     i < anchor.pos[axis] + anchor.size[axis]; ++i) {
-                    grid[i] += (int) std::round(amt * stretch[i]);
-                }
+        auto fit = [&](size_t index) {
+            const Anchor &anchor = mCellAnchor[index];
+            int targetSize = cellSizes[index][axis];
+
+            int currentSize = 0;
+            float totalStretch = 0;
+            for (int i = anchor.pos[axis];
+                 i < anchor.pos[axis] + anchor.size[axis]; ++i) {
+                if (sizes[i] == 0 && anchor.size[axis] == 1)
+                    grid[i] = std::max(grid[i], targetSize);
+                currentSize += grid[i];
+                totalStretch += stretch[i];
+            }
+            if (targetSize <= currentSize)
+                return;
+            if (totalStretch == 0)
+                throw std::runtime_error(
+                    "Advanced grid layout: no space to place widget: " +
+                    (std::string) anchor);
+            float amt = (targetSize - currentSize) / totalStretch;
+            for (int i = anchor.pos[axis];
+                 i < anchor.pos[axis] + anchor.size[axis]; ++i) {
+                grid[i] += (int) std::round(amt * stretch[i]);
             }
+        };
+
+        /* Single sweep: place single-cell items right away and defer
+           spanning items until all individual rows/columns are known */
+        spanning.clear();
+        for (size_t i = 0; i < numCells; ++i) {
+            const Anchor &anchor = mCellAnchor[i];
+            if (anchor.pos[axis] + anchor.size[axis] > (int) grid.size())
+                throw std::runtime_error(
+                    "Advanced grid layout: widget is out of bounds: " +
+                    (std::string) anchor);
+            if (anchor.size[axis] == 1)
+                fit(i);
+            else
+                spanning.push_back(i);
         }
+        for (size_t i : spanning)
+            fit(i);
 
         int currentSize = std::accumulate(grid.begin(), grid.end(), 0);
         float totalStretch = std::accumulate(stretch.begin(), stretch.end(), 0.0f);
@@ -0,0 +1,305 @@
+/*
+    src/listview.cpp -- Virtualized list that only instantiates widgets
+    for the rows that are currently visible
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/listview.h>
+#include <nanogui/opengl.h>
+#include <nanogui/serializer/core.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+ListView::ListView(Widget *parent)
+    : Widget(parent), mRowCount(0), mRowHeight(20), mScrollOffset(0) { }
+
+void ListView::setRowCount(int rowCount) {
+    mRowCount = std::max(rowCount, 0);
+    resetHeights();
+    releaseRows();
+}
+
+void ListView::setRowFactory(const std::function<Widget *(ListView *)> &rowFactory) {
+    mRowFactory = rowFactory;
+    clearRows();
+}
+
+void ListView::setRowBinder(const std::function<void(Widget *, int)> &rowBinder) {
+    mRowBinder = rowBinder;
+    reloadData();
+}
+
+void ListView::setRowHeight(int rowHeight) {
+    mRowHeight = std::max(rowHeight, 1);
+    resetHeights();
+}
+
+void ListView::setRowHeightCallback(const std::function<int(int)> &callback) {
+    mRowHeightCallback = callback;
+    resetHeights();
+}
+
+void ListView::invalidateRow(int row) {
+    if (row < 0 || row >= mRowCount)
+        return;
+    if (mRowHeightCallback)
+        mHeightKnown[row] = 0;
+    for (auto &entry : mRows)
+        if (entry.row == row)
+            entry.bound = false;
+}
+
+void ListView::reloadData() {
+    for (auto &entry : mRows)
+        entry.bound = false;
+}
+
+void ListView::setScrollOffset(int offset) {
+    mScrollOffset = std::max(0, std::min(offset, contentHeight() - mSize.y()));
+}
+
+void ListView::scrollToRow(int row) {
+    if (row < 0 || row >= mRowCount)
+        return;
+    measureRow(row);
+    int top = rowOffset(row), bottom = top + heightOf(row);
+    if (top < mScrollOffset)
+        setScrollOffset(top);
+    else if (bottom > mScrollOffset + mSize.y())
+        setScrollOffset(bottom - mSize.y());
+}
+
+int ListView::rowOffset(int row) const {
+    row = std::max(0, std::min(row, mRowCount));
+    if (!mRowHeightCallback)
+        return row * mRowHeight;
+    int offset = 0;
+    for (int i = row; i > 0; i -= i & -i)
+        offset += mHeightTree[i];
+    return offset;
+}
+
+int ListView::rowAt(int offset) const {
+    if (mRowCount == 0 || offset <= 0)
+        return 0;
+    if (!mRowHeightCallback)
+        return std::min(offset / mRowHeight, mRowCount - 1);
+
+    /* Descend the Fenwick tree to find the number of rows ending at or above 'offset' */
+    int row = 0, step = 1;
+    while (step * 2 <= mRowCount)
+        step *= 2;
+    for (; step > 0; step /= 2) {
+        if (row + step <= mRowCount && mHeightTree[row + step] <= offset) {
+            row += step;
+            offset -= mHeightTree[row];
+        }
+    }
+    return std::min(row, mRowCount - 1);
+}
+
+std::pair<int, int> ListView::visibleRows() const {
+    if (mRows.empty())
+        return std::make_pair(0, 0);
+    return std::make_pair(mRows.front().row, mRows.back().row + 1);
+}
+
+Widget *ListView::rowWidget(int row) const {
+    for (const auto &entry : mRows)
+        if (entry.row == row)
+            return entry.widget;
+    return nullptr;
+}
+
+void ListView::measureRow(int row) {
+    if (!mRowHeightCallback || mHeightKnown[row])
+        return;
+    mHeightKnown[row] = 1;
+    int delta = std::max(mRowHeightCallback(row), 0) - mHeights[row];
+    if (delta == 0)
+        return;
+    mHeights[row] += delta;
+    for (int i = row + 1; i <= mRowCount; i += i & -i)
+        mHeightTree[i] += delta;
+}
+
+int ListView::heightOf(int row) const {
+    return mRowHeightCallback ? mHeights[row] : mRowHeight;
+}
+
+void ListView::resetHeights() {
+    mHeights.clear();
+    mHeightTree.clear();
+    mHeightKnown.clear();
+    if (mRowHeightCallback) {
+        mHeights.assign(mRowCount, mRowHeight);
+        mHeightKnown.assign(mRowCount, 0);
+        /* Linear-time Fenwick tree construction */
+        mHeightTree.assign(mRowCount + 1, 0);
+        for (int i = 1; i <= mRowCount; ++i) {
+            mHeightTree[i] += mRowHeight;
+            int parent = i + (i & -i);
+            if (parent <= mRowCount)
+                mHeightTree[parent] += mHeightTree[i];
+        }
+    }
+    for (auto &entry : mRows)
+        entry.bound = false;
+}
+
+Widget *ListView::acquireRow() {
+    if (!mFreeRows.empty()) {
+        Widget *widget = mFreeRows.back();
+        mFreeRows.pop_back();
+        widget->setVisible(true);
+        return widget;
+    }
+    if (!mRowFactory)
+        throw std::runtime_error("ListView: no row factory was specified!");
+    Widget *widget = mRowFactory(this);
+    if (!widget || widget->parent() != this)
+        throw std::runtime_error("ListView: the row factory must create a child of the list!");
+    return widget;
+}
+
+void ListView::releaseRows() {
+    for (auto &entry : mRows) {
+        entry.widget->setVisible(false);
+        mFreeRows.push_back(entry.widget);
+    }
+    mRows.clear();
+}
+
+void ListView::clearRows() {
+    releaseRows();
+    for (auto widget : mFreeRows)
+        removeChild(widget);
+    mFreeRows.clear();
+}
+
+void ListView::updateRows(NVGcontext *ctx) {
+    int viewHeight = mSize.y();
+
+    /* Determine the visible range. Measuring rows may change the offsets,
+       hence repeat until no new heights were discovered */
+    int first = 0, last = 0;
+    for (int iteration = 0; iteration < 4; ++iteration) {
+        setScrollOffset(mScrollOffset);
+        first = rowAt(mScrollOffset);
+        last = first;
+        bool measured = false;
+        for (int y = rowOffset(first); last < mRowCount && y < mScrollOffset + viewHeight; ++last) {
+            if (mRowHeightCallback && !mHeightKnown[last]) {
+                measureRow(last);
+                measured = true;
+            }
+            y += heightOf(last);
+        }
+        if (!measured)
+            break;
+    }
+
+    /* Recycle the widgets of rows that scrolled out of view, and keep the
+       ones that are still visible without binding them again */
+    std::vector<VisibleRow> rows;
+    rows.reserve(last - first);
+    for (auto &entry : mRows) {
+        if (entry.row < first || entry.row >= last) {
+            entry.widget->setVisible(false);
+            mFreeRows.push_back(entry.widget);
+        }
+    }
+    size_t index = 0;
+    for (int row = first; row < last; ++row) {
+        while (index < mRows.size() && mRows[index].row < row)
+            ++index;
+        if (index < mRows.size() && mRows[index].row == row)
+            rows.push_back(mRows[index]);
+        else
+            rows.push_back(VisibleRow{ row, acquireRow(), false });
+    }
+    mRows.swap(rows);
+
+    int width = mSize.x() - (contentHeight() > viewHeight ? 12 : 0);
+    for (auto &entry : mRows) {
+        Vector2i size(width, heightOf(entry.row));
+        bool relayout = !entry.bound || entry.widget->size() != size;
+        if (!entry.bound) {
+            if (mRowBinder)
+                mRowBinder(entry.widget, entry.row);
+            entry.bound = true;
+        }
+        entry.widget->setPosition(Vector2i(0, rowOffset(entry.row) - mScrollOffset));
+        if (relayout) {
+            entry.widget->setSize(size);
+            entry.widget->performLayout(ctx);
+        }
+    }
+}
+
+void ListView::performLayout(NVGcontext *ctx) {
+    updateRows(ctx);
+}
+
+Vector2i ListView::preferredSize(NVGcontext *ctx) const {
+    int width = mRows.empty() ? 0 : mRows.front().widget->preferredSize(ctx).x();
+    return Vector2i(width + 12, std::min(contentHeight(), 10 * mRowHeight));
+}
+
+bool ListView::mouseDragEvent(const Vector2i &, const Vector2i &rel,
+                              int, int) {
+    int content = contentHeight();
+    if (content <= mSize.y())
+        return false;
+    float scrollh = height() * std::min(1.0f, height() / (float) content);
+    float delta = rel.y() / (float) (mSize.y() - 8 - scrollh);
+    setScrollOffset(mScrollOffset + (int) std::round(delta * (content - mSize.y())));
+    return true;
+}
+
+bool ListView::scrollEvent(const Vector2i &, const Vector2f &rel) {
+    if (contentHeight() <= mSize.y())
+        return false;
+    setScrollOffset(mScrollOffset - (int) std::round(rel.y() * 3 * mRowHeight));
+    return true;
+}
+
+void ListView::draw(NVGcontext *ctx) {
+    /* Rows are recycled every frame; this only touches the visible ones */
+    updateRows(ctx);
+    Widget::draw(ctx);
+
+    int content = contentHeight();
+    if (content <= mSize.y())
+        return;
+
+    float scrollh = height() * std::min(1.0f, height() / (float) content);
+    float scroll = mScrollOffset / (float) (content - mSize.y());
+    drawScrollBar(ctx, mPos.x() + mSize.x() - 12.f, mPos.y() + 4.f, mSize.y() - 8.f,
+                  scrollh, scroll, true);
+}
+
+void ListView::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("rowCount", mRowCount);
+    s.set("rowHeight", mRowHeight);
+    s.set("scrollOffset", mScrollOffset);
+}
+
+bool ListView::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    if (!s.get("rowCount", mRowCount)) return false;
+    if (!s.get("rowHeight", mRowHeight)) return false;
+    if (!s.get("scrollOffset", mScrollOffset)) return false;
+    resetHeights();
+    releaseRows();
+    return true;
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,406 @@
+/*
+    src/logview.cpp -- Scrolling log console that accepts lines from
+    any thread and filters them in the background
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/logview.h>
+#include <nanogui/theme.h>
+#include <nanogui/opengl.h>
+#include <nanogui/serializer/core.h>
+#include <algorithm>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Distance between the border and the text */
+static const int TextPadding = 4;
+/* Number of lines the filter thread matches before publishing its results */
+static const size_t FilterChunkSize = 4096;
+
+static char foldCase(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char) (c - 'A' + 'a') : c;
+}
+
+/* Case-insensitive (ASCII) substring search; \c pattern is already folded */
+static bool containsFolded(const std::string &text, const std::string &pattern) {
+    if (pattern.size() > text.size())
+        return false;
+    return std::search(text.begin(), text.end(), pattern.begin(), pattern.end(),
+        [](char a, char b) { return foldCase(a) == b; }) != text.end();
+}
+
+LogView::LogView(Widget *parent, size_t maxLines)
+    : Widget(parent), mPending(nullptr), mPendingCount(0),
+      mPendingLimit(std::max(maxLines, (size_t) 1)), mDropped(0),
+      mLines(std::max(maxLines, (size_t) 1)), mFirstLine(0), mLineCount(0),
+      mMaxLineWidth(0.f), mFilterGeneration(0), mFilterBusy(false),
+      mFilterStop(false), mFollowTail(true), mScrollOffset(Vector2i::Zero()),
+      mDragScrollbar(false) { }
+
+LogView::~LogView() {
+    if (mFilterThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(mFilterMutex);
+            mFilterStop = true;
+        }
+        mFilterCondition.notify_all();
+        mFilterThread.join();
+    }
+    PendingText *pending = mPending.exchange(nullptr, std::memory_order_acquire);
+    while (pending) {
+        PendingText *next = pending->next;
+        delete pending;
+        pending = next;
+    }
+}
+
+void LogView::append(const std::string &text) {
+    if (mPendingCount.fetch_add(1, std::memory_order_relaxed) >=
+        mPendingLimit.load(std::memory_order_relaxed)) {
+        mPendingCount.fetch_sub(1, std::memory_order_relaxed);
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    PendingText *pending = new PendingText { text, nullptr };
+    PendingText *head = mPending.load(std::memory_order_relaxed);
+    do {
+        pending->next = head;
+    } while (!mPending.compare_exchange_weak(head, pending, std::memory_order_release,
+                                             std::memory_order_relaxed));
+
+    /* Only the first submission after a drain wakes up the UI thread */
+    if (head)
+        return;
+    std::function<void()> callback;
+    {
+        std::lock_guard<std::mutex> guard(mFilterMutex);
+        callback = mDataCallback;
+    }
+    if (callback)
+        callback();
+}
+
+void LogView::setDataCallback(const std::function<void()> &callback) {
+    std::lock_guard<std::mutex> guard(mFilterMutex);
+    mDataCallback = callback;
+}
+
+void LogView::setMaxLines(size_t maxLines) {
+    drainPending();
+    maxLines = std::max(maxLines, (size_t) 1);
+    size_t keep = std::min(mLineCount, maxLines);
+    std::vector<Line> lines(maxLines);
+    uint64_t first = mFirstLine + mLineCount - keep;
+    for (uint64_t i = first; i < first + keep; ++i)
+        lines[(size_t) (i % maxLines)] = std::move(lineAt(i));
+    mLines.swap(lines);
+    mPendingLimit.store(maxLines, std::memory_order_relaxed);
+    mFirstLine = first;
+    mLineCount = keep;
+    while (!mMatches.empty() && mMatches.front() < mFirstLine)
+        mMatches.pop_front();
+}
+
+void LogView::clear() {
+    drainPending();
+    for (Line &line : mLines)
+        line = Line { nullptr, -1.f };
+    mFirstLine += mLineCount;
+    mLineCount = 0;
+    mMaxLineWidth = 0.f;
+    mMatches.clear();
+    mScrollOffset = Vector2i::Zero();
+
+    std::lock_guard<std::mutex> guard(mFilterMutex);
+    mFilterGeneration++;
+    mFilterQueue.clear();
+    mFilterResults.clear();
+}
+
+void LogView::setFilter(const std::string &filter) {
+    drainPending();
+    mFilter = filter;
+    mMatches.clear();
+
+    {
+        std::lock_guard<std::mutex> guard(mFilterMutex);
+        mFilterGeneration++;
+        mFilterQueue.clear();
+        mFilterResults.clear();
+        mFilterPattern = filter;
+        for (char &c : mFilterPattern)
+            c = foldCase(c);
+        if (!filter.empty())
+            for (uint64_t i = mFirstLine; i < mFirstLine + mLineCount; ++i)
+                mFilterQueue.push_back(FilterItem { i, lineAt(i).text });
+    }
+
+    if (!filter.empty()) {
+        if (!mFilterThread.joinable())
+            mFilterThread = std::thread([this]() { filterThread(); });
+        mFilterCondition.notify_one();
+    }
+    if (!mFollowTail)
+        mScrollOffset.y() = 0;
+}
+
+bool LogView::filtering() const {
+    std::lock_guard<std::mutex> guard(mFilterMutex);
+    return mFilterBusy || !mFilterQueue.empty();
+}
+
+void LogView::setScrollOffset(const Vector2i &offset) {
+    int maxY = std::max(contentHeight() - mSize.y(), 0);
+    int maxX = std::max((int) std::ceil(mMaxLineWidth) + 2 * TextPadding + 12 - mSize.x(), 0);
+    mScrollOffset = Vector2i(std::max(0, std::min(offset.x(), maxX)),
+                             std::max(0, std::min(offset.y(), maxY)));
+    mFollowTail = mScrollOffset.y() == maxY;
+}
+
+Vector2i LogView::preferredSize(NVGcontext *) const {
+    return Vector2i(400, 15 * lineHeight() + 2 * TextPadding);
+}
+
+bool LogView::mouseButtonEvent(const Vector2i &p, int button, bool down,
+                               int modifiers) {
+    if (button == NG_MOUSE_BUTTON_1 && down && p.x() - mPos.x() >= mSize.x() - 14 &&
+        contentHeight() > mSize.y()) {
+        mDragScrollbar = true;
+        return true;
+    }
+    if (!down)
+        mDragScrollbar = false;
+    return Widget::mouseButtonEvent(p, button, down, modifiers);
+}
+
+bool LogView::mouseDragEvent(const Vector2i &, const Vector2i &rel,
+                             int /* button */, int /* modifiers */) {
+    if (!mDragScrollbar)
+        return false;
+    int content = contentHeight();
+    float length = (float) mSize.y() - 8;
+    float thumb = length * std::min(1.0f, mSize.y() / (float) content);
+    float delta = rel.y() / std::max(length - thumb, 1.0f);
+    setScrollOffset(Vector2i(mScrollOffset.x(), mScrollOffset.y() +
+        (int) std::round(delta * (content - mSize.y()))));
+    return true;
+}
+
+bool LogView::scrollEvent(const Vector2i &, const Vector2f &rel) {
+    setScrollOffset(mScrollOffset -
+        Vector2i((int) std::round(rel.x() * 3 * lineHeight()),
+                 (int) std::round(rel.y() * 3 * lineHeight())));
+    return true;
+}
+
+bool LogView::needsRedraw() {
+    if (mPending.load(std::memory_order_relaxed))
+        return true;
+    if (mFilter.empty())
+        return false;
+    std::lock_guard<std::mutex> guard(mFilterMutex);
+    return !mFilterResults.empty();
+}
+
+void LogView::draw(NVGcontext *ctx) {
+    Widget::draw(ctx);
+    drainPending();
+    collectMatches();
+
+    if (mFollowTail)
+        mScrollOffset.y() = std::max(contentHeight() - mSize.y(), 0);
+    else
+        setScrollOffset(mScrollOffset);
+
+    int lineh = lineHeight();
+    size_t rows = visibleLineCount();
+    size_t firstRow = (size_t) std::max(mScrollOffset.y() - TextPadding, 0) / lineh;
+    size_t lastRow = std::min(rows,
+        (size_t) (mScrollOffset.y() - TextPadding + mSize.y() + lineh - 1) / lineh);
+
+    nvgSave(ctx);
+    nvgTranslate(ctx, mPos.x(), mPos.y());
+    nvgIntersectScissor(ctx, 0, 0, mSize.x(), mSize.y());
+
+    nvgBeginPath(ctx);
+    nvgRect(ctx, 0, 0, mSize.x(), mSize.y());
+    nvgFillColor(ctx, Color(0, 32));
+    nvgFill(ctx);
+
+    nvgFontFace(ctx, "sans");
+    nvgFontSize(ctx, fontSize());
+    nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+    nvgFillColor(ctx, mEnabled ? mTheme->mTextColor : mTheme->mDisabledTextColor);
+
+    float x = (float) (TextPadding - mScrollOffset.x());
+    for (size_t row = firstRow; row < lastRow; ++row) {
+        Line &line = lineAt(rowLine(row));
+        const std::string &text = *line.text;
+        if (line.width < 0) {
+            line.width = text.empty() ? 0.f :
+                nvgTextBounds(ctx, 0, 0, text.data(), text.data() + text.size(), nullptr);
+            mMaxLineWidth = std::max(mMaxLineWidth, line.width);
+        }
+        if (text.empty() || x + line.width < 0)
+            continue;
+        float y = (float) (TextPadding + (int) row * lineh - mScrollOffset.y()) + lineh * 0.5f;
+        nvgText(ctx, x, y, text.data(), text.data() + text.size());
+    }
+
+    /* Scroll bar */
+    int content = contentHeight();
+    if (content > mSize.y()) {
+        float length = (float) mSize.y() - 8;
+        float thumb = length * std::min(1.0f, mSize.y() / (float) content);
+        drawScrollBar(ctx, mSize.x() - 12.f, 4.f, length, thumb,
+                      mScrollOffset.y() / (float) std::max(content - mSize.y(), 1), true);
+    }
+    nvgRestore(ctx);
+}
+
+void LogView::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("maxLines", (uint64_t) mLines.size());
+    s.set("filter", mFilter);
+    s.set("followTail", mFollowTail);
+}
+
+bool LogView::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    uint64_t maxLines;
+    std::string filter;
+    if (!s.get("maxLines", maxLines)) return false;
+    if (!s.get("filter", filter)) return false;
+    if (!s.get("followTail", mFollowTail)) return false;
+    setMaxLines((size_t) maxLines);
+    setFilter(filter);
+    return true;
+}
+
+void LogView::drainPending() {
+    PendingText *pending = mPending.exchange(nullptr, std::memory_order_acquire);
+    if (!pending)
+        return;
+
+    /* The list holds the most recent submission first: reverse it */
+    PendingText *ordered = nullptr;
+    size_t count = 0;
+    while (pending) {
+        PendingText *next = pending->next;
+        pending->next = ordered;
+        ordered = pending;
+        pending = next;
+        ++count;
+    }
+    mPendingCount.fetch_sub(count, std::memory_order_relaxed);
+
+    uint64_t previousFirst = mFirstLine;
+    std::vector<FilterItem> filterItems;
+    while (ordered) {
+        const std::string &text = ordered->text;
+        size_t start = 0;
+        do {
+            size_t end = text.find('\n', start);
+            if (end == std::string::npos)
+                end = text.size();
+            addLine(text.substr(start, end - start), filterItems);
+            start = end + 1;
+        } while (start < text.size());
+        PendingText *next = ordered->next;
+        delete ordered;
+        ordered = next;
+    }
+
+    if (mFilter.empty()) {
+        /* Keep the view in place when lines scroll out at the top */
+        if (!mFollowTail)
+            mScrollOffset.y() -= (int) (mFirstLine - previousFirst) * lineHeight();
+    } else {
+        size_t matches = mMatches.size();
+        while (!mMatches.empty() && mMatches.front() < mFirstLine)
+            mMatches.pop_front();
+        if (!mFollowTail)
+            mScrollOffset.y() -= (int) (matches - mMatches.size()) * lineHeight();
+
+        std::lock_guard<std::mutex> guard(mFilterMutex);
+        for (FilterItem &item : filterItems)
+            mFilterQueue.push_back(std::move(item));
+        mFilterCondition.notify_one();
+    }
+    mScrollOffset.y() = std::max(mScrollOffset.y(), 0);
+}
+
+void LogView::addLine(std::string &&text, std::vector<FilterItem> &filterItems) {
+    if (mLineCount == mLines.size()) {
+        mFirstLine++;
+        mLineCount--;
+    }
+    uint64_t index = mFirstLine + mLineCount++;
+    Line &line = lineAt(index);
+    line.text = std::make_shared<const std::string>(std::move(text));
+    line.width = -1.f;
+    if (!mFilter.empty())
+        filterItems.push_back(FilterItem { index, line.text });
+}
+
+void LogView::collectMatches() {
+    if (mFilter.empty())
+        return;
+    std::vector<uint64_t> results;
+    {
+        std::lock_guard<std::mutex> guard(mFilterMutex);
+        results.swap(mFilterResults);
+    }
+    for (uint64_t index : results)
+        if (index >= mFirstLine)
+            mMatches.push_back(index);
+}
+
+int LogView::contentHeight() const {
+    return (int) visibleLineCount() * lineHeight() + 2 * TextPadding;
+}
+
+void LogView::filterThread() {
+    std::unique_lock<std::mutex> lock(mFilterMutex);
+    while (true) {
+        mFilterCondition.wait(lock, [this]() { return mFilterStop || !mFilterQueue.empty(); });
+        if (mFilterStop)
+            return;
+
+        uint64_t generation = mFilterGeneration;
+        std::string pattern = mFilterPattern;
+        size_t count = std::min(mFilterQueue.size(), FilterChunkSize);
+        std::vector<FilterItem> chunk(std::make_move_iterator(mFilterQueue.begin()),
+                                      std::make_move_iterator(mFilterQueue.begin() + count));
+        mFilterQueue.erase(mFilterQueue.begin(), mFilterQueue.begin() + count);
+        mFilterBusy = true;
+        lock.unlock();
+
+        std::vector<uint64_t> matches;
+        for (const FilterItem &item : chunk)
+            if (containsFolded(*item.text, pattern))
+                matches.push_back(item.index);
+        chunk.clear();
+
+        lock.lock();
+        mFilterBusy = false;
+        if (generation != mFilterGeneration || matches.empty())
+            continue;
+        mFilterResults.insert(mFilterResults.end(), matches.begin(), matches.end());
+        std::function<void()> callback = mDataCallback;
+        if (callback) {
+            lock.unlock();
+            callback();
+            lock.lock();
+        }
+    }
+}
+
+NAMESPACE_END(nanogui)
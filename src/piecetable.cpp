@@ -0,0 +1,398 @@
+/*
+    src/piecetable.cpp -- Text buffer with logarithmic-time edits and
+    line lookups, and an undo history that does not copy text
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/piecetable.h>
+#include <algorithm>
+
+NAMESPACE_BEGIN(nanogui)
+
+PieceTable::PieceTable() : mRoot(-1), mRandomState(0x9E3779B9u), mRevision(0) { }
+
+void PieceTable::setText(const std::string &text) {
+    mNodes.clear();
+    mFreeNodes.clear();
+    mRoot = -1;
+    for (int i = 0; i < 2; ++i) {
+        mBuffers[i].clear();
+        mNewlines[i].clear();
+    }
+    appendToBuffer(0, text);
+    if (!text.empty())
+        mRoot = createNode(Piece { 0, 0, text.size() });
+    clearHistory();
+    mRevision++;
+}
+
+std::string PieceTable::text(size_t offset, size_t length) const {
+    std::string result;
+    offset = std::min(offset, this->length());
+    length = std::min(length, this->length() - offset);
+    result.reserve(length);
+    extract(mRoot, offset, length, result);
+    return result;
+}
+
+size_t PieceTable::length() const {
+    return mRoot < 0 ? 0 : mNodes[mRoot].totalLength;
+}
+
+size_t PieceTable::lineCount() const {
+    return 1 + (mRoot < 0 ? 0 : mNodes[mRoot].totalNewlines);
+}
+
+size_t PieceTable::lineStart(size_t line) const {
+    if (line == 0)
+        return 0;
+    if (line >= lineCount())
+        return length();
+    return findNewline(line) + 1;
+}
+
+size_t PieceTable::lineEnd(size_t line) const {
+    if (line + 1 >= lineCount())
+        return length();
+    return findNewline(line + 1);
+}
+
+size_t PieceTable::lineOf(size_t offset) const {
+    size_t line = 0;
+    int t = mRoot;
+    while (t >= 0) {
+        const Node &node = mNodes[t];
+        size_t leftLength = 0, leftNewlines = 0;
+        if (node.left >= 0) {
+            leftLength = mNodes[node.left].totalLength;
+            leftNewlines = mNodes[node.left].totalNewlines;
+        }
+        if (offset <= leftLength) {
+            t = node.left;
+            continue;
+        }
+        offset -= leftLength;
+        line += leftNewlines;
+        if (offset <= node.piece.length)
+            return line + newlinesIn(node.piece.buffer, node.piece.start, offset);
+        offset -= node.piece.length;
+        line += node.newlines;
+        t = node.right;
+    }
+    return line;
+}
+
+void PieceTable::replace(size_t offset, size_t length, const std::string &text,
+                         bool mergeUndo) {
+    offset = std::min(offset, this->length());
+    length = std::min(length, this->length() - offset);
+    if (length == 0 && text.empty())
+        return;
+
+    std::vector<Piece> removed;
+    if (length > 0)
+        removed = removeRange(offset, length);
+
+    Piece piece { 1, mBuffers[1].size(), text.size() };
+    if (!text.empty()) {
+        appendToBuffer(1, text);
+        /* Typing appends to the add buffer right behind the previous piece:
+           grow that piece instead of fragmenting the text */
+        if (!extend(mRoot, offset, text.size()))
+            insertPieces(offset, { piece });
+    }
+
+    mRedo.clear();
+    mRevision++;
+
+    if (mergeUndo && length == 0 && !mUndo.empty()) {
+        Edit &last = mUndo.back();
+        if (last.removed.empty() && !last.inserted.empty() &&
+            last.offset + totalLength(last.inserted) == offset) {
+            Piece &prev = last.inserted.back();
+            if (prev.buffer == 1 && prev.start + prev.length == piece.start)
+                prev.length += piece.length;
+            else
+                last.inserted.push_back(piece);
+            return;
+        }
+    }
+
+    Edit edit;
+    edit.offset = offset;
+    edit.removed = std::move(removed);
+    if (!text.empty())
+        edit.inserted.push_back(piece);
+    mUndo.push_back(std::move(edit));
+}
+
+bool PieceTable::undo(size_t *cursor) {
+    if (mUndo.empty())
+        return false;
+    Edit edit = std::move(mUndo.back());
+    mUndo.pop_back();
+    size_t inserted = totalLength(edit.inserted);
+    if (inserted > 0)
+        release(removeRangeTree(edit.offset, inserted));
+    insertPieces(edit.offset, edit.removed);
+    if (cursor)
+        *cursor = edit.offset + totalLength(edit.removed);
+    mRedo.push_back(std::move(edit));
+    mRevision++;
+    return true;
+}
+
+bool PieceTable::redo(size_t *cursor) {
+    if (mRedo.empty())
+        return false;
+    Edit edit = std::move(mRedo.back());
+    mRedo.pop_back();
+    size_t removed = totalLength(edit.removed);
+    if (removed > 0)
+        release(removeRangeTree(edit.offset, removed));
+    insertPieces(edit.offset, edit.inserted);
+    if (cursor)
+        *cursor = edit.offset + totalLength(edit.inserted);
+    mUndo.push_back(std::move(edit));
+    mRevision++;
+    return true;
+}
+
+size_t PieceTable::newlinesIn(uint32_t buffer, size_t start, size_t length) const {
+    const std::vector<size_t> &newlines = mNewlines[buffer];
+    auto begin = std::lower_bound(newlines.begin(), newlines.end(), start);
+    auto end = std::lower_bound(begin, newlines.end(), start + length);
+    return (size_t) (end - begin);
+}
+
+size_t PieceTable::findNewline(size_t k) const {
+    size_t base = 0;
+    int t = mRoot;
+    while (t >= 0) {
+        const Node &node = mNodes[t];
+        size_t leftLength = 0, leftNewlines = 0;
+        if (node.left >= 0) {
+            leftLength = mNodes[node.left].totalLength;
+            leftNewlines = mNodes[node.left].totalNewlines;
+        }
+        if (k <= leftNewlines) {
+            t = node.left;
+            continue;
+        }
+        k -= leftNewlines;
+        base += leftLength;
+        if (k <= node.newlines) {
+            const std::vector<size_t> &newlines = mNewlines[node.piece.buffer];
+            auto first = std::lower_bound(newlines.begin(), newlines.end(), node.piece.start);
+            return base + first[k - 1] - node.piece.start;
+        }
+        k -= node.newlines;
+        base += node.piece.length;
+        t = node.right;
+    }
+    return base;
+}
+
+void PieceTable::appendToBuffer(uint32_t buffer, const std::string &text) {
+    std::string &data = mBuffers[buffer];
+    size_t offset = data.size();
+    data += text;
+    for (size_t i = 0; i < text.size(); ++i)
+        if (text[i] == '\n')
+            mNewlines[buffer].push_back(offset + i);
+}
+
+int PieceTable::createNode(const Piece &piece) {
+    /* xorshift32: treap priorities only need to look random */
+    mRandomState ^= mRandomState << 13;
+    mRandomState ^= mRandomState >> 17;
+    mRandomState ^= mRandomState << 5;
+
+    int index;
+    if (!mFreeNodes.empty()) {
+        index = mFreeNodes.back();
+        mFreeNodes.pop_back();
+    } else {
+        index = (int) mNodes.size();
+        mNodes.emplace_back();
+    }
+    Node &node = mNodes[index];
+    node.piece = piece;
+    node.newlines = newlinesIn(piece.buffer, piece.start, piece.length);
+    node.left = node.right = -1;
+    node.priority = mRandomState;
+    update(index);
+    return index;
+}
+
+void PieceTable::update(int t) {
+    Node &node = mNodes[t];
+    node.totalLength = node.piece.length;
+    node.totalNewlines = node.newlines;
+    if (node.left >= 0) {
+        node.totalLength += mNodes[node.left].totalLength;
+        node.totalNewlines += mNodes[node.left].totalNewlines;
+    }
+    if (node.right >= 0) {
+        node.totalLength += mNodes[node.right].totalLength;
+        node.totalNewlines += mNodes[node.right].totalNewlines;
+    }
+}
+
+int PieceTable::merge(int a, int b) {
+    if (a < 0)
+        return b;
+    if (b < 0)
+        return a;
+    if (mNodes[a].priority > mNodes[b].priority) {
+        mNodes[a].right = merge(mNodes[a].right, b);
+        update(a);
+        return a;
+    } else {
+        mNodes[b].left = merge(a, mNodes[b].left);
+        update(b);
+        return b;
+    }
+}
+
+void PieceTable::split(int t, size_t offset, int &left, int &right) {
+    if (t < 0) {
+        left = right = -1;
+        return;
+    }
+    size_t leftLength = mNodes[t].left < 0 ? 0 : mNodes[mNodes[t].left].totalLength;
+    size_t pieceLength = mNodes[t].piece.length;
+    int l, r;
+    if (offset <= leftLength) {
+        split(mNodes[t].left, offset, l, r);
+        mNodes[t].left = r;
+        update(t);
+        left = l;
+        right = t;
+    } else if (offset >= leftLength + pieceLength) {
+        split(mNodes[t].right, offset - leftLength - pieceLength, l, r);
+        mNodes[t].right = l;
+        update(t);
+        left = t;
+        right = r;
+    } else {
+        /* The cut falls inside this piece: divide it in two */
+        size_t cut = offset - leftLength;
+        Piece tail = mNodes[t].piece;
+        tail.start += cut;
+        tail.length -= cut;
+        int tailNode = createNode(tail);
+
+        Node &node = mNodes[t];
+        node.piece.length = cut;
+        node.newlines -= mNodes[tailNode].newlines;
+        right = merge(tailNode, node.right);
+        mNodes[t].right = -1;
+        update(t);
+        left = t;
+    }
+}
+
+void PieceTable::collect(int t, std::vector<Piece> &pieces) const {
+    if (t < 0)
+        return;
+    collect(mNodes[t].left, pieces);
+    pieces.push_back(mNodes[t].piece);
+    collect(mNodes[t].right, pieces);
+}
+
+void PieceTable::release(int t) {
+    if (t < 0)
+        return;
+    release(mNodes[t].left);
+    release(mNodes[t].right);
+    mFreeNodes.push_back(t);
+}
+
+void PieceTable::extract(int t, size_t offset, size_t length, std::string &out) const {
+    if (t < 0 || length == 0)
+        return;
+    const Node &node = mNodes[t];
+    size_t leftLength = node.left < 0 ? 0 : mNodes[node.left].totalLength;
+    if (offset < leftLength)
+        extract(node.left, offset, length, out);
+
+    size_t begin = std::max(offset, leftLength);
+    size_t end = std::min(offset + length, leftLength + node.piece.length);
+    if (begin < end)
+        out.append(mBuffers[node.piece.buffer], node.piece.start + begin - leftLength,
+                   end - begin);
+
+    size_t rightStart = leftLength + node.piece.length;
+    if (offset + length > rightStart) {
+        size_t skip = offset > rightStart ? offset - rightStart : 0;
+        extract(node.right, skip, offset + length - rightStart - skip, out);
+    }
+}
+
+bool PieceTable::extend(int t, size_t offset, size_t count) {
+    if (t < 0)
+        return false;
+    Node &node = mNodes[t];
+    size_t leftLength = node.left < 0 ? 0 : mNodes[node.left].totalLength;
+    bool extended;
+    if (offset <= leftLength) {
+        extended = extend(node.left, offset, count);
+    } else if (offset < leftLength + node.piece.length) {
+        return false;
+    } else if (offset == leftLength + node.piece.length) {
+        Piece &piece = node.piece;
+        if (piece.buffer != 1 || piece.start + piece.length + count != mBuffers[1].size())
+            return false;
+        node.newlines += newlinesIn(1, piece.start + piece.length, count);
+        piece.length += count;
+        extended = true;
+    } else {
+        extended = extend(node.right, offset - leftLength - node.piece.length, count);
+    }
+    if (extended)
+        update(t);
+    return extended;
+}
+
+std::vector<PieceTable::Piece> PieceTable::removeRange(size_t offset, size_t length) {
+    std::vector<Piece> pieces;
+    int middle = removeRangeTree(offset, length);
+    collect(middle, pieces);
+    release(middle);
+    return pieces;
+}
+
+int PieceTable::removeRangeTree(size_t offset, size_t length) {
+    int left, middle, right;
+    split(mRoot, offset, left, right);
+    split(right, length, middle, right);
+    mRoot = merge(left, right);
+    return middle;
+}
+
+void PieceTable::insertPieces(size_t offset, const std::vector<Piece> &pieces) {
+    if (pieces.empty())
+        return;
+    int middle = -1;
+    for (const Piece &piece : pieces)
+        middle = merge(middle, createNode(piece));
+    int left, right;
+    split(mRoot, offset, left, right);
+    mRoot = merge(merge(left, middle), right);
+}
+
+size_t PieceTable::totalLength(const std::vector<Piece> &pieces) {
+    size_t length = 0;
+    for (const Piece &piece : pieces)
+        length += piece.length;
+    return length;
+}
+
+NAMESPACE_END(nanogui)
@@ -37,7 +37,7 @@ void Popup::performLayout(NVGcontext *ctx) {
 void Popup::refreshRelativePlacement() {
     mParentWindow->refreshRelativePlacement();
     mVisible &= mParentWindow->visibleRecursive();
-    mPos = mParentWindow->position() + mAnchorPos - Vector2i(0, mAnchorHeight);
+    setPosition(mParentWindow->position() + mAnchorPos - Vector2i(0, mAnchorHeight));
 }
 
 void Popup::draw(NVGcontext* ctx) {
@@ -0,0 +1,128 @@
+/*
+    nanogui/rendercanvas.cpp -- Canvas widget rendering bgfx content into
+    an offscreen framebuffer, which is drawn as a NanoVG image. Subclass it
+    and overload `drawCanvas` for rendering.
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/rendercanvas.h>
+#include <nanogui/screen.h>
+#include <nanogui/theme.h>
+#include <nanogui/opengl.h>
+#include <nanogui/serializer/core.h>
+#include "nanovg_bgfx.h"
+#include <cmath>
+
+NAMESPACE_BEGIN(nanogui)
+
+RenderCanvas::RenderCanvas(Widget *parent)
+  : Widget(parent), mBackgroundColor(Vector4i(128, 128, 128, 255)),
+    mDrawBorder(true), mRenderScale(1.f), mFramebuffer(nullptr),
+    mFramebufferSize(Vector2i::Zero()), mViewId(-1), mScreen(nullptr) {
+    mSize = Vector2i(250, 250);
+}
+
+RenderCanvas::~RenderCanvas() {
+    releaseFramebuffer();
+}
+
+void RenderCanvas::releaseFramebuffer() {
+    if (mFramebuffer) {
+        nvgluDeleteFramebuffer(mFramebuffer);
+        mFramebuffer = nullptr;
+    }
+    if (mViewId >= 0) {
+        bgfx::FrameBufferHandle invalid = BGFX_INVALID_HANDLE;
+        bgfx::setViewFrameBuffer((uint8_t) mViewId, invalid);
+        mScreen->releaseViewId((uint8_t) mViewId);
+        mViewId = -1;
+    }
+    mFramebufferSize = Vector2i::Zero();
+}
+
+void RenderCanvas::drawWidgetBorder(NVGcontext *ctx) const {
+    nvgBeginPath(ctx);
+    nvgStrokeWidth(ctx, 1.0f);
+    nvgRoundedRect(ctx, mPos.x() - 0.5f, mPos.y() - 0.5f,
+                   mSize.x() + 1, mSize.y() + 1, mTheme->mWindowCornerRadius);
+    nvgStrokeColor(ctx, mTheme->mBorderLight);
+    nvgRoundedRect(ctx, mPos.x() - 1.0f, mPos.y() - 1.0f,
+                   mSize.x() + 2, mSize.y() + 2, mTheme->mWindowCornerRadius);
+    nvgStrokeColor(ctx, mTheme->mBorderDark);
+    nvgStroke(ctx);
+}
+
+void RenderCanvas::draw(NVGcontext *ctx) {
+    Widget *root = this;
+    while (root->parent())
+        root = root->parent();
+    Screen *screen = dynamic_cast<Screen *>(root);
+
+    /* Nothing is rendered while the canvas is clipped away */
+    Vector2i visibleSize = clipSize();
+    if (screen && visibleSize.x() > 0 && visibleSize.y() > 0) {
+        if (screen != mScreen) {
+            releaseFramebuffer();
+            mScreen = screen;
+        }
+        if (mViewId < 0)
+            mViewId = screen->acquireViewId();
+        uint8_t viewId = (uint8_t) mViewId;
+
+        Vector2i size = (mSize.cast<float>() * screen->pixelRatio() * mRenderScale)
+            .unaryExpr([](float x) { return std::round(x); }).cast<int>().cwiseMax(1);
+        if (!mFramebuffer || size != mFramebufferSize) {
+            if (mFramebuffer)
+                nvgluDeleteFramebuffer(mFramebuffer);
+            mFramebuffer = nvgluCreateFramebuffer(ctx, size.x(), size.y(),
+                                                  nvgluFramebufferImageFlags(), viewId);
+            if (!mFramebuffer)
+                throw std::runtime_error("RenderCanvas: could not create the framebuffer!");
+            mFramebufferSize = size;
+        }
+
+        Vector4i rgba = (mBackgroundColor * 255.f).unaryExpr([](float x) {
+            return std::round(std::min(std::max(x, 0.f), 255.f)); }).cast<int>();
+        bgfx::setViewRect(viewId, 0, 0, (uint16_t) size.x(), (uint16_t) size.y());
+        bgfx::setViewClear(viewId, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH | BGFX_CLEAR_STENCIL,
+                           ((uint32_t) rgba[0] << 24) | ((uint32_t) rgba[1] << 16) |
+                           ((uint32_t) rgba[2] << 8) | (uint32_t) rgba[3], 1.0f, 0);
+        bgfx::touch(viewId);
+        drawCanvas(viewId, size);
+
+        NVGpaint paint = nvgImagePattern(ctx, mPos.x(), mPos.y(), mSize.x(), mSize.y(),
+                                         0, mFramebuffer->image, 1.0f);
+        nvgBeginPath(ctx);
+        nvgRect(ctx, mPos.x(), mPos.y(), mSize.x(), mSize.y());
+        nvgFillPaint(ctx, paint);
+        nvgFill(ctx);
+    }
+
+    Widget::draw(ctx);
+
+    if (mDrawBorder)
+        drawWidgetBorder(ctx);
+}
+
+void RenderCanvas::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("backgroundColor", mBackgroundColor);
+    s.set("drawBorder", mDrawBorder);
+    s.set("renderScale", mRenderScale);
+}
+
+bool RenderCanvas::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    if (!s.get("backgroundColor", mBackgroundColor)) return false;
+    if (!s.get("drawBorder", mDrawBorder)) return false;
+    if (!s.get("renderScale", mRenderScale)) return false;
+    return true;
+}
+
+NAMESPACE_END(nanogui)
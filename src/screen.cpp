@@ -31,9 +31,17 @@
 #include "nanovg_bgfx.h"
 
 #define NANOVG_VIEW_ID 255
+/* Lowest view id handed out by Screen::acquireViewId() */
+#define MIN_OFFSCREEN_VIEW_ID 128
 
 NAMESPACE_BEGIN(nanogui)
 
+/* Invalidate the layers of the windows on a focus path */
+static void invalidateFocusLayers(const std::vector<Widget *> &path) {
+    if (!path.empty())
+        path.front()->invalidateLayers();
+}
+
 /* Calculate pixel ratio for hi-dpi devices. */
 static float get_pixel_ratio(void *window) {
     return 1.0f;
@@ -42,7 +50,7 @@ static float get_pixel_ratio(void *window) {
 Screen::Screen()
     : Widget(nullptr), mPlatformWindow(nullptr), mNVGContext(nullptr),
       mCursor(Cursor::Arrow), mBackground(0.3f, 0.3f, 0.32f, 1.f),
-      mFullscreen(false) {
+      mFullscreen(false), mCulledWidgets(0), mFrameCulledWidgets(0), mNextViewId(NANOVG_VIEW_ID - 1) {
 }
 
 void Screen::initialize(void *window) {
@@ -51,6 +59,7 @@ void Screen::initialize(void *window) {
 
     ngGetWindowSize(mPlatformWindow, &mSize[0], &mSize[1]);
     ngGetFramebufferSize(mPlatformWindow, &mFBSize[0], &mFBSize[1]);
+    invalidateGeometry();
 
     mNVGContext = nvgCreate(1,NANOVG_VIEW_ID);
     bgfx::setViewSeq(NANOVG_VIEW_ID,true);
@@ -66,6 +75,10 @@ void Screen::initialize(void *window) {
 }
 
 Screen::~Screen() {
+    /* Release the widgets before the NanoVG context, as some of them own NanoVG images */
+    while (childCount() > 0)
+        removeChild(childCount() - 1);
+    mImageLoader.reset();
     if (mNVGContext)
         nvgDelete(mNVGContext);
 }
@@ -83,6 +96,7 @@ void Screen::drawWidgets() {
 
     ngMakeContextCurrent(mPlatformWindow);
 
+    Vector2i prevSize = mSize;
     ngGetFramebufferSize(mPlatformWindow, &mFBSize[0], &mFBSize[1]);
     ngGetWindowSize(mPlatformWindow, &mSize[0], &mSize[1]);
 
@@ -95,11 +109,31 @@ void Screen::drawWidgets() {
         mPixelRatio = (float) mFBSize[0] / (float) mSize[0];
 #endif
 
+    if (mSize != prevSize)
+        invalidateGeometry();
+
 //    glViewport(0, 0, mFBSize[0], mFBSize[1]);
 //    glBindSampler(0, 0);
+    /* The layers of the cached windows may show the placeholders of the uploaded images */
+    if (mImageLoader && mImageLoader->update())
+        for (auto child : mChildren)
+            child->invalidateLayers();
+
+    mFrameCulledWidgets = 0;
+    sDrawingScreen = this;
+
+    /* Render the out of date layers of the cached windows, which the frame composites */
+    for (auto child : mChildren) {
+        Window *window = dynamic_cast<Window *>(child);
+        if (window)
+            window->renderLayer(mNVGContext);
+    }
+
     nvgBeginFrame(mNVGContext, mSize[0], mSize[1], mPixelRatio);
 
     draw(mNVGContext);
+    sDrawingScreen = nullptr;
+    mCulledWidgets = mFrameCulledWidgets;
 
     double elapsed = ngGetTime() - mLastInteraction;
 
@@ -153,6 +187,7 @@ void Screen::drawWidgets() {
 }
 
 bool Screen::keyboardEvent(int key, int scancode, int action, int modifiers) {
+    invalidateFocusLayers(mFocusPath);
     if (mFocusPath.size() > 0) {
         for (auto it = mFocusPath.rbegin() + 1; it != mFocusPath.rend(); ++it)
             if ((*it)->focused() && (*it)->keyboardEvent(key, scancode, action, modifiers))
@@ -163,6 +198,7 @@ bool Screen::keyboardEvent(int key, int scancode, int action, int modifiers) {
 }
 
 bool Screen::keyboardCharacterEvent(unsigned int codepoint) {
+    invalidateFocusLayers(mFocusPath);
     if (mFocusPath.size() > 0) {
         for (auto it = mFocusPath.rbegin() + 1; it != mFocusPath.rend(); ++it)
             if ((*it)->focused() && (*it)->keyboardCharacterEvent(codepoint))
@@ -190,6 +226,9 @@ bool Screen::cursorPosCallbackEvent(double x, double y) {
                 ngSetCursor(mPlatformWindow,mCursor);
             }
         } else {
+            /* Dragging a window moves its layer, dragging a widget changes it */
+            if (!dynamic_cast<Window *>(mDragWidget))
+                mDragWidget->invalidateLayers();
             ret = mDragWidget->mouseDragEvent(
                 p - mDragWidget->parent()->absolutePosition(), p - mMousePos,
                 mMouseState, mModifiers);
@@ -227,10 +266,12 @@ bool Screen::mouseButtonCallbackEvent(int button, int action, int modifiers) {
 
         auto dropWidget = findWidget(mMousePos);
         if (mDragActive && action == NG_RELEASE &&
-            dropWidget != mDragWidget)
+            dropWidget != mDragWidget) {
+            mDragWidget->invalidateLayers();
             mDragWidget->mouseButtonEvent(
                 mMousePos - mDragWidget->parent()->absolutePosition(), button,
                 false, mModifiers);
+        }
 
         if (dropWidget != nullptr && dropWidget->cursor() != mCursor) {
             mCursor = dropWidget->cursor();
@@ -317,6 +358,7 @@ bool Screen::resizeCallbackEvent(int, int) {
         return false;
 
     mFBSize = fbSize; mSize = size;
+    invalidateGeometry();
     mLastInteraction = ngGetTime();
 
     try {
@@ -328,7 +370,29 @@ bool Screen::resizeCallbackEvent(int, int) {
     }
 }
 
+ImageLoader *Screen::imageLoader() {
+    if (!mImageLoader)
+        mImageLoader.reset(new ImageLoader(mNVGContext));
+    return mImageLoader.get();
+}
+
+uint8_t Screen::acquireViewId() {
+    if (!mFreeViewIds.empty()) {
+        uint8_t viewId = mFreeViewIds.back();
+        mFreeViewIds.pop_back();
+        return viewId;
+    }
+    if (mNextViewId < MIN_OFFSCREEN_VIEW_ID)
+        throw std::runtime_error("Screen::acquireViewId(): no bgfx view left!");
+    return (uint8_t) mNextViewId--;
+}
+
+void Screen::releaseViewId(uint8_t viewId) {
+    mFreeViewIds.push_back(viewId);
+}
+
 void Screen::updateFocus(Widget *widget) {
+    invalidateFocusLayers(mFocusPath);
     for (auto w: mFocusPath) {
         if (!w->focused())
             continue;
@@ -344,6 +408,7 @@ void Screen::updateFocus(Widget *widget) {
     }
     for (auto it = mFocusPath.rbegin(); it != mFocusPath.rend(); ++it)
         (*it)->focusEvent(true);
+    invalidateFocusLayers(mFocusPath);
 
     if (window)
         moveWindowToFront((Window *) window);
@@ -368,6 +433,7 @@ void Screen::centerWindow(Window *window) {
 void Screen::moveWindowToFront(Window *window) {
     mChildren.erase(std::remove(mChildren.begin(), mChildren.end(), window), mChildren.end());
     mChildren.push_back(window);
+    mSpatialIndexDirty = true;
     /* Brute force topological sort (no problem for a few windows..) */
     bool changed = false;
     do {
@@ -0,0 +1,95 @@
+/*
+    src/spatialindex.cpp -- Uniform grid over the children of a widget,
+    used to accelerate hit testing
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/spatialindex.h>
+#include <nanogui/widget.h>
+#include <algorithm>
+#include <cmath>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Upper bound on the number of cells per axis */
+static const int MaxCellsPerAxis = 1024;
+
+SpatialIndex::SpatialIndex()
+    : mOrigin(Vector2i::Zero()), mCellSize(Vector2i::Ones()),
+      mDim(Vector2i::Zero()) { }
+
+void SpatialIndex::build(const std::vector<Widget *> &widgets) {
+    mCellStart.clear();
+    mEntries.clear();
+    mDim = Vector2i::Zero();
+    if (widgets.empty())
+        return;
+
+    /* Bounding box of all widgets (hidden ones included, since visibility
+       may change without the index being rebuilt) */
+    Vector2i minPos = widgets[0]->position(), maxPos = minPos;
+    for (const Widget *w : widgets) {
+        minPos = minPos.cwiseMin(w->position());
+        maxPos = maxPos.cwiseMax(w->position() + w->size());
+    }
+    Vector2i extent = (maxPos - minPos).cwiseMax(Vector2i::Ones());
+
+    /* Aim for roughly one widget per cell */
+    float area = (float) extent.x() * (float) extent.y();
+    int cellSize = std::max(1, (int) std::ceil(std::sqrt(area / widgets.size())));
+    for (int i = 0; i < 2; ++i) {
+        mCellSize[i] = std::max(cellSize, (extent[i] + MaxCellsPerAxis - 1) / MaxCellsPerAxis);
+        mDim[i] = (extent[i] + mCellSize[i] - 1) / mCellSize[i];
+    }
+    mOrigin = minPos;
+
+    auto cellRange = [&](const Widget *w, Vector2i &c0, Vector2i &c1) {
+        Vector2i p0 = w->position() - mOrigin;
+        Vector2i p1 = p0 + (w->size() - Vector2i::Ones()).cwiseMax(Vector2i::Zero());
+        for (int i = 0; i < 2; ++i) {
+            c0[i] = std::min(std::max(p0[i] / mCellSize[i], 0), mDim[i] - 1);
+            c1[i] = std::min(std::max(p1[i] / mCellSize[i], 0), mDim[i] - 1);
+        }
+    };
+
+    /* Count the entries per cell, convert to offsets, then fill */
+    mCellStart.assign(mDim.x() * mDim.y() + 1, 0);
+    Vector2i c0, c1;
+    for (const Widget *w : widgets) {
+        cellRange(w, c0, c1);
+        for (int y = c0.y(); y <= c1.y(); ++y)
+            for (int x = c0.x(); x <= c1.x(); ++x)
+                mCellStart[y * mDim.x() + x + 1]++;
+    }
+    for (size_t i = 1; i < mCellStart.size(); ++i)
+        mCellStart[i] += mCellStart[i - 1];
+
+    mEntries.resize(mCellStart.back());
+    std::vector<int> fill(mCellStart.begin(), mCellStart.end() - 1);
+    for (int index = 0; index < (int) widgets.size(); ++index) {
+        cellRange(widgets[index], c0, c1);
+        for (int y = c0.y(); y <= c1.y(); ++y)
+            for (int x = c0.x(); x <= c1.x(); ++x)
+                mEntries[fill[y * mDim.x() + x]++] = index;
+    }
+}
+
+SpatialIndex::Range SpatialIndex::query(const Vector2i &p) const {
+    Vector2i rel = p - mOrigin;
+    if (mDim.x() == 0 || rel.x() < 0 || rel.y() < 0)
+        return Range(nullptr, nullptr);
+    int x = rel.x() / mCellSize.x(), y = rel.y() / mCellSize.y();
+    if (x >= mDim.x() || y >= mDim.y())
+        return Range(nullptr, nullptr);
+    const int *entries = mEntries.data();
+    int cell = y * mDim.x() + x;
+    return Range(entries + mCellStart[cell], entries + mCellStart[cell + 1]);
+}
+
+NAMESPACE_END(nanogui)
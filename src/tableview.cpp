@@ -0,0 +1,496 @@
+/*
+    src/tableview.cpp -- Virtualized table with a frozen header that
+    draws its cells directly from columnar data callbacks
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/tableview.h>
+#include <nanogui/theme.h>
+#include <nanogui/opengl.h>
+#include <nanogui/entypo.h>
+#include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <numeric>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Horizontal padding of the cell text */
+static const int CellPadding = 5;
+/* Distance (in pixels) from a header edge that starts a column resize */
+static const int ResizeHandleSize = 3;
+static const int MinColumnWidth = 20;
+
+TableView::TableView(Widget *parent)
+    : Widget(parent), mRowCount(0), mRowHeight(24), mHeaderHeight(26),
+      mSortColumn(-1), mSortAscending(true), mSelectedRow(-1),
+      mScrollOffset(Vector2i::Zero()), mFrame(0), mCacheFontSize(-1),
+      mResizeColumn(-1), mPressedColumn(-1), mDragScrollbar(0) { }
+
+int TableView::addColumn(const std::string &title,
+                         const std::function<std::string(int)> &text, int width) {
+    Column column;
+    column.title = title;
+    column.text = text;
+    column.width = std::max(width, MinColumnWidth);
+    column.alignment = NVG_ALIGN_LEFT;
+    mColumns.push_back(column);
+    return (int) mColumns.size() - 1;
+}
+
+void TableView::setColumnWidth(int column, int width) {
+    mColumns[column].width = std::max(width, MinColumnWidth);
+}
+
+void TableView::setRowCount(int rowCount) {
+    mRowCount = std::max(rowCount, 0);
+    if (mSelectedRow >= mRowCount)
+        mSelectedRow = -1;
+    mCellCache.clear();
+    applySort();
+}
+
+void TableView::sortByColumn(int column, bool ascending) {
+    mSortColumn = column < (int) mColumns.size() ? column : -1;
+    mSortAscending = ascending;
+    applySort();
+}
+
+void TableView::applySort() {
+    mOrder.resize(mRowCount);
+    std::iota(mOrder.begin(), mOrder.end(), 0);
+    if (mSortColumn < 0)
+        return;
+
+    const Column &column = mColumns[mSortColumn];
+    bool ascending = mSortAscending;
+    if (column.comparator) {
+        std::stable_sort(mOrder.begin(), mOrder.end(), [&](int a, int b) {
+            return ascending ? column.comparator(a, b) : column.comparator(b, a);
+        });
+    } else if (column.text) {
+        /* Fetch every key once instead of once per comparison */
+        std::vector<std::string> keys(mRowCount);
+        for (int i = 0; i < mRowCount; ++i)
+            keys[i] = column.text(i);
+        std::stable_sort(mOrder.begin(), mOrder.end(), [&](int a, int b) {
+            return ascending ? keys[a] < keys[b] : keys[b] < keys[a];
+        });
+    }
+}
+
+void TableView::invalidateCell(int row, int column) {
+    auto it = mCellCache.find(cellKey(row, column));
+    if (it != mCellCache.end())
+        it->second.valid = false;
+}
+
+void TableView::invalidateRow(int row) {
+    for (int column = 0; column < (int) mColumns.size(); ++column)
+        invalidateCell(row, column);
+}
+
+void TableView::invalidateColumn(int column) {
+    for (auto &entry : mCellCache)
+        if ((uint32_t) entry.first == (uint32_t) column)
+            entry.second.valid = false;
+}
+
+void TableView::invalidate() {
+    mCellCache.clear();
+    applySort();
+}
+
+Vector2i TableView::bodySize(bool *vscroll, bool *hscroll) const {
+    int contentWidth = 0;
+    for (const auto &column : mColumns)
+        contentWidth += column.width;
+    int contentHeight = mRowCount * mRowHeight;
+
+    Vector2i body(mSize.x(), mSize.y() - mHeaderHeight);
+    bool v = contentHeight > body.y();
+    bool h = contentWidth > body.x() - (v ? 12 : 0);
+    if (h && !v)
+        v = contentHeight > body.y() - 12;
+    body -= Vector2i(v ? 12 : 0, h ? 12 : 0);
+
+    if (vscroll)
+        *vscroll = v;
+    if (hscroll)
+        *hscroll = h;
+    return body.cwiseMax(Vector2i::Zero());
+}
+
+void TableView::setScrollOffset(const Vector2i &offset) {
+    int contentWidth = 0;
+    for (const auto &column : mColumns)
+        contentWidth += column.width;
+    Vector2i content(contentWidth, mRowCount * mRowHeight);
+    Vector2i maxOffset = (content - bodySize()).cwiseMax(Vector2i::Zero());
+    mScrollOffset = offset.cwiseMax(Vector2i::Zero()).cwiseMin(maxOffset);
+}
+
+int TableView::resizeHandleAt(int x) const {
+    int right = -mScrollOffset.x();
+    for (int column = 0; column < (int) mColumns.size(); ++column) {
+        right += mColumns[column].width;
+        if (std::abs(x - right) <= ResizeHandleSize)
+            return column;
+    }
+    return -1;
+}
+
+const TableView::CellText &TableView::cellText(NVGcontext *ctx, int row,
+                                               int column, int available) {
+    CellText &cell = mCellCache[cellKey(row, column)];
+    cell.lastUsed = mFrame;
+    if (!cell.valid) {
+        const Column &col = mColumns[column];
+        cell.text = col.text ? col.text(row) : std::string();
+        cell.width = nvgTextBounds(ctx, 0, 0, cell.text.c_str(), nullptr, nullptr);
+        cell.fitWidth = -1;
+        cell.valid = true;
+    }
+    if (cell.fitWidth == available)
+        return cell;
+    cell.fitWidth = available;
+
+    if (cell.width <= available) {
+        cell.display = cell.text;
+        return cell;
+    }
+
+    /* Truncate at a glyph boundary and append an ellipsis */
+    const char *ellipsis = "\xe2\x80\xa6";
+    float room = available - nvgTextBounds(ctx, 0, 0, ellipsis, nullptr, nullptr);
+    std::vector<NVGglyphPosition> glyphs(cell.text.size());
+    const char *begin = cell.text.data(), *end = begin + cell.text.size();
+    int count = nvgTextGlyphPositions(ctx, 0, 0, begin, end, glyphs.data(),
+                                      (int) glyphs.size());
+    size_t length = 0;
+    for (int i = 0; i < count; ++i) {
+        if (glyphs[i].maxx - glyphs[0].x > room)
+            break;
+        length = (i + 1 < count) ? (size_t) (glyphs[i + 1].str - begin) : cell.text.size();
+    }
+    cell.display = cell.text.substr(0, length) + ellipsis;
+    return cell;
+}
+
+void TableView::trimCache(size_t visibleCells) {
+    if (mCellCache.size() <= 4 * visibleCells + 1024)
+        return;
+    for (auto it = mCellCache.begin(); it != mCellCache.end(); ) {
+        if (it->second.lastUsed != mFrame)
+            it = mCellCache.erase(it);
+        else
+            ++it;
+    }
+}
+
+Vector2i TableView::preferredSize(NVGcontext *) const {
+    int contentWidth = 0;
+    for (const auto &column : mColumns)
+        contentWidth += column.width;
+    return Vector2i(contentWidth + 12,
+                    mHeaderHeight + std::min(mRowCount, 10) * mRowHeight);
+}
+
+bool TableView::mouseButtonEvent(const Vector2i &p, int button, bool down,
+                                 int modifiers) {
+    if (button != NG_MOUSE_BUTTON_1)
+        return Widget::mouseButtonEvent(p, button, down, modifiers);
+
+    Vector2i local = p - mPos;
+    if (!down) {
+        /* Clicking (without resizing) a header sorts by its column */
+        if (mPressedColumn >= 0 && local.y() < mHeaderHeight) {
+            int x = local.x() + mScrollOffset.x(), column = 0;
+            while (column < (int) mColumns.size() && x >= mColumns[column].width)
+                x -= mColumns[column++].width;
+            if (column == mPressedColumn)
+                sortByColumn(column, mSortColumn == column ? !mSortAscending : true);
+        }
+        mResizeColumn = mPressedColumn = -1;
+        mDragScrollbar = 0;
+        return true;
+    }
+
+    bool vscroll, hscroll;
+    Vector2i body = bodySize(&vscroll, &hscroll);
+    mResizeColumn = mPressedColumn = -1;
+    mDragScrollbar = 0;
+
+    if (vscroll && local.x() >= body.x() && local.y() >= mHeaderHeight) {
+        mDragScrollbar = 1;
+    } else if (hscroll && local.y() >= mHeaderHeight + body.y()) {
+        mDragScrollbar = 2;
+    } else if (local.y() < mHeaderHeight) {
+        mResizeColumn = resizeHandleAt(local.x());
+        if (mResizeColumn < 0) {
+            int x = local.x() + mScrollOffset.x(), column = 0;
+            while (column < (int) mColumns.size() && x >= mColumns[column].width)
+                x -= mColumns[column++].width;
+            if (column < (int) mColumns.size())
+                mPressedColumn = column;
+        }
+    } else {
+        int viewRow = (local.y() - mHeaderHeight + mScrollOffset.y()) / mRowHeight;
+        if (viewRow < mRowCount && mOrder[viewRow] != mSelectedRow) {
+            mSelectedRow = mOrder[viewRow];
+            if (mSelectionCallback)
+                mSelectionCallback(mSelectedRow);
+        }
+    }
+    return true;
+}
+
+bool TableView::mouseMotionEvent(const Vector2i &p, const Vector2i &rel,
+                                 int button, int modifiers) {
+    Vector2i local = p - mPos;
+    bool resize = local.y() < mHeaderHeight && resizeHandleAt(local.x()) >= 0;
+    setCursor(resize || mResizeColumn >= 0 ? Cursor::HResize : Cursor::Arrow);
+    return Widget::mouseMotionEvent(p, rel, button, modifiers);
+}
+
+bool TableView::mouseDragEvent(const Vector2i &p, const Vector2i &rel,
+                               int, int) {
+    if (mResizeColumn >= 0) {
+        int left = -mScrollOffset.x();
+        for (int column = 0; column < mResizeColumn; ++column)
+            left += mColumns[column].width;
+        setColumnWidth(mResizeColumn, p.x() - mPos.x() - left);
+        mPressedColumn = -1;
+        return true;
+    }
+
+    if (mDragScrollbar == 0)
+        return false;
+
+    int contentWidth = 0;
+    for (const auto &column : mColumns)
+        contentWidth += column.width;
+    Vector2i content(contentWidth, mRowCount * mRowHeight);
+    Vector2i body = bodySize();
+    int axis = mDragScrollbar == 1 ? 1 : 0;
+
+    float length = (float) body[axis] - 8;
+    float thumb = length * std::min(1.0f, body[axis] / (float) content[axis]);
+    float delta = rel[axis] / std::max(length - thumb, 1.0f);
+    Vector2i offset = mScrollOffset;
+    offset[axis] += (int) std::round(delta * (content[axis] - body[axis]));
+    setScrollOffset(offset);
+    return true;
+}
+
+bool TableView::scrollEvent(const Vector2i &, const Vector2f &rel) {
+    Vector2i offset = mScrollOffset -
+        Vector2i((int) std::round(rel.x() * 3 * mRowHeight),
+                 (int) std::round(rel.y() * 3 * mRowHeight));
+    setScrollOffset(offset);
+    return true;
+}
+
+void TableView::draw(NVGcontext *ctx) {
+    Widget::draw(ctx);
+    ++mFrame;
+
+    bool vscroll, hscroll;
+    Vector2i body = bodySize(&vscroll, &hscroll);
+    setScrollOffset(mScrollOffset);
+
+    int fontSize = this->fontSize();
+    if (fontSize != mCacheFontSize) {
+        mCellCache.clear();
+        mCacheFontSize = fontSize;
+    }
+
+    /* Visible range of rows and columns */
+    int firstRow = mScrollOffset.y() / mRowHeight;
+    int lastRow = std::min(mRowCount,
+        (mScrollOffset.y() + body.y() + mRowHeight - 1) / mRowHeight);
+    int firstColumn = 0, firstColumnX = 0;
+    while (firstColumn < (int) mColumns.size() &&
+           firstColumnX + mColumns[firstColumn].width <= mScrollOffset.x())
+        firstColumnX += mColumns[firstColumn++].width;
+    int lastColumn = firstColumn, contentRight = firstColumnX;
+    while (lastColumn < (int) mColumns.size() &&
+           contentRight < mScrollOffset.x() + body.x())
+        contentRight += mColumns[lastColumn++].width;
+
+    nvgSave(ctx);
+    nvgTranslate(ctx, mPos.x(), mPos.y());
+    nvgIntersectScissor(ctx, 0, 0, mSize.x(), mSize.y());
+
+    nvgBeginPath(ctx);
+    nvgRect(ctx, 0, 0, mSize.x(), mSize.y());
+    nvgFillColor(ctx, Color(0, 32));
+    nvgFill(ctx);
+
+    /* Cells */
+    nvgSave(ctx);
+    nvgIntersectScissor(ctx, 0, mHeaderHeight, body.x(), body.y());
+
+    float rowY = (float) (mHeaderHeight + firstRow * mRowHeight - mScrollOffset.y());
+    nvgBeginPath(ctx);
+    for (int row = firstRow; row < lastRow; ++row)
+        if (row % 2 == 1)
+            nvgRect(ctx, 0, rowY + (row - firstRow) * mRowHeight, body.x(), mRowHeight);
+    nvgFillColor(ctx, Color(255, 8));
+    nvgFill(ctx);
+
+    for (int row = firstRow; row < lastRow; ++row) {
+        if (mOrder[row] != mSelectedRow)
+            continue;
+        nvgBeginPath(ctx);
+        nvgRect(ctx, 0, rowY + (row - firstRow) * mRowHeight, body.x(), mRowHeight);
+        nvgFillColor(ctx, Color(255, 40));
+        nvgFill(ctx);
+    }
+
+    nvgFontFace(ctx, "sans");
+    nvgFontSize(ctx, fontSize);
+    nvgFillColor(ctx, mEnabled ? mTheme->mTextColor : mTheme->mDisabledTextColor);
+    int columnX = firstColumnX - mScrollOffset.x();
+    for (int column = firstColumn; column < lastColumn; ++column) {
+        const Column &col = mColumns[column];
+        int available = std::max(col.width - 2 * CellPadding, 0);
+        float textX = (float) columnX + CellPadding;
+        if (col.alignment & NVG_ALIGN_RIGHT)
+            textX += available;
+        else if (col.alignment & NVG_ALIGN_CENTER)
+            textX += available * 0.5f;
+        nvgTextAlign(ctx, col.alignment | NVG_ALIGN_MIDDLE);
+
+        for (int row = firstRow; row < lastRow; ++row) {
+            const CellText &cell = cellText(ctx, mOrder[row], column, available);
+            if (cell.display.empty())
+                continue;
+            nvgText(ctx, textX, rowY + (row - firstRow + 0.5f) * mRowHeight,
+                    cell.display.c_str(), nullptr);
+        }
+        columnX += col.width;
+    }
+
+    /* Column separators */
+    float gridBottom = std::min((float) (mHeaderHeight + body.y()),
+                                rowY + (lastRow - firstRow) * mRowHeight);
+    nvgBeginPath(ctx);
+    columnX = firstColumnX - mScrollOffset.x();
+    for (int column = firstColumn; column < lastColumn; ++column) {
+        columnX += mColumns[column].width;
+        nvgMoveTo(ctx, columnX - 0.5f, (float) mHeaderHeight);
+        nvgLineTo(ctx, columnX - 0.5f, gridBottom);
+    }
+    nvgStrokeColor(ctx, mTheme->mBorderDark);
+    nvgStroke(ctx);
+    nvgRestore(ctx);
+
+    /* Frozen header */
+    if (mHeaderHeight > 0) {
+        nvgSave(ctx);
+        nvgIntersectScissor(ctx, 0, 0, body.x(), mHeaderHeight);
+
+        NVGpaint bg = nvgLinearGradient(ctx, 0, 0, 0, mHeaderHeight,
+                                        mTheme->mButtonGradientTopUnfocused,
+                                        mTheme->mButtonGradientBotUnfocused);
+        nvgBeginPath(ctx);
+        nvgRect(ctx, 0, 0, mSize.x(), mHeaderHeight);
+        nvgFillPaint(ctx, bg);
+        nvgFill(ctx);
+
+        nvgFontFace(ctx, "sans-bold");
+        nvgFontSize(ctx, fontSize);
+        nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+        nvgFillColor(ctx, mTheme->mTextColor);
+        columnX = firstColumnX - mScrollOffset.x();
+        for (int column = firstColumn; column < lastColumn; ++column) {
+            const Column &col = mColumns[column];
+            nvgSave(ctx);
+            nvgIntersectScissor(ctx, columnX, 0, col.width - CellPadding, mHeaderHeight);
+            nvgText(ctx, columnX + CellPadding, mHeaderHeight * 0.5f, col.title.c_str(), nullptr);
+            nvgRestore(ctx);
+
+            if (column == mSortColumn) {
+                auto icon = utf8(mSortAscending ? ENTYPO_ICON_CHEVRON_SMALL_UP
+                                                : ENTYPO_ICON_CHEVRON_SMALL_DOWN);
+                nvgFontFace(ctx, "icons");
+                nvgTextAlign(ctx, NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE);
+                nvgText(ctx, columnX + col.width - CellPadding, mHeaderHeight * 0.5f,
+                        icon.data(), nullptr);
+                nvgFontFace(ctx, "sans-bold");
+                nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+            }
+            columnX += col.width;
+        }
+
+        nvgBeginPath(ctx);
+        columnX = firstColumnX - mScrollOffset.x();
+        for (int column = firstColumn; column < lastColumn; ++column) {
+            columnX += mColumns[column].width;
+            nvgMoveTo(ctx, columnX - 0.5f, 4.0f);
+            nvgLineTo(ctx, columnX - 0.5f, mHeaderHeight - 4.0f);
+        }
+        nvgStrokeColor(ctx, mTheme->mBorderLight);
+        nvgStroke(ctx);
+
+        nvgBeginPath(ctx);
+        nvgMoveTo(ctx, 0, mHeaderHeight - 0.5f);
+        nvgLineTo(ctx, mSize.x(), mHeaderHeight - 0.5f);
+        nvgStrokeColor(ctx, mTheme->mBorderDark);
+        nvgStroke(ctx);
+        nvgRestore(ctx);
+    }
+
+    /* Scroll bars */
+    int contentWidth = 0;
+    for (const auto &column : mColumns)
+        contentWidth += column.width;
+    int contentHeight = mRowCount * mRowHeight;
+    if (vscroll) {
+        float length = body.y() - 8.f;
+        float thumb = length * std::min(1.0f, body.y() / (float) contentHeight);
+        drawScrollBar(ctx, mSize.x() - 12.f, mHeaderHeight + 4.f, length, thumb,
+                      mScrollOffset.y() / (float) std::max(contentHeight - body.y(), 1), true);
+    }
+    if (hscroll) {
+        float length = body.x() - 8.f;
+        float thumb = length * std::min(1.0f, body.x() / (float) contentWidth);
+        drawScrollBar(ctx, 4.f, mSize.y() - 12.f, length, thumb,
+                      mScrollOffset.x() / (float) std::max(contentWidth - body.x(), 1), false);
+    }
+
+    nvgRestore(ctx);
+
+    trimCache((size_t) std::max(lastRow - firstRow, 0) *
+              (size_t) std::max(lastColumn - firstColumn, 0));
+}
+
+void TableView::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("rowHeight", mRowHeight);
+    s.set("headerHeight", mHeaderHeight);
+    s.set("sortColumn", mSortColumn);
+    s.set("sortAscending", mSortAscending);
+    s.set("scrollOffset", mScrollOffset);
+}
+
+bool TableView::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    if (!s.get("rowHeight", mRowHeight)) return false;
+    if (!s.get("headerHeight", mHeaderHeight)) return false;
+    if (!s.get("sortColumn", mSortColumn)) return false;
+    if (!s.get("sortAscending", mSortAscending)) return false;
+    if (!s.get("scrollOffset", mScrollOffset)) return false;
+    if (mSortColumn >= (int) mColumns.size())
+        mSortColumn = -1;
+    invalidate();
+    return true;
+}
+
+NAMESPACE_END(nanogui)
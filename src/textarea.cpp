@@ -0,0 +1,600 @@
+/*
+    src/textarea.cpp -- Multi-line text editor backed by a piece table
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/textarea.h>
+#include <nanogui/window.h>
+#include <nanogui/screen.h>
+#include <nanogui/theme.h>
+#include <nanogui/opengl.h>
+#include <nanogui/serializer/core.h>
+#include <algorithm>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Distance between the border and the text */
+static const int TextPadding = 5;
+/* Width reserved for the vertical scroll bar */
+static const int ScrollBarWidth = 12;
+
+TextArea::TextArea(Widget *parent, const std::string &value)
+    : Widget(parent), mEditable(true), mCursorPos(0),
+      mSelectionPos(std::string::npos), mPreferredX(-1.f),
+      mScrollToCursor(false), mScrollOffset(Vector2i::Zero()),
+      mMaxLineWidth(0.f), mDragScrollbar(false), mFrame(0),
+      mLayoutFontSize(-1) {
+    mText.setText(value);
+    setCursor(Cursor::IBeam);
+}
+
+void TextArea::setValue(const std::string &value) {
+    mText.setText(value);
+    invalidateLines(0);
+    mMaxLineWidth = 0.f;
+    mCursorPos = 0;
+    mSelectionPos = std::string::npos;
+    mPreferredX = -1.f;
+    mScrollOffset = Vector2i::Zero();
+}
+
+void TextArea::setEditable(bool editable) {
+    mEditable = editable;
+    setCursor(editable ? Cursor::IBeam : Cursor::Arrow);
+}
+
+void TextArea::setCursorPosition(size_t position) {
+    mCursorPos = std::min(position, mText.length());
+    mSelectionPos = std::string::npos;
+    mPreferredX = -1.f;
+    mScrollToCursor = true;
+}
+
+void TextArea::select(size_t begin, size_t end) {
+    mSelectionPos = std::min(begin, mText.length());
+    mCursorPos = std::min(end, mText.length());
+    mPreferredX = -1.f;
+    mScrollToCursor = true;
+}
+
+std::string TextArea::selectedText() const {
+    if (!hasSelection())
+        return std::string();
+    size_t begin = std::min(mCursorPos, mSelectionPos);
+    size_t end = std::max(mCursorPos, mSelectionPos);
+    return mText.text(begin, end - begin);
+}
+
+void TextArea::insertText(const std::string &text) {
+    size_t begin = mCursorPos, end = mCursorPos;
+    if (hasSelection()) {
+        begin = std::min(mCursorPos, mSelectionPos);
+        end = std::max(mCursorPos, mSelectionPos);
+    }
+    replaceRange(begin, end, text, false);
+}
+
+bool TextArea::undo() {
+    size_t cursor;
+    if (!mText.undo(&cursor))
+        return false;
+    /* The extent of the restored edit is not known here, so lay out again */
+    invalidateLines(0);
+    setCursorPosition(cursor);
+    if (mCallback)
+        mCallback();
+    return true;
+}
+
+bool TextArea::redo() {
+    size_t cursor;
+    if (!mText.redo(&cursor))
+        return false;
+    invalidateLines(0);
+    setCursorPosition(cursor);
+    if (mCallback)
+        mCallback();
+    return true;
+}
+
+void TextArea::setScrollOffset(const Vector2i &offset) {
+    Vector2i view = viewSize();
+    int contentHeight = (int) mText.lineCount() * lineHeight() + 2 * TextPadding;
+    int contentWidth = (int) std::ceil(mMaxLineWidth) + 2 * TextPadding + 1;
+    mScrollOffset = Vector2i(
+        std::max(0, std::min(offset.x(), contentWidth - view.x())),
+        std::max(0, std::min(offset.y(), contentHeight - view.y())));
+}
+
+Vector2i TextArea::preferredSize(NVGcontext *) const {
+    return Vector2i(300, 10 * lineHeight() + 2 * TextPadding);
+}
+
+bool TextArea::mouseButtonEvent(const Vector2i &p, int button, bool down,
+                                int modifiers) {
+    if (button != NG_MOUSE_BUTTON_1)
+        return Widget::mouseButtonEvent(p, button, down, modifiers);
+
+    if (!down) {
+        mDragScrollbar = false;
+        return true;
+    }
+
+    requestFocus();
+    Vector2i view = viewSize();
+    if (p.x() - mPos.x() >= view.x() &&
+        (int) mText.lineCount() * lineHeight() + 2 * TextPadding > view.y()) {
+        mDragScrollbar = true;
+        return true;
+    }
+
+    size_t position = positionAt(p - mPos);
+    moveCursor(position, (modifiers & NG_MOD_SHIFT) != 0);
+    mSelectionPos = (modifiers & NG_MOD_SHIFT) ? mSelectionPos : position;
+    return true;
+}
+
+bool TextArea::mouseDragEvent(const Vector2i &p, const Vector2i &rel,
+                              int /* button */, int /* modifiers */) {
+    if (mDragScrollbar) {
+        Vector2i view = viewSize();
+        int contentHeight = (int) mText.lineCount() * lineHeight() + 2 * TextPadding;
+        float length = (float) view.y() - 8;
+        float thumb = length * std::min(1.0f, view.y() / (float) contentHeight);
+        float delta = rel.y() / std::max(length - thumb, 1.0f);
+        setScrollOffset(Vector2i(mScrollOffset.x(), mScrollOffset.y() +
+            (int) std::round(delta * (contentHeight - view.y()))));
+        return true;
+    }
+
+    if (mSelectionPos == std::string::npos)
+        mSelectionPos = mCursorPos;
+    mCursorPos = positionAt(p - mPos);
+    mPreferredX = -1.f;
+    mScrollToCursor = true;
+    return true;
+}
+
+bool TextArea::scrollEvent(const Vector2i &, const Vector2f &rel) {
+    setScrollOffset(mScrollOffset -
+        Vector2i((int) std::round(rel.x() * 3 * lineHeight()),
+                 (int) std::round(rel.y() * 3 * lineHeight())));
+    return true;
+}
+
+bool TextArea::keyboardEvent(int key, int /* scancode */, int action, int modifiers) {
+    if (!focused() || (action != NG_PRESS && action != NG_REPEAT))
+        return false;
+
+    bool extend = (modifiers & NG_MOD_SHIFT) != 0;
+    bool command = (modifiers & SYSTEM_COMMAND_MOD) != 0;
+    size_t line = mText.lineOf(mCursorPos);
+    int pageLines = std::max(viewSize().y() / lineHeight() - 1, 1);
+
+    if (key == NG_KEY_LEFT) {
+        if (hasSelection() && !extend)
+            moveCursor(std::min(mCursorPos, mSelectionPos), false);
+        else
+            moveCursor(previousCharacter(mCursorPos), extend);
+    } else if (key == NG_KEY_RIGHT) {
+        if (hasSelection() && !extend)
+            moveCursor(std::max(mCursorPos, mSelectionPos), false);
+        else
+            moveCursor(nextCharacter(mCursorPos), extend);
+    } else if (key == NG_KEY_UP) {
+        moveCursorLines(-1, extend);
+    } else if (key == NG_KEY_DOWN) {
+        moveCursorLines(1, extend);
+    } else if (key == NG_KEY_PAGE_UP) {
+        moveCursorLines(-pageLines, extend);
+    } else if (key == NG_KEY_PAGE_DOWN) {
+        moveCursorLines(pageLines, extend);
+    } else if (key == NG_KEY_HOME) {
+        moveCursor(command ? 0 : mText.lineStart(line), extend);
+    } else if (key == NG_KEY_END) {
+        moveCursor(command ? mText.length() : mText.lineEnd(line), extend);
+    } else if (key == NG_KEY_A && command) {
+        select(0, mText.length());
+    } else if (key == NG_KEY_C && command) {
+        copySelection();
+    } else if (!mEditable) {
+        return true;
+    } else if (key == NG_KEY_BACKSPACE) {
+        if (!deleteSelection() && mCursorPos > 0)
+            replaceRange(previousCharacter(mCursorPos), mCursorPos, std::string(), false);
+    } else if (key == NG_KEY_DELETE) {
+        if (!deleteSelection() && mCursorPos < mText.length())
+            replaceRange(mCursorPos, nextCharacter(mCursorPos), std::string(), false);
+    } else if (key == NG_KEY_ENTER || key == NG_KEY_KP_ENTER) {
+        insertText("\n");
+    } else if (key == NG_KEY_TAB) {
+        insertText("    ");
+    } else if (key == NG_KEY_X && command) {
+        copySelection();
+        deleteSelection();
+    } else if (key == NG_KEY_V && command) {
+        pasteFromClipboard();
+    } else if ((key == NG_KEY_Z && command && extend) || (key == NG_KEY_Y && command)) {
+        redo();
+    } else if (key == NG_KEY_Z && command) {
+        undo();
+    }
+    return true;
+}
+
+bool TextArea::keyboardCharacterEvent(unsigned int codepoint) {
+    if (!focused() || !mEditable)
+        return false;
+
+    std::string text = utf8((int) codepoint).data();
+    if (hasSelection()) {
+        insertText(text);
+    } else {
+        /* Consecutive characters are undone together */
+        replaceRange(mCursorPos, mCursorPos, text, true);
+    }
+    return true;
+}
+
+void TextArea::draw(NVGcontext *ctx) {
+    Widget::draw(ctx);
+    ++mFrame;
+
+    int fontSize = this->fontSize();
+    if (fontSize != mLayoutFontSize) {
+        invalidateLines(0);
+        mMaxLineWidth = 0.f;
+        mLayoutFontSize = fontSize;
+    }
+
+    nvgSave(ctx);
+    nvgFontFace(ctx, "sans");
+    nvgFontSize(ctx, fontSize);
+    nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+
+    if (mScrollToCursor) {
+        scrollToCursor(ctx);
+        mScrollToCursor = false;
+    }
+    setScrollOffset(mScrollOffset);
+
+    nvgTranslate(ctx, mPos.x(), mPos.y());
+
+    NVGpaint bg = nvgBoxGradient(ctx, 1, 1 + 1.0f, mSize.x() - 2, mSize.y() - 2, 3, 4,
+        (mEditable && focused()) ? Color(150, 32) : Color(255, 32), Color(32, 32));
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, 1, 1 + 1.0f, mSize.x() - 2, mSize.y() - 2, 3);
+    nvgFillPaint(ctx, bg);
+    nvgFill(ctx);
+
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, 0.5f, 0.5f, mSize.x() - 1, mSize.y() - 1, 2.5f);
+    nvgStrokeColor(ctx, Color(0, 48));
+    nvgStroke(ctx);
+
+    Vector2i view = viewSize();
+    int lineh = lineHeight();
+    size_t lineCount = mText.lineCount();
+    size_t firstLine = (size_t) std::max(mScrollOffset.y() - TextPadding, 0) / lineh;
+    size_t lastLine = std::min(lineCount,
+        (size_t) (mScrollOffset.y() - TextPadding + view.y() + lineh - 1) / lineh);
+
+    nvgSave(ctx);
+    nvgIntersectScissor(ctx, 1, 1, view.x() - 1, mSize.y() - 2);
+
+    float textX = (float) (TextPadding - mScrollOffset.x());
+    size_t selBegin = 0, selEnd = 0;
+    if (hasSelection()) {
+        selBegin = std::min(mCursorPos, mSelectionPos);
+        selEnd = std::max(mCursorPos, mSelectionPos);
+    }
+
+    for (size_t line = firstLine; line < lastLine; ++line) {
+        const LineLayout &layout = lineLayout(ctx, line);
+        float y = (float) (TextPadding + (int) line * lineh - mScrollOffset.y());
+        size_t lineStart = mText.lineStart(line);
+        size_t lineEnd = lineStart + layout.text.size();
+
+        if (selBegin < selEnd && selBegin <= lineEnd && selEnd > lineStart) {
+            size_t begin = std::max(selBegin, lineStart) - lineStart;
+            size_t end = std::min(selEnd, lineEnd) - lineStart;
+            float x0 = layout.positions[std::lower_bound(layout.offsets.begin(),
+                layout.offsets.end(), begin) - layout.offsets.begin()];
+            float x1 = layout.positions[std::lower_bound(layout.offsets.begin(),
+                layout.offsets.end(), end) - layout.offsets.begin()];
+            /* Show selected line breaks as a small extension */
+            if (selEnd > lineEnd)
+                x1 += fontSize * 0.3f;
+            nvgBeginPath(ctx);
+            nvgFillColor(ctx, nvgRGBA(255, 255, 255, 80));
+            nvgRect(ctx, textX + x0, y, x1 - x0, (float) lineh);
+            nvgFill(ctx);
+        }
+
+        if (!layout.text.empty()) {
+            nvgFillColor(ctx, mEnabled ? mTheme->mTextColor : mTheme->mDisabledTextColor);
+            nvgText(ctx, textX, y + lineh * 0.5f, layout.text.data(),
+                    layout.text.data() + layout.text.size());
+        }
+    }
+
+    if (focused() && mEditable) {
+        size_t line = mText.lineOf(mCursorPos);
+        if (line >= firstLine && line < lastLine) {
+            float x = textX + offsetToX(ctx, mCursorPos);
+            float y = (float) (TextPadding + (int) line * lineh - mScrollOffset.y());
+            nvgBeginPath(ctx);
+            nvgMoveTo(ctx, x, y);
+            nvgLineTo(ctx, x, y + lineh);
+            nvgStrokeColor(ctx, nvgRGBA(255, 192, 0, 255));
+            nvgStrokeWidth(ctx, 1.0f);
+            nvgStroke(ctx);
+        }
+    }
+    nvgRestore(ctx);
+
+    /* Scroll bar */
+    int contentHeight = (int) lineCount * lineh + 2 * TextPadding;
+    if (contentHeight > mSize.y()) {
+        float length = (float) mSize.y() - 8;
+        float thumb = length * std::min(1.0f, mSize.y() / (float) contentHeight);
+        drawScrollBar(ctx, mSize.x() - 12.f, 4.f, length, thumb,
+                      mScrollOffset.y() / (float) std::max(contentHeight - mSize.y(), 1), true);
+    }
+    nvgRestore(ctx);
+
+    /* Keep the layouts of the lines around the viewport, for scrolling */
+    size_t margin = lastLine - firstLine + 16;
+    size_t keepBegin = firstLine > margin ? firstLine - margin : 0;
+    size_t keepEnd = lastLine + margin;
+    if (mLayouts.size() > 4 * margin) {
+        mLayouts.erase(mLayouts.begin(), mLayouts.lower_bound(keepBegin));
+        mLayouts.erase(mLayouts.lower_bound(keepEnd), mLayouts.end());
+    }
+}
+
+void TextArea::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("value", mText.text());
+    s.set("editable", mEditable);
+    s.set("scrollOffset", mScrollOffset);
+}
+
+bool TextArea::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    std::string value;
+    if (!s.get("value", value)) return false;
+    if (!s.get("editable", mEditable)) return false;
+    Vector2i scrollOffset;
+    if (!s.get("scrollOffset", scrollOffset)) return false;
+    setValue(value);
+    mScrollOffset = scrollOffset;
+    return true;
+}
+
+NVGcontext *TextArea::context() {
+    Widget *widget = this;
+    while (widget->parent())
+        widget = widget->parent();
+    Screen *screen = dynamic_cast<Screen *>(widget);
+    return screen ? screen->nvgContext() : nullptr;
+}
+
+const TextArea::LineLayout &TextArea::lineLayout(NVGcontext *ctx, size_t line) {
+    auto it = mLayouts.find(line);
+    if (it != mLayouts.end()) {
+        it->second.lastUsed = mFrame;
+        return it->second;
+    }
+
+    LineLayout &layout = mLayouts[line];
+    size_t start = mText.lineStart(line);
+    layout.text = mText.text(start, mText.lineEnd(line) - start);
+    layout.lastUsed = mFrame;
+
+    if (!layout.text.empty()) {
+        nvgSave(ctx);
+        nvgFontFace(ctx, "sans");
+        nvgFontSize(ctx, fontSize());
+        nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+
+        /* A line has at most one glyph per byte */
+        const char *begin = layout.text.data(), *end = begin + layout.text.size();
+        std::vector<NVGglyphPosition> glyphs(layout.text.size());
+        int count = nvgTextGlyphPositions(ctx, 0, 0, begin, end, glyphs.data(),
+                                          (int) glyphs.size());
+        layout.offsets.reserve(count + 1);
+        layout.positions.reserve(count + 1);
+        for (int i = 0; i < count; ++i) {
+            layout.offsets.push_back((size_t) (glyphs[i].str - begin));
+            layout.positions.push_back(glyphs[i].x);
+        }
+        float width = nvgTextBounds(ctx, 0, 0, begin, end, nullptr);
+        if (count > 0)
+            width = std::max(width, glyphs[count - 1].maxx);
+        layout.positions.push_back(width);
+        nvgRestore(ctx);
+    } else {
+        layout.positions.push_back(0.f);
+    }
+    layout.offsets.push_back(layout.text.size());
+    mMaxLineWidth = std::max(mMaxLineWidth, layout.positions.back());
+    return layout;
+}
+
+void TextArea::invalidateLines(size_t line) {
+    mLayouts.erase(mLayouts.lower_bound(line), mLayouts.end());
+}
+
+float TextArea::offsetToX(NVGcontext *ctx, size_t offset) {
+    size_t line = mText.lineOf(offset);
+    const LineLayout &layout = lineLayout(ctx, line);
+    size_t column = offset - mText.lineStart(line);
+    auto it = std::lower_bound(layout.offsets.begin(), layout.offsets.end(), column);
+    return layout.positions[it - layout.offsets.begin()];
+}
+
+size_t TextArea::xToOffset(NVGcontext *ctx, size_t line, float x) {
+    const LineLayout &layout = lineLayout(ctx, line);
+
+    /* Binary search for the first glyph whose center lies right of x */
+    size_t lo = 0, hi = layout.offsets.size() - 1;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (x < 0.5f * (layout.positions[mid] + layout.positions[mid + 1]))
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return mText.lineStart(line) + layout.offsets[lo];
+}
+
+size_t TextArea::positionAt(const Vector2i &p) {
+    int y = p.y() - TextPadding + mScrollOffset.y();
+    size_t line = (size_t) std::max(y, 0) / lineHeight();
+    if (line >= mText.lineCount())
+        return mText.length();
+
+    NVGcontext *ctx = context();
+    if (!ctx)
+        return mText.lineStart(line);
+    return xToOffset(ctx, line, (float) (p.x() - TextPadding + mScrollOffset.x()));
+}
+
+size_t TextArea::previousCharacter(size_t offset) const {
+    if (offset == 0)
+        return 0;
+    size_t start = offset > 4 ? offset - 4 : 0;
+    std::string bytes = mText.text(start, offset - start);
+    size_t i = bytes.size() - 1;
+    /* Skip UTF-8 continuation bytes */
+    while (i > 0 && (bytes[i] & 0xC0) == 0x80)
+        --i;
+    return start + i;
+}
+
+size_t TextArea::nextCharacter(size_t offset) const {
+    std::string bytes = mText.text(offset, 4);
+    if (bytes.empty())
+        return offset;
+    size_t i = 1;
+    while (i < bytes.size() && (bytes[i] & 0xC0) == 0x80)
+        ++i;
+    return offset + i;
+}
+
+void TextArea::moveCursor(size_t position, bool select) {
+    if (select) {
+        if (mSelectionPos == std::string::npos)
+            mSelectionPos = mCursorPos;
+    } else {
+        mSelectionPos = std::string::npos;
+    }
+    mCursorPos = position;
+    mPreferredX = -1.f;
+    mScrollToCursor = true;
+}
+
+void TextArea::moveCursorLines(long lines, bool select) {
+    long line = (long) mText.lineOf(mCursorPos);
+    long target = std::max(0L, std::min(line + lines, (long) mText.lineCount() - 1));
+    NVGcontext *ctx = context();
+
+    float preferredX = mPreferredX;
+    size_t position;
+    if (target == line && lines < 0)
+        position = 0;
+    else if (target == line && lines > 0)
+        position = mText.length();
+    else if (!ctx)
+        position = mText.lineStart((size_t) target);
+    else {
+        if (preferredX < 0)
+            preferredX = offsetToX(ctx, mCursorPos);
+        position = xToOffset(ctx, (size_t) target, preferredX);
+    }
+
+    moveCursor(position, select);
+    mPreferredX = preferredX;
+}
+
+void TextArea::replaceRange(size_t begin, size_t end, const std::string &text,
+                            bool mergeUndo) {
+    size_t line = mText.lineOf(begin);
+    size_t lineCount = mText.lineCount();
+    bool multiline = mText.lineOf(end) != line || text.find('\n') != std::string::npos;
+
+    if (end > begin)
+        mText.replace(begin, end - begin, text, mergeUndo);
+    else
+        mText.insert(begin, text, mergeUndo);
+
+    if (multiline || mText.lineCount() != lineCount)
+        invalidateLines(line);
+    else
+        mLayouts.erase(line);
+
+    mCursorPos = begin + text.size();
+    mSelectionPos = std::string::npos;
+    mPreferredX = -1.f;
+    mScrollToCursor = true;
+    if (mCallback)
+        mCallback();
+}
+
+bool TextArea::deleteSelection() {
+    if (!hasSelection())
+        return false;
+    replaceRange(std::min(mCursorPos, mSelectionPos),
+                 std::max(mCursorPos, mSelectionPos), std::string(), false);
+    return true;
+}
+
+bool TextArea::copySelection() {
+    if (!hasSelection())
+        return false;
+    Screen *sc = dynamic_cast<Screen *>(this->window()->parent());
+    ngSetClipboardString(sc, selectedText().c_str());
+    return true;
+}
+
+void TextArea::pasteFromClipboard() {
+    Screen *sc = dynamic_cast<Screen *>(this->window()->parent());
+    const char *cbstr = ngGetClipboardString(sc);
+    if (cbstr)
+        insertText(std::string(cbstr));
+}
+
+Vector2i TextArea::viewSize() const {
+    Vector2i view = mSize;
+    if ((int) mText.lineCount() * lineHeight() + 2 * TextPadding > mSize.y())
+        view.x() -= ScrollBarWidth;
+    return Vector2i(std::max(view.x(), 0), std::max(view.y(), 0));
+}
+
+void TextArea::scrollToCursor(NVGcontext *ctx) {
+    Vector2i view = viewSize();
+    int lineh = lineHeight();
+    int line = (int) mText.lineOf(mCursorPos);
+    int top = TextPadding + line * lineh;
+    int x = TextPadding + (int) offsetToX(ctx, mCursorPos);
+
+    Vector2i offset = mScrollOffset;
+    if (top < offset.y() + TextPadding)
+        offset.y() = top - TextPadding;
+    else if (top + lineh > offset.y() + view.y() - TextPadding)
+        offset.y() = top + lineh - view.y() + TextPadding;
+    if (x < offset.x() + TextPadding)
+        offset.x() = x - TextPadding;
+    else if (x > offset.x() + view.x() - TextPadding)
+        offset.x() = x - view.x() + TextPadding;
+    setScrollOffset(offset);
+}
+
+NAMESPACE_END(nanogui)
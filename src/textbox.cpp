@@ -19,8 +19,12 @@
 #include <nanogui/theme.h>
 #include <nanogui/entypo.h>
 #include <nanogui/serializer/core.h>
+#include <algorithm>
 #include <regex>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -44,7 +48,12 @@ TextBox::TextBox(Widget *parent,const std::string &value)
       mMouseDragPos(Vector2i(-1,-1)),
       mMouseDownModifier(0),
       mTextOffset(0),
-      mLastClick(0) {
+      mLastClick(0),
+      mGlyphsValid(false),
+      mGlyphFontSize(-1),
+      mDirtyBegin(-1),
+      mDirtyOldEnd(-1),
+      mDirtyNewEnd(-1) {
     if (mTheme) mFontSize = mTheme->mTextBoxFontSize;
 }
 
@@ -211,24 +220,31 @@ void TextBox::draw(NVGcontext* ctx) {
     if (mCommitted) {
         nvgText(ctx, drawPos.x(), drawPos.y(), mValue.c_str(), nullptr);
     } else {
-        const int maxGlyphs = 1024;
-        NVGglyphPosition glyphs[maxGlyphs];
-        float textBound[4];
-        nvgTextBounds(ctx, drawPos.x(), drawPos.y(), mValueTemp.c_str(),
-                      nullptr, textBound);
-        float lineh = textBound[3] - textBound[1];
+        // glyph positions are cached, and only change when the text is edited
+        updateGlyphs(ctx);
+        float ascender, descender;
+        nvgTextMetrics(ctx, &ascender, &descender, nullptr);
+        float lineh = ascender - descender;
+
+        // position of the first glyph when the text is drawn at x
+        float width = mGlyphX.back();
+        auto originX = [&](float x) {
+            if (mAlignment == Alignment::Right)
+                return x - width;
+            else if (mAlignment == Alignment::Center)
+                return x - width * 0.5f;
+            return x;
+        };
 
         // find cursor positions
-        int nglyphs =
-            nvgTextGlyphPositions(ctx, drawPos.x(), drawPos.y(),
-                                  mValueTemp.c_str(), nullptr, glyphs, maxGlyphs);
-        updateCursor(ctx, textBound[2], glyphs, nglyphs);
+        updateCursor(originX(drawPos.x()));
 
         // compute text offset
+        int nglyphs = glyphCount();
         int prevCPos = mCursorPos > 0 ? mCursorPos - 1 : 0;
         int nextCPos = mCursorPos < nglyphs ? mCursorPos + 1 : nglyphs;
-        float prevCX = cursorIndex2Position(prevCPos, textBound[2], glyphs, nglyphs);
-        float nextCX = cursorIndex2Position(nextCPos, textBound[2], glyphs, nglyphs);
+        float prevCX = cursorIndex2Position(prevCPos, originX(drawPos.x()));
+        float nextCX = cursorIndex2Position(nextCPos, originX(drawPos.x()));
 
         if (nextCX > clipX + clipWidth)
             mTextOffset -= nextCX - (clipX + clipWidth) + 1;
@@ -236,22 +252,15 @@ void TextBox::draw(NVGcontext* ctx) {
             mTextOffset += clipX - prevCX + 1;
 
         drawPos.x() = oldDrawPos.x() + mTextOffset;
+        float origin = originX(drawPos.x());
 
         // draw text with offset
         nvgText(ctx, drawPos.x(), drawPos.y(), mValueTemp.c_str(), nullptr);
-        nvgTextBounds(ctx, drawPos.x(), drawPos.y(), mValueTemp.c_str(),
-                      nullptr, textBound);
-
-        // recompute cursor positions
-        nglyphs = nvgTextGlyphPositions(ctx, drawPos.x(), drawPos.y(),
-                mValueTemp.c_str(), nullptr, glyphs, maxGlyphs);
 
         if (mCursorPos > -1) {
             if (mSelectionPos > -1) {
-                float caretx = cursorIndex2Position(mCursorPos, textBound[2],
-                                                    glyphs, nglyphs);
-                float selx = cursorIndex2Position(mSelectionPos, textBound[2],
-                                                  glyphs, nglyphs);
+                float caretx = cursorIndex2Position(mCursorPos, origin);
+                float selx = cursorIndex2Position(mSelectionPos, origin);
 
                 if (caretx > selx)
                     std::swap(caretx, selx);
@@ -264,7 +273,7 @@ void TextBox::draw(NVGcontext* ctx) {
                 nvgFill(ctx);
             }
 
-            float caretx = cursorIndex2Position(mCursorPos, textBound[2], glyphs, nglyphs);
+            float caretx = cursorIndex2Position(mCursorPos, origin);
 
             // draw cursor
             nvgBeginPath(ctx);
@@ -336,6 +345,9 @@ bool TextBox::mouseButtonEvent(const Vector2i &p, int button, bool down,
 
 bool TextBox::mouseMotionEvent(const Vector2i &p, const Vector2i & /* rel */,
                                int /* button */, int /* modifiers */) {
+    /* The spin arrow under the mouse is highlighted */
+    if (mSpinnable && spinArea(p) != spinArea(mMousePos))
+        invalidateLayers();
     mMousePos = p;
 
     if (!mEditable)
@@ -370,6 +382,7 @@ bool TextBox::focusEvent(bool focused) {
     if (mEditable) {
         if (focused) {
             mValueTemp = mValue;
+            invalidateGlyphs();
             mCommitted = false;
             mCursorPos = 0;
         } else {
@@ -441,13 +454,16 @@ bool TextBox::keyboardEvent(int key, int /* scancode */, int action, int modifie
                 if (!deleteSelection()) {
                     if (mCursorPos > 0) {
                         mValueTemp.erase(mValueTemp.begin() + mCursorPos - 1);
+                        textEdited(mCursorPos - 1, 1, 0);
                         mCursorPos--;
                     }
                 }
             } else if (key == NG_KEY_DELETE) {
                 if (!deleteSelection()) {
-                    if (mCursorPos < (int) mValueTemp.length())
+                    if (mCursorPos < (int) mValueTemp.length()) {
                         mValueTemp.erase(mValueTemp.begin() + mCursorPos);
+                        textEdited(mCursorPos, 1, 0);
+                    }
                 }
             } else if (key == NG_KEY_ENTER) {
                 if (!mCommitted)
@@ -482,6 +498,7 @@ bool TextBox::keyboardCharacterEvent(unsigned int codepoint) {
 
         deleteSelection();
         mValueTemp.insert(mCursorPos, convert.str());
+        textEdited(mCursorPos, 0, 1);
         mCursorPos++;
 
         mValidFormat = (mValueTemp == "") || checkFormat(mValueTemp, mFormat);
@@ -492,12 +509,71 @@ bool TextBox::keyboardCharacterEvent(unsigned int codepoint) {
     return false;
 }
 
+/* Formats set by IntBox and FloatBox, which are validated without regular expressions */
+static const char *UnsignedIntegerFormat = "[0-9]*";
+static const char *SignedIntegerFormat = "[-]?[0-9]*";
+static const char *FloatFormat = "[-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?";
+
+static size_t skipDigits(const std::string &input, size_t i) {
+    while (i < input.size() && input[i] >= '0' && input[i] <= '9')
+        ++i;
+    return i;
+}
+
+static bool matchInteger(const std::string &input, bool allowSign) {
+    size_t i = (allowSign && !input.empty() && input[0] == '-') ? 1 : 0;
+    return skipDigits(input, i) == input.size();
+}
+
+static bool matchFloat(const std::string &input) {
+    size_t i = 0;
+    if (i < input.size() && (input[i] == '-' || input[i] == '+'))
+        ++i;
+    size_t digits = skipDigits(input, i);
+    bool mantissa = digits > i;
+    i = digits;
+    if (i < input.size() && input[i] == '.') {
+        digits = skipDigits(input, ++i);
+        mantissa = digits > i;
+        i = digits;
+    }
+    if (!mantissa)
+        return false;
+    if (i < input.size() && (input[i] == 'e' || input[i] == 'E')) {
+        ++i;
+        if (i < input.size() && (input[i] == '-' || input[i] == '+'))
+            ++i;
+        digits = skipDigits(input, i);
+        if (digits == i)
+            return false;
+        i = digits;
+    }
+    return i == input.size();
+}
+
+/* Return the compiled regular expression of a format. Formats are compiled
+   once and shared by all text boxes, since compiling dominates matching. */
+static const std::regex &compiledFormat(const std::string &format) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::unique_ptr<std::regex>> cache;
+
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = cache.find(format);
+    if (it == cache.end())
+        it = cache.emplace(format, std::unique_ptr<std::regex>(
+            new std::regex(format, std::regex::optimize))).first;
+    return *it->second;
+}
+
 bool TextBox::checkFormat(const std::string &input, const std::string &format) {
     if (format.empty())
         return true;
+    if (format == SignedIntegerFormat || format == UnsignedIntegerFormat)
+        return matchInteger(input, format == SignedIntegerFormat);
+    if (format == FloatFormat)
+        return matchFloat(input);
     try {
-        std::regex regex(format);
-        return regex_match(input, regex);
+        return regex_match(input, compiledFormat(format));
     } catch (const std::regex_error &) {
 #if __GNUC__ < 4 || (__GNUC__ == 4 && __GNUC_MINOR__ < 9)
         std::cerr << "Warning: cannot validate text field due to lacking regular expression support. please compile with GCC >= 4.9" << std::endl;
@@ -529,8 +605,11 @@ bool TextBox::copySelection() {
 void TextBox::pasteFromClipboard() {
     Screen *sc = dynamic_cast<Screen *>(this->window()->parent());
     const char* cbstr = ngGetClipboardString(sc);
-    if (cbstr)
-        mValueTemp.insert(mCursorPos, std::string(cbstr));
+    if (cbstr) {
+        std::string text(cbstr);
+        mValueTemp.insert(mCursorPos, text);
+        textEdited(mCursorPos, 0, (int) text.size());
+    }
 }
 
 bool TextBox::deleteSelection() {
@@ -547,6 +626,7 @@ bool TextBox::deleteSelection() {
             mValueTemp.erase(mValueTemp.begin() + begin,
                              mValueTemp.begin() + end);
 
+        textEdited(begin, end - begin, 0);
         mCursorPos = begin;
         mSelectionPos = -1;
         return true;
@@ -555,8 +635,100 @@ bool TextBox::deleteSelection() {
     return false;
 }
 
-void TextBox::updateCursor(NVGcontext *, float lastx,
-                           const NVGglyphPosition *glyphs, int size) {
+void TextBox::textEdited(int position, int removed, int inserted) {
+    if (!mGlyphsValid)
+        return;
+    if (mDirtyBegin < 0) {
+        mDirtyBegin = position;
+        mDirtyOldEnd = mDirtyNewEnd = position + removed;
+    } else {
+        if (position < mDirtyBegin)
+            mDirtyBegin = position;
+        if (position + removed > mDirtyNewEnd) {
+            mDirtyOldEnd += position + removed - mDirtyNewEnd;
+            mDirtyNewEnd = position + removed;
+        }
+    }
+    mDirtyNewEnd += inserted - removed;
+}
+
+void TextBox::updateGlyphs(NVGcontext *ctx) {
+    int length = (int) mValueTemp.size();
+    if (fontSize() != mGlyphFontSize) {
+        mGlyphFontSize = fontSize();
+        mGlyphsValid = false;
+    }
+    if (mGlyphsValid && mDirtyBegin < 0 && mGlyphOffsets.back() == length)
+        return;
+
+    nvgSave(ctx);
+    nvgFontSize(ctx, mGlyphFontSize);
+    nvgFontFace(ctx, "sans");
+    nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+
+    /* Lay out the bytes [begin, end) of the text, starting at x = 0;
+       returns the advance, and a text has at most one glyph per byte */
+    const char *text = mValueTemp.c_str();
+    std::vector<NVGglyphPosition> glyphs;
+    auto layout = [&](int begin, int end) {
+        glyphs.resize(std::max(end - begin, 1));
+        glyphs.resize(nvgTextGlyphPositions(ctx, 0, 0, text + begin, text + end,
+                                            glyphs.data(), (int) glyphs.size()));
+        return nvgTextBounds(ctx, 0, 0, text + begin, text + end, nullptr);
+    };
+
+    int n = glyphCount(), shift = mDirtyNewEnd - mDirtyOldEnd;
+    if (mGlyphsValid && mDirtyBegin >= 0 && n > 0 && length > 0 &&
+        mGlyphOffsets.back() + shift == length) {
+        /* The position of a glyph depends on the advance of its predecessor
+           and on the kerning of the two glyphs before it. Lay out again from
+           two glyphs before the edit (anchored to the unchanged position of
+           the second one) to two glyphs after it, and shift the rest. */
+        auto offsets = mGlyphOffsets.begin();
+        int first = (int) (std::upper_bound(offsets, offsets + n, mDirtyBegin) - offsets) - 1;
+        first = std::max(first - 2, 0);
+        int next = (int) (std::lower_bound(offsets, offsets + n, mDirtyOldEnd) - offsets);
+        int stop = std::min(next + 2, n);
+
+        float advance = layout(mGlyphOffsets[first], mGlyphOffsets[stop] + shift);
+        float anchor = first == 0 ? 0.f : mGlyphX[first + 1] - glyphs[1].x;
+
+        std::vector<int> newOffsets(offsets, offsets + first);
+        std::vector<float> newX(mGlyphX.begin(), mGlyphX.begin() + first);
+        for (size_t i = 0; i < glyphs.size(); ++i) {
+            newOffsets.push_back((int) (glyphs[i].str - text));
+            newX.push_back(i == 0 && first > 0 ? mGlyphX[first] : glyphs[i].x + anchor);
+        }
+        if (stop < n) {
+            float delta = newX.back() - mGlyphX[stop - 1];
+            for (int i = stop; i <= n; ++i) {
+                newOffsets.push_back(mGlyphOffsets[i] + shift);
+                newX.push_back(mGlyphX[i] + delta);
+            }
+        } else {
+            newOffsets.push_back(length);
+            newX.push_back(advance + anchor);
+        }
+        mGlyphOffsets.swap(newOffsets);
+        mGlyphX.swap(newX);
+    } else {
+        float advance = layout(0, length);
+        mGlyphOffsets.resize(glyphs.size() + 1);
+        mGlyphX.resize(glyphs.size() + 1);
+        for (size_t i = 0; i < glyphs.size(); ++i) {
+            mGlyphOffsets[i] = (int) (glyphs[i].str - text);
+            mGlyphX[i] = glyphs[i].x;
+        }
+        mGlyphOffsets.back() = length;
+        mGlyphX.back() = advance;
+    }
+    nvgRestore(ctx);
+
+    mGlyphsValid = true;
+    mDirtyBegin = mDirtyOldEnd = mDirtyNewEnd = -1;
+}
+
+void TextBox::updateCursor(float originX) {
     // handle mouse cursor events
     if (mMouseDownPos.x() != -1) {
         if (mMouseDownModifier == NG_MOD_SHIFT) {
@@ -565,51 +737,39 @@ void TextBox::updateCursor(NVGcontext *, float lastx,
         } else
             mSelectionPos = -1;
 
-        mCursorPos =
-            position2CursorIndex(mMouseDownPos.x(), lastx, glyphs, size);
+        mCursorPos = position2CursorIndex(mMouseDownPos.x(), originX);
 
         mMouseDownPos = Vector2i(-1, -1);
     } else if (mMouseDragPos.x() != -1) {
         if (mSelectionPos == -1)
             mSelectionPos = mCursorPos;
 
-        mCursorPos =
-            position2CursorIndex(mMouseDragPos.x(), lastx, glyphs, size);
+        mCursorPos = position2CursorIndex(mMouseDragPos.x(), originX);
     } else {
         // set cursor to last character
         if (mCursorPos == -2)
-            mCursorPos = size;
+            mCursorPos = glyphCount();
     }
 
     if (mCursorPos == mSelectionPos)
         mSelectionPos = -1;
 }
 
-float TextBox::cursorIndex2Position(int index, float lastx,
-                                    const NVGglyphPosition *glyphs, int size) {
-    float pos = 0;
-    if (index == size)
-        pos = lastx; // last character
-    else
-        pos = glyphs[index].x;
-
-    return pos;
+float TextBox::cursorIndex2Position(int index, float originX) const {
+    index = std::max(0, std::min(index, glyphCount()));
+    return originX + mGlyphX[index];
 }
 
-int TextBox::position2CursorIndex(float posx, float lastx,
-                                  const NVGglyphPosition *glyphs, int size) {
-    int mCursorId = 0;
-    float caretx = glyphs[mCursorId].x;
-    for (int j = 1; j < size; j++) {
-        if (std::abs(caretx - posx) > std::abs(glyphs[j].x - posx)) {
-            mCursorId = j;
-            caretx = glyphs[mCursorId].x;
-        }
-    }
-    if (std::abs(caretx - posx) > std::abs(lastx - posx))
-        mCursorId = size;
-
-    return mCursorId;
+int TextBox::position2CursorIndex(float posx, float originX) const {
+    // glyph positions are sorted: find the closest one by bisection
+    float x = posx - originX;
+    auto begin = mGlyphX.begin(), end = mGlyphX.end();
+    int index = (int) (std::lower_bound(begin, end, x) - begin);
+    if (index > glyphCount())
+        return glyphCount();
+    if (index > 0 && std::abs(mGlyphX[index - 1] - x) <= std::abs(mGlyphX[index] - x))
+        index--;
+    return index;
 }
 
 TextBox::SpinArea TextBox::spinArea(const Vector2i & pos) {
@@ -653,6 +813,7 @@ bool TextBox::load(Serializer &s) {
     if (!s.get("unitsImage", mUnitsImage)) return false;
     if (!s.get("validFormat", mValidFormat)) return false;
     if (!s.get("valueTemp", mValueTemp)) return false;
+    invalidateGlyphs();
     if (!s.get("cursorPos", mCursorPos)) return false;
     if (!s.get("selectionPos", mSelectionPos)) return false;
     mMousePos = mMouseDownPos = mMouseDragPos = Vector2i::Constant(-1);
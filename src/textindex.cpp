@@ -0,0 +1,133 @@
+/*
+    src/textindex.cpp -- Trigram index for case-insensitive substring
+    search over a list of strings
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/textindex.h>
+#include <algorithm>
+
+NAMESPACE_BEGIN(nanogui)
+
+static inline uint8_t foldCase(char c) {
+    uint8_t value = (uint8_t) c;
+    return (value >= 'A' && value <= 'Z') ? (uint8_t) (value + ('a' - 'A')) : value;
+}
+
+static inline uint32_t trigram(const char *str) {
+    return ((uint32_t) foldCase(str[0]) << 16) |
+           ((uint32_t) foldCase(str[1]) << 8) |
+            (uint32_t) foldCase(str[2]);
+}
+
+static bool containsIgnoreCase(const std::string &str, const std::string &query) {
+    auto it = std::search(str.begin(), str.end(), query.begin(), query.end(),
+        [](char a, char b) { return foldCase(a) == foldCase(b); });
+    return it != str.end() || query.empty();
+}
+
+TextIndex::TextIndex() : mItemCount(0) { }
+
+void TextIndex::clear() {
+    mItemCount = 0;
+    mTrigrams.clear();
+    mOffsets.clear();
+    mPostings.clear();
+}
+
+void TextIndex::build(const std::vector<std::string> &items) {
+    clear();
+    mItemCount = items.size();
+
+    /* Collect (trigram, item) pairs and sort them, which groups the entries
+       of each trigram in ascending item order */
+    std::vector<uint64_t> pairs;
+    size_t total = 0;
+    for (const auto &item : items)
+        total += item.size() >= 3 ? item.size() - 2 : 0;
+    pairs.reserve(total);
+    for (size_t i = 0; i < items.size(); ++i) {
+        const std::string &item = items[i];
+        for (size_t j = 0; j + 3 <= item.size(); ++j)
+            pairs.push_back(((uint64_t) trigram(item.data() + j) << 32) | (uint64_t) i);
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    mPostings.reserve(pairs.size());
+    for (uint64_t pair : pairs) {
+        uint32_t gram = (uint32_t) (pair >> 32);
+        if (mTrigrams.empty() || mTrigrams.back() != gram) {
+            mTrigrams.push_back(gram);
+            mOffsets.push_back((uint32_t) mPostings.size());
+        }
+        mPostings.push_back((int) (uint32_t) pair);
+    }
+    mOffsets.push_back((uint32_t) mPostings.size());
+}
+
+void TextIndex::find(const std::vector<std::string> &items, const std::string &query,
+                     std::vector<int> &result) const {
+    result.clear();
+    if (query.size() < 3) {
+        for (size_t i = 0; i < items.size(); ++i)
+            if (containsIgnoreCase(items[i], query))
+                result.push_back((int) i);
+        return;
+    }
+
+    if (items.size() != mItemCount)
+        throw std::runtime_error("TextIndex::find(): the index is out of date!");
+
+    /* Look up the entry lists of all distinct trigrams of the query */
+    typedef std::pair<const int *, const int *> Range;
+    std::vector<uint32_t> grams;
+    for (size_t j = 0; j + 3 <= query.size(); ++j)
+        grams.push_back(trigram(query.data() + j));
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    std::vector<Range> ranges;
+    for (uint32_t gram : grams) {
+        auto it = std::lower_bound(mTrigrams.begin(), mTrigrams.end(), gram);
+        if (it == mTrigrams.end() || *it != gram)
+            return;
+        size_t index = (size_t) (it - mTrigrams.begin());
+        ranges.emplace_back(mPostings.data() + mOffsets[index],
+                            mPostings.data() + mOffsets[index + 1]);
+    }
+    std::sort(ranges.begin(), ranges.end(), [](const Range &a, const Range &b) {
+        return a.second - a.first < b.second - b.first;
+    });
+
+    /* Intersect, starting with the shortest list */
+    result.assign(ranges[0].first, ranges[0].second);
+    for (size_t k = 1; k < ranges.size() && !result.empty(); ++k) {
+        const int *begin = ranges[k].first, *end = ranges[k].second;
+        auto out = result.begin();
+        for (int item : result) {
+            begin = std::lower_bound(begin, end, item);
+            if (begin == end)
+                break;
+            if (*begin == item)
+                *out++ = item;
+        }
+        result.erase(out, result.end());
+    }
+
+    /* Trigrams may match out of order; confirm the remaining candidates */
+    if (query.size() > 3) {
+        auto out = std::remove_if(result.begin(), result.end(), [&](int item) {
+            return !containsIgnoreCase(items[item], query);
+        });
+        result.erase(out, result.end());
+    }
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,425 @@
+/*
+    src/treeview.cpp -- Virtualized tree that loads the children of a
+    node only when it is expanded
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/treeview.h>
+#include <nanogui/theme.h>
+#include <nanogui/opengl.h>
+#include <nanogui/entypo.h>
+#include <nanogui/serializer/core.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+TreeView::TreeView(Widget *parent)
+    : Widget(parent), mRootId(0), mTreapRoot(-1), mRandomState(0x9E3779B9u),
+      mSelected(-1), mRowHeight(22), mIndentation(16), mScrollOffset(0) {
+    reload();
+}
+
+int TreeView::createNode(NodeId id, int parent, int indexInParent) {
+    /* xorshift32: treap priorities only need to look random */
+    mRandomState ^= mRandomState << 13;
+    mRandomState ^= mRandomState >> 17;
+    mRandomState ^= mRandomState << 5;
+
+    Node node;
+    node.id = id;
+    node.parent = parent;
+    node.depth = parent < 0 ? -1 : mNodes[parent].depth + 1;
+    node.indexInParent = indexInParent;
+    node.loaded = false;
+    node.expanded = false;
+    node.hasChildren = -1;
+    node.labelValid = false;
+    node.left = node.right = node.up = -1;
+    node.size = 1;
+    node.priority = mRandomState;
+    mNodes.push_back(std::move(node));
+    return (int) mNodes.size() - 1;
+}
+
+void TreeView::reload() {
+    mNodes.clear();
+    mSelected = -1;
+    mScrollOffset = 0;
+
+    int root = createNode(mRootId, -1, 0);
+    loadChildren(root);
+    mNodes[root].expanded = true;
+    mTreapRoot = treapBuild(mNodes[root].children);
+}
+
+void TreeView::invalidateLabels() {
+    for (auto &node : mNodes)
+        node.labelValid = false;
+}
+
+void TreeView::loadChildren(int index) {
+    if (mNodes[index].loaded)
+        return;
+    mNodes[index].loaded = true;
+    if (!mChildrenCallback)
+        return;
+
+    std::vector<NodeId> ids = mChildrenCallback(mNodes[index].id);
+    std::vector<int> children;
+    children.reserve(ids.size());
+    mNodes.reserve(mNodes.size() + ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+        children.push_back(createNode(ids[i], index, (int) i));
+    mNodes[index].children = std::move(children);
+    mNodes[index].hasChildren = mNodes[index].children.empty() ? 0 : 1;
+}
+
+bool TreeView::hasChildren(int index) {
+    Node &node = mNodes[index];
+    if (node.hasChildren < 0)
+        node.hasChildren = mHasChildrenCallback ? (mHasChildrenCallback(node.id) ? 1 : 0) : 1;
+    return node.hasChildren != 0;
+}
+
+void TreeView::expandNode(int index) {
+    if (mNodes[index].expanded)
+        return;
+    loadChildren(index);
+    if (mNodes[index].children.empty())
+        return;
+    mNodes[index].expanded = true;
+
+    /* Rows of the visible subtree in pre-order (descendants that were expanded
+       before keep their state) */
+    std::vector<int> rows, stack(mNodes[index].children.rbegin(),
+                                 mNodes[index].children.rend());
+    while (!stack.empty()) {
+        int current = stack.back();
+        stack.pop_back();
+        rows.push_back(current);
+        const Node &node = mNodes[current];
+        if (node.expanded)
+            stack.insert(stack.end(), node.children.rbegin(), node.children.rend());
+    }
+
+    int row = rowOfNode(index), left, right;
+    treapSplit(mTreapRoot, row + 1, left, right);
+    mTreapRoot = treapMerge(treapMerge(left, treapBuild(rows)), right);
+    mNodes[mTreapRoot].up = -1;
+}
+
+void TreeView::collapseNode(int index) {
+    if (!mNodes[index].expanded)
+        return;
+
+    /* The subtree ends where the next node outside of it (in pre-order) starts */
+    int begin = rowOfNode(index) + 1, end = rowCount();
+    for (int current = index; mNodes[current].parent >= 0; current = mNodes[current].parent) {
+        const Node &parent = mNodes[mNodes[current].parent];
+        int next = mNodes[current].indexInParent + 1;
+        if (next < (int) parent.children.size()) {
+            end = rowOfNode(parent.children[next]);
+            break;
+        }
+    }
+    mNodes[index].expanded = false;
+
+    int left, middle, right;
+    treapSplit(mTreapRoot, begin, left, right);
+    treapSplit(right, end - begin, middle, right);
+    mTreapRoot = treapMerge(left, right);
+    if (mTreapRoot >= 0)
+        mNodes[mTreapRoot].up = -1;
+}
+
+void TreeView::setExpanded(int row, bool expanded) {
+    if (row < 0 || row >= rowCount())
+        return;
+    int index = nodeIndexAt(row);
+    if (expanded)
+        expandNode(index);
+    else
+        collapseNode(index);
+    setScrollOffset(mScrollOffset);
+}
+
+int TreeView::selectedRow() const {
+    if (mSelected < 0)
+        return -1;
+    /* Only nodes whose ancestors are all expanded have a row */
+    for (int current = mNodes[mSelected].parent; current >= 0; current = mNodes[current].parent)
+        if (!mNodes[current].expanded)
+            return -1;
+    return rowOfNode(mSelected);
+}
+
+void TreeView::setSelectedRow(int row) {
+    mSelected = (row >= 0 && row < rowCount()) ? nodeIndexAt(row) : -1;
+}
+
+int TreeView::nodeIndexAt(int row) const {
+    int t = mTreapRoot;
+    while (t >= 0) {
+        int leftSize = treapSize(mNodes[t].left);
+        if (row < leftSize) {
+            t = mNodes[t].left;
+        } else if (row == leftSize) {
+            return t;
+        } else {
+            row -= leftSize + 1;
+            t = mNodes[t].right;
+        }
+    }
+    throw std::out_of_range("TreeView::nodeIndexAt(): row is out of range!");
+}
+
+int TreeView::rowOfNode(int index) const {
+    int row = treapSize(mNodes[index].left);
+    for (int t = index; mNodes[t].up >= 0; t = mNodes[t].up) {
+        const Node &up = mNodes[mNodes[t].up];
+        if (up.right == t)
+            row += treapSize(up.left) + 1;
+    }
+    return row;
+}
+
+void TreeView::treapUpdate(int t) {
+    Node &node = mNodes[t];
+    node.size = 1 + treapSize(node.left) + treapSize(node.right);
+    if (node.left >= 0)
+        mNodes[node.left].up = t;
+    if (node.right >= 0)
+        mNodes[node.right].up = t;
+}
+
+int TreeView::treapMerge(int a, int b) {
+    if (a < 0)
+        return b;
+    if (b < 0)
+        return a;
+    if (mNodes[a].priority > mNodes[b].priority) {
+        mNodes[a].right = treapMerge(mNodes[a].right, b);
+        treapUpdate(a);
+        return a;
+    } else {
+        mNodes[b].left = treapMerge(a, mNodes[b].left);
+        treapUpdate(b);
+        return b;
+    }
+}
+
+void TreeView::treapSplit(int t, int count, int &left, int &right) {
+    if (t < 0) {
+        left = right = -1;
+        return;
+    }
+    int leftSize = treapSize(mNodes[t].left);
+    if (leftSize < count) {
+        int l, r;
+        treapSplit(mNodes[t].right, count - leftSize - 1, l, r);
+        mNodes[t].right = l;
+        treapUpdate(t);
+        left = t;
+        right = r;
+    } else {
+        int l, r;
+        treapSplit(mNodes[t].left, count, l, r);
+        mNodes[t].left = r;
+        treapUpdate(t);
+        left = l;
+        right = t;
+    }
+    if (left >= 0)
+        mNodes[left].up = -1;
+    if (right >= 0)
+        mNodes[right].up = -1;
+}
+
+int TreeView::treapBuild(const std::vector<int> &indices) {
+    /* Linear-time Cartesian tree construction over the priorities */
+    std::vector<int> stack;
+    for (int index : indices) {
+        Node &node = mNodes[index];
+        node.left = node.right = node.up = -1;
+        int last = -1;
+        while (!stack.empty() && mNodes[stack.back()].priority < node.priority) {
+            last = stack.back();
+            stack.pop_back();
+        }
+        node.left = last;
+        if (!stack.empty())
+            mNodes[stack.back()].right = index;
+        stack.push_back(index);
+    }
+    if (stack.empty())
+        return -1;
+
+    /* Compute the subtree sizes and parent links bottom-up (post-order) */
+    std::vector<std::pair<int, bool>> todo { { stack.front(), false } };
+    while (!todo.empty()) {
+        auto item = todo.back();
+        todo.pop_back();
+        if (item.second) {
+            treapUpdate(item.first);
+            continue;
+        }
+        todo.emplace_back(item.first, true);
+        const Node &node = mNodes[item.first];
+        if (node.left >= 0)
+            todo.emplace_back(node.left, false);
+        if (node.right >= 0)
+            todo.emplace_back(node.right, false);
+    }
+    mNodes[stack.front()].up = -1;
+    return stack.front();
+}
+
+void TreeView::setScrollOffset(int offset) {
+    int maxOffset = std::max(rowCount() * mRowHeight - mSize.y(), 0);
+    mScrollOffset = std::max(0, std::min(offset, maxOffset));
+}
+
+void TreeView::scrollToRow(int row) {
+    int top = row * mRowHeight, bottom = top + mRowHeight;
+    if (top < mScrollOffset)
+        setScrollOffset(top);
+    else if (bottom > mScrollOffset + mSize.y())
+        setScrollOffset(bottom - mSize.y());
+}
+
+Vector2i TreeView::preferredSize(NVGcontext *) const {
+    return Vector2i(200, std::min(rowCount(), 10) * mRowHeight);
+}
+
+bool TreeView::mouseButtonEvent(const Vector2i &p, int button, bool down,
+                                int modifiers) {
+    if (button != NG_MOUSE_BUTTON_1 || !down)
+        return Widget::mouseButtonEvent(p, button, down, modifiers);
+
+    Vector2i local = p - mPos;
+    int row = (local.y() + mScrollOffset) / mRowHeight;
+    if (row >= rowCount() || local.x() >= mSize.x() - 12)
+        return true;
+
+    int index = nodeIndexAt(row);
+    int expanderX = 4 + mNodes[index].depth * mIndentation;
+    if (local.x() >= expanderX && local.x() < expanderX + mIndentation &&
+        hasChildren(index)) {
+        setExpanded(row, !mNodes[index].expanded);
+    } else if (index != mSelected) {
+        mSelected = index;
+        if (mSelectionCallback)
+            mSelectionCallback(mNodes[index].id);
+    }
+    return true;
+}
+
+bool TreeView::mouseDragEvent(const Vector2i &, const Vector2i &rel,
+                              int, int) {
+    int content = rowCount() * mRowHeight;
+    if (content <= mSize.y())
+        return false;
+    float scrollh = height() * std::min(1.0f, height() / (float) content);
+    float delta = rel.y() / (float) (mSize.y() - 8 - scrollh);
+    setScrollOffset(mScrollOffset + (int) std::round(delta * (content - mSize.y())));
+    return true;
+}
+
+bool TreeView::scrollEvent(const Vector2i &, const Vector2f &rel) {
+    if (rowCount() * mRowHeight <= mSize.y())
+        return false;
+    setScrollOffset(mScrollOffset - (int) std::round(rel.y() * 3 * mRowHeight));
+    return true;
+}
+
+void TreeView::draw(NVGcontext *ctx) {
+    Widget::draw(ctx);
+    setScrollOffset(mScrollOffset);
+
+    int count = rowCount(), content = count * mRowHeight;
+    int first = mScrollOffset / mRowHeight;
+    int last = std::min(count, (mScrollOffset + mSize.y() + mRowHeight - 1) / mRowHeight);
+
+    nvgSave(ctx);
+    nvgTranslate(ctx, mPos.x(), mPos.y());
+    nvgIntersectScissor(ctx, 0, 0, mSize.x(), mSize.y());
+
+    nvgBeginPath(ctx);
+    nvgRect(ctx, 0, 0, mSize.x(), mSize.y());
+    nvgFillColor(ctx, Color(0, 32));
+    nvgFill(ctx);
+
+    /* Look up the visible nodes once, then draw them in two batches that
+       share the font state */
+    std::vector<int> visible;
+    visible.reserve(std::max(last - first, 0));
+    for (int row = first; row < last; ++row)
+        visible.push_back(nodeIndexAt(row));
+
+    float width = (float) (content > mSize.y() ? mSize.x() - 12 : mSize.x());
+    for (int i = 0; i < (int) visible.size(); ++i) {
+        if (visible[i] != mSelected)
+            continue;
+        nvgBeginPath(ctx);
+        nvgRect(ctx, 0, (first + i) * mRowHeight - mScrollOffset, width, mRowHeight);
+        nvgFillColor(ctx, Color(255, 40));
+        nvgFill(ctx);
+    }
+
+    nvgFontSize(ctx, fontSize() * 1.2f);
+    nvgFontFace(ctx, "icons");
+    nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+    nvgFillColor(ctx, mTheme->mIconColor);
+    for (int i = 0; i < (int) visible.size(); ++i) {
+        int index = visible[i];
+        if (!hasChildren(index))
+            continue;
+        auto icon = utf8(mNodes[index].expanded ? ENTYPO_ICON_CHEVRON_SMALL_DOWN
+                                                : ENTYPO_ICON_CHEVRON_SMALL_RIGHT);
+        nvgText(ctx, 4.f + mNodes[index].depth * mIndentation,
+                (first + i + 0.5f) * mRowHeight - mScrollOffset, icon.data(), nullptr);
+    }
+
+    nvgFontSize(ctx, fontSize());
+    nvgFontFace(ctx, "sans");
+    nvgFillColor(ctx, mEnabled ? mTheme->mTextColor : mTheme->mDisabledTextColor);
+    for (int i = 0; i < (int) visible.size(); ++i) {
+        Node &node = mNodes[visible[i]];
+        if (!node.labelValid) {
+            node.label = mLabelCallback ? mLabelCallback(node.id) : std::to_string(node.id);
+            node.labelValid = true;
+        }
+        nvgText(ctx, 4.f + (node.depth + 1) * mIndentation,
+                (first + i + 0.5f) * mRowHeight - mScrollOffset, node.label.c_str(), nullptr);
+    }
+
+    if (content > mSize.y()) {
+        float scrollh = height() * std::min(1.0f, height() / (float) content);
+        float scroll = mScrollOffset / (float) (content - mSize.y());
+        drawScrollBar(ctx, mSize.x() - 12.f, 4.f, mSize.y() - 8.f, scrollh, scroll, true);
+    }
+
+    nvgRestore(ctx);
+}
+
+void TreeView::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("rowHeight", mRowHeight);
+    s.set("indentation", mIndentation);
+    s.set("scrollOffset", mScrollOffset);
+}
+
+bool TreeView::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    if (!s.get("rowHeight", mRowHeight)) return false;
+    if (!s.get("indentation", mIndentation)) return false;
+    if (!s.get("scrollOffset", mScrollOffset)) return false;
+    return true;
+}
+
+NAMESPACE_END(nanogui)
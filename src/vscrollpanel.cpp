@@ -17,12 +17,29 @@
 
 NAMESPACE_BEGIN(nanogui)
 
+/* Rate (1/s) at which smooth scrolling approaches its target */
+static const float SmoothScrollRate = 20.f;
+/* Exponential decay (1/s) of the kinetic scrolling velocity */
+static const float KineticFriction = 4.f;
+
+static float clampScroll(float value) {
+    return std::max(0.f, std::min(1.f, value));
+}
+
 VScrollPanel::VScrollPanel(Widget *parent)
-    : Widget(parent), mChildPreferredHeight(0), mScroll(0.0f), mUpdateLayout(false) { }
+    : Widget(parent), mChildPreferredHeight(0), mScroll(0.0f),
+      mScrollTarget(0.0f), mVelocity(0.0f), mLastAnimationTime(0.0),
+      mLastDragTime(0.0), mUpdateLayout(true), mSmoothScrolling(false),
+      mKineticScrolling(false), mDragging(false) { }
+
+void VScrollPanel::setScroll(float scroll) {
+    mScroll = mScrollTarget = clampScroll(scroll);
+    mVelocity = 0.f;
+    updateChildPosition();
+}
 
 void VScrollPanel::performLayout(NVGcontext *ctx) {
-    Widget::performLayout(ctx);
-
+    mUpdateLayout = false;
     if (mChildren.empty())
         return;
     if (mChildren.size() > 1)
@@ -32,13 +49,12 @@ void VScrollPanel::performLayout(NVGcontext *ctx) {
     mChildPreferredHeight = child->preferredSize(ctx).y();
 
     if (mChildPreferredHeight > mSize.y()) {
-        child->setPosition(Vector2i(0, -mScroll*(mChildPreferredHeight - mSize.y())));
         child->setSize(Vector2i(mSize.x()-12, mChildPreferredHeight));
     } else {
-        child->setPosition(Vector2i::Zero());
         child->setSize(mSize);
-        mScroll = 0;
+        mScroll = mScrollTarget = mVelocity = 0;
     }
+    updateChildPosition();
     child->performLayout(ctx);
 }
 
@@ -48,15 +64,72 @@ Vector2i VScrollPanel::preferredSize(NVGcontext *ctx) const {
     return mChildren[0]->preferredSize(ctx) + Vector2i(12, 0);
 }
 
+void VScrollPanel::updateChildPosition() {
+    if (mChildren.empty())
+        return;
+    int offset = mChildPreferredHeight > mSize.y() ?
+        (int) (-mScroll*(mChildPreferredHeight - mSize.y())) : 0;
+    mChildren[0]->setPosition(Vector2i(0, offset));
+}
+
+void VScrollPanel::animate() {
+    double now = ngGetTime();
+    float dt = (float) std::min(now - mLastAnimationTime, 0.1);
+    mLastAnimationTime = now;
+
+    if (mKineticScrolling && !mDragging && mVelocity != 0.f) {
+        mScrollTarget = clampScroll(mScrollTarget + mVelocity * dt);
+        mVelocity *= std::exp(-KineticFriction * dt);
+        if (std::abs(mVelocity) < 1e-3f || mScrollTarget == 0.f || mScrollTarget == 1.f)
+            mVelocity = 0.f;
+        if (!mSmoothScrolling)
+            mScroll = mScrollTarget;
+    }
+
+    if (mScroll != mScrollTarget) {
+        if (mSmoothScrolling) {
+            mScroll += (mScrollTarget - mScroll) * (1.f - std::exp(-SmoothScrollRate * dt));
+            if (std::abs(mScrollTarget - mScroll) * mChildPreferredHeight < 0.5f)
+                mScroll = mScrollTarget;
+        } else {
+            mScroll = mScrollTarget;
+        }
+    }
+}
+
+bool VScrollPanel::mouseButtonEvent(const Vector2i &p, int button, bool down,
+                                    int modifiers) {
+    if (button == NG_MOUSE_BUTTON_1) {
+        if (down) {
+            /* Grabbing the content stops any kinetic motion */
+            mVelocity = 0.f;
+        } else if (mDragging) {
+            mDragging = false;
+            if (ngGetTime() - mLastDragTime > 0.1)
+                mVelocity = 0.f;
+        }
+    }
+    return Widget::mouseButtonEvent(p, button, down, modifiers);
+}
+
 bool VScrollPanel::mouseDragEvent(const Vector2i &p, const Vector2i &rel,
                             int button, int modifiers) {
     if (!mChildren.empty() && mChildPreferredHeight > mSize.y()) {
         float scrollh = height() *
             std::min(1.0f, height() / (float)mChildPreferredHeight);
 
-        mScroll = std::max((float) 0.0f, std::min((float) 1.0f,
-                     mScroll + rel.y() / (float)(mSize.y() - 8 - scrollh)));
-        mUpdateLayout = true;
+        float delta = rel.y() / (float)(mSize.y() - 8 - scrollh);
+        float scroll = clampScroll(mScroll + delta);
+
+        double now = ngGetTime();
+        float dt = (float) (now - mLastDragTime);
+        if (mDragging && dt > 0.f)
+            mVelocity = 0.8f * (scroll - mScroll) / dt + 0.2f * mVelocity;
+        mLastDragTime = now;
+        mDragging = true;
+
+        mScroll = mScrollTarget = scroll;
+        updateChildPosition();
         return true;
     } else {
         return Widget::mouseDragEvent(p, rel, button, modifiers);
@@ -69,26 +142,39 @@ bool VScrollPanel::scrollEvent(const Vector2i &p, const Vector2f &rel) {
         float scrollh = height() *
             std::min(1.0f, height() / (float)mChildPreferredHeight);
 
-        mScroll = std::max((float) 0.0f, std::min((float) 1.0f,
-                mScroll - scrollAmount / (float)(mSize.y() - 8 - scrollh)));
-        mUpdateLayout = true;
+        mVelocity = 0.f;
+        mScrollTarget = clampScroll(
+            mScrollTarget - scrollAmount / (float)(mSize.y() - 8 - scrollh));
+        if (!mSmoothScrolling) {
+            mScroll = mScrollTarget;
+            updateChildPosition();
+        }
         return true;
     } else {
         return Widget::scrollEvent(p, rel);
     }
 }
 
+bool VScrollPanel::needsRedraw() {
+    return mScroll != mScrollTarget ||
+           (mKineticScrolling && !mDragging && mVelocity != 0.f);
+}
+
 void VScrollPanel::draw(NVGcontext *ctx) {
     if (mChildren.empty())
         return;
     Widget *child = mChildren[0];
-    child->setPosition(Vector2i(0, -mScroll*(mChildPreferredHeight - mSize.y())));
-    mChildPreferredHeight = child->preferredSize(ctx).y();
-    float scrollh = height() *
-        std::min(1.0f, height() / (float) mChildPreferredHeight);
 
+    /* Only re-measure the content when it was marked as dirty; scrolling
+       merely translates the child */
     if (mUpdateLayout)
-        child->performLayout(ctx);
+        performLayout(ctx);
+
+    animate();
+    updateChildPosition();
+
+    float scrollh = height() *
+        std::min(1.0f, height() / (float) mChildPreferredHeight);
 
     nvgSave(ctx);
     nvgTranslate(ctx, mPos.x(), mPos.y());
@@ -100,26 +186,8 @@ void VScrollPanel::draw(NVGcontext *ctx) {
     if (mChildPreferredHeight <= mSize.y())
         return;
 
-    NVGpaint paint = nvgBoxGradient(
-        ctx, mPos.x() + mSize.x() - 12 + 1, mPos.y() + 4 + 1, 8,
-        mSize.y() - 8, 3, 4, Color(0, 32), Color(0, 92));
-    nvgBeginPath(ctx);
-    nvgRoundedRect(ctx, mPos.x() + mSize.x() - 12, mPos.y() + 4, 8,
-                   mSize.y() - 8, 3);
-    nvgFillPaint(ctx, paint);
-    nvgFill(ctx);
-
-    paint = nvgBoxGradient(
-        ctx, mPos.x() + mSize.x() - 12 - 1,
-        mPos.y() + 4 + (mSize.y() - 8 - scrollh) * mScroll - 1, 8, scrollh,
-        3, 4, Color(220, 100), Color(128, 100));
-
-    nvgBeginPath(ctx);
-    nvgRoundedRect(ctx, mPos.x() + mSize.x() - 12 + 1,
-                   mPos.y() + 4 + 1 + (mSize.y() - 8 - scrollh) * mScroll, 8 - 2,
-                   scrollh - 2, 2);
-    nvgFillPaint(ctx, paint);
-    nvgFill(ctx);
+    drawScrollBar(ctx, mPos.x() + mSize.x() - 12.f, mPos.y() + 4.f, mSize.y() - 8.f,
+                  scrollh, mScroll, true);
 }
 
 void VScrollPanel::save(Serializer &s) const {
@@ -132,6 +200,9 @@ bool VScrollPanel::load(Serializer &s) {
     if (!Widget::load(s)) return false;
     if (!s.get("childPreferredHeight", mChildPreferredHeight)) return false;
     if (!s.get("scroll", mScroll)) return false;
+    mScrollTarget = mScroll;
+    mVelocity = 0.f;
+    mUpdateLayout = true;
     return true;
 }
 
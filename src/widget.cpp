@@ -19,12 +19,16 @@
 
 NAMESPACE_BEGIN(nanogui)
 
+Screen *Widget::sDrawingScreen = nullptr;
+
 Widget::Widget(Widget *parent)
     : mParent(nullptr), mTheme(nullptr), mLayout(nullptr),
       mPos(Vector2i::Zero()), mSize(Vector2i::Zero()),
       mFixedSize(Vector2i::Zero()), mVisible(true), mEnabled(true),
       mFocused(false), mMouseFocus(false), mTooltip(""), mFontSize(-1.0f),
-      mCursor(Cursor::Arrow) {
+      mCursor(Cursor::Arrow), mSpatialIndexDirty(true),
+      mAbsolutePos(Vector2i::Zero()), mClipPos(Vector2i::Zero()),
+      mClipSize(Vector2i::Zero()), mGeometryDirty(true) {
     if (parent)
         parent->addChild(this);
 }
@@ -70,51 +74,126 @@ void Widget::performLayout(NVGcontext *ctx) {
     }
 }
 
-Widget *Widget::findWidget(const Vector2i &p) {
-    for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
-        Widget *child = *it;
-        if (child->visible() && child->contains(p - mPos))
-            return child->findWidget(p - mPos);
+/* Visit the children that may contain one of the points \c p1 and \c p2
+   (topmost first) until \c f returns \c true. Without a spatial index,
+   all children are visited. */
+template <typename Func>
+static bool visitChildren(const std::vector<Widget *> &children,
+                          const SpatialIndex *index, const Vector2i &p1,
+                          const Vector2i &p2, Func f) {
+    if (!index) {
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+            if (f(*it))
+                return true;
+        return false;
+    }
+
+    /* Merge the (ascending) candidate lists of both points in reverse */
+    SpatialIndex::Range r1 = index->query(p1), r2 = index->query(p2);
+    const int *it1 = r1.second, *it2 = r2.second;
+    while (it1 != r1.first || it2 != r2.first) {
+        int i1 = it1 != r1.first ? it1[-1] : -1;
+        int i2 = it2 != r2.first ? it2[-1] : -1;
+        int i = std::max(i1, i2);
+        if (i1 == i)
+            --it1;
+        if (i2 == i)
+            --it2;
+        if (i < (int) children.size() && f(children[i]))
+            return true;
+    }
+    return false;
+}
+
+void Widget::setSpatialIndex(bool enabled) {
+    if (enabled == spatialIndex())
+        return;
+    mSpatialIndex.reset(enabled ? new SpatialIndex() : nullptr);
+    mSpatialIndexDirty = true;
+}
+
+const SpatialIndex *Widget::updateSpatialIndex() {
+    if (mSpatialIndex && mSpatialIndexDirty) {
+        mSpatialIndex->build(mChildren);
+        mSpatialIndexDirty = false;
+    }
+    return mSpatialIndex.get();
+}
+
+void Widget::invalidateGeometry() {
+    if (mGeometryDirty)
+        return;
+    mGeometryDirty = true;
+    for (auto child : mChildren)
+        child->invalidateGeometry();
+}
+
+void Widget::updateGeometry() const {
+    if (!mGeometryDirty)
+        return;
+    if (mParent) {
+        mParent->updateGeometry();
+        mAbsolutePos = mParent->mAbsolutePos + mPos;
+        Vector2i clipMin = mAbsolutePos.cwiseMax(mParent->mClipPos),
+                 clipMax = (mAbsolutePos + mSize).cwiseMin(mParent->mClipPos + mParent->mClipSize);
+        mClipPos = clipMin;
+        mClipSize = (clipMax - clipMin).cwiseMax(Vector2i::Zero());
+        if (mClipSize.x() == 0 || mClipSize.y() == 0)
+            mClipSize = Vector2i::Zero();
+    } else {
+        mAbsolutePos = mClipPos = mPos;
+        mClipSize = mSize;
     }
+    mGeometryDirty = false;
+}
+
+Widget *Widget::findWidget(const Vector2i &p) {
+    Widget *result = nullptr;
+    visitChildren(mChildren, updateSpatialIndex(), p - mPos, p - mPos,
+        [&](Widget *child) {
+            if (child->visible() && child->contains(p - mPos)) {
+                result = child->findWidget(p - mPos);
+                return true;
+            }
+            return false;
+        });
+    if (result)
+        return result;
     return contains(p) ? this : nullptr;
 }
 
 bool Widget::mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) {
-    for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
-        Widget *child = *it;
-        if (child->visible() && child->contains(p - mPos) &&
-            child->mouseButtonEvent(p - mPos, button, down, modifiers))
-            return true;
-    }
+    bool handled = visitChildren(mChildren, updateSpatialIndex(), p - mPos, p - mPos,
+        [&](Widget *child) {
+            return child->visible() && child->contains(p - mPos) &&
+                   child->mouseButtonEvent(p - mPos, button, down, modifiers);
+        });
+    if (handled)
+        return true;
     if (button == NG_MOUSE_BUTTON_1 && down && !mFocused)
         requestFocus();
     return false;
 }
 
 bool Widget::mouseMotionEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) {
-    for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
-        Widget *child = *it;
-        if (!child->visible())
-            continue;
-        bool contained = child->contains(p - mPos), prevContained = child->contains(p - mPos - rel);
-        if (contained != prevContained)
-            child->mouseEnterEvent(p, contained);
-        if ((contained || prevContained) &&
-            child->mouseMotionEvent(p - mPos, rel, button, modifiers))
-            return true;
-    }
-    return false;
+    return visitChildren(mChildren, updateSpatialIndex(), p - mPos, p - mPos - rel,
+        [&](Widget *child) {
+            if (!child->visible())
+                return false;
+            bool contained = child->contains(p - mPos), prevContained = child->contains(p - mPos - rel);
+            if (contained != prevContained)
+                child->mouseEnterEvent(p, contained);
+            return (contained || prevContained) &&
+                   child->mouseMotionEvent(p - mPos, rel, button, modifiers);
+        });
 }
 
 bool Widget::scrollEvent(const Vector2i &p, const Vector2f &rel) {
-    for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
-        Widget *child = *it;
-        if (!child->visible())
-            continue;
-        if (child->contains(p - mPos) && child->scrollEvent(p - mPos, rel))
-            return true;
-    }
-    return false;
+    return visitChildren(mChildren, updateSpatialIndex(), p - mPos, p - mPos,
+        [&](Widget *child) {
+            return child->visible() && child->contains(p - mPos) &&
+                   child->scrollEvent(p - mPos, rel);
+        });
 }
 
 bool Widget::mouseDragEvent(const Vector2i &, const Vector2i &, int, int) {
@@ -122,7 +201,10 @@ bool Widget::mouseDragEvent(const Vector2i &, const Vector2i &, int, int) {
 }
 
 bool Widget::mouseEnterEvent(const Vector2i &, bool enter) {
-    mMouseFocus = enter;
+    if (mMouseFocus != enter) {
+        mMouseFocus = enter;
+        invalidateLayers();
+    }
     return false;
 }
 
@@ -142,6 +224,7 @@ bool Widget::keyboardCharacterEvent(unsigned int) {
 void Widget::addChild(int index, Widget * widget) {
     assert(index <= childCount());
     mChildren.insert(mChildren.begin() + index, widget);
+    mSpatialIndexDirty = true;
     widget->incRef();
     widget->setParent(this);
     widget->setTheme(mTheme);
@@ -153,12 +236,14 @@ void Widget::addChild(Widget * widget) {
 
 void Widget::removeChild(const Widget *widget) {
     mChildren.erase(std::remove(mChildren.begin(), mChildren.end(), widget), mChildren.end());
+    mSpatialIndexDirty = true;
     widget->decRef();
 }
 
 void Widget::removeChild(int index) {
     Widget *widget = mChildren[index];
     mChildren.erase(mChildren.begin() + index);
+    mSpatialIndexDirty = true;
     widget->decRef();
 }
 
@@ -182,6 +267,14 @@ Window *Widget::window() {
     }
 }
 
+void Widget::invalidateLayers() {
+    for (Widget *widget = this; widget; widget = widget->parent()) {
+        Window *window = dynamic_cast<Window *>(widget);
+        if (window)
+            window->invalidateLayer();
+    }
+}
+
 void Widget::requestFocus() {
     Widget *widget = this;
     while (widget->parent())
@@ -201,16 +294,56 @@ void Widget::draw(NVGcontext *ctx) {
     if (mChildren.empty())
         return;
 
+    /* Top-level widgets (windows, popups) may update their placement while
+       drawing, hence only their descendants are culled */
+    bool cull = mParent != nullptr;
+    int culled = 0;
+
+    /* Subclasses draw in parent-relative coordinates, hence the translation
+       per container stays; the cached absolute geometry only drives culling.
+       The scissor is intersected with the one of the ancestors rather than
+       replacing it, so that nothing is drawn outside of an ancestor (e.g. the
+       content of a scrolled VScrollPanel) and drawing agrees with culling */
     nvgSave(ctx);
     nvgTranslate(ctx, mPos.x(), mPos.y());
-    nvgScissor(ctx, 0, 0, mSize.x(), mSize.y());
-    for (auto child : mChildren)
-        if (child->visible()) {
-            nvgSave(ctx);
-            child->draw(ctx);
-            nvgRestore(ctx);
+    nvgIntersectScissor(ctx, 0, 0, mSize.x(), mSize.y());
+    for (auto child : mChildren) {
+        if (!child->visible())
+            continue;
+        /* Skip entire subtrees that lie outside of the active clip region */
+        if (cull && child->clipSize() == Vector2i::Zero()) {
+            ++culled;
+            continue;
         }
+        nvgSave(ctx);
+        child->draw(ctx);
+        nvgRestore(ctx);
+    }
     nvgRestore(ctx);
+
+    if (culled > 0 && sDrawingScreen)
+        sDrawingScreen->mFrameCulledWidgets += culled;
+}
+
+void Widget::drawScrollBar(NVGcontext *ctx, float x, float y, float length,
+                           float thumb, float scroll, bool vertical) {
+    float w = vertical ? 8 : length, h = vertical ? length : 8;
+    NVGpaint paint = nvgBoxGradient(ctx, x + 1, y + 1, w, h, 3, 4,
+                                    Color(0, 32), Color(0, 92));
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, x, y, w, h, 3);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+
+    float offset = (length - thumb) * scroll;
+    float tx = vertical ? x : x + offset, ty = vertical ? y + offset : y;
+    float tw = vertical ? 8 : thumb, th = vertical ? thumb : 8;
+    paint = nvgBoxGradient(ctx, tx - 1, ty - 1, tw, th, 3, 4,
+                           Color(220, 100), Color(128, 100));
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, tx + 1, ty + 1, tw - 2, th - 2, 2);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
 }
 
 void Widget::save(Serializer &s) const {
@@ -235,6 +368,7 @@ bool Widget::load(Serializer &s) {
     if (!s.get("tooltip", mTooltip)) return false;
     if (!s.get("fontSize", mFontSize)) return false;
     if (!s.get("cursor", mCursor)) return false;
+    invalidateGeometry();
     return true;
 }
 
@@ -15,11 +15,32 @@
 #include <nanogui/screen.h>
 #include <nanogui/layout.h>
 #include <nanogui/serializer/core.h>
+#include "nanovg_bgfx.h"
 
 NAMESPACE_BEGIN(nanogui)
 
+/* Return whether a visible widget of a subtree changed by itself */
+static bool subtreeNeedsRedraw(Widget *widget) {
+    if (!widget->visible())
+        return false;
+    if (widget->needsRedraw())
+        return true;
+    for (auto child : widget->children())
+        if (subtreeNeedsRedraw(child))
+            return true;
+    return false;
+}
+
 Window::Window(Widget *parent, const std::string &title)
-    : Widget(parent), mTitle(title), mButtonPanel(nullptr), mModal(false), mDrag(false), mFullscreen(false) { }
+    : Widget(parent), mTitle(title), mButtonPanel(nullptr), mModal(false), mDrag(false), mFullscreen(false),
+      mLayerCached(false), mLayerDirty(true), mLayerRequested(false), mLayerRendering(false),
+      mLayer(nullptr), mLayerViewId(-1), mLayerScreen(nullptr), mLayerMargin(0),
+      mLayerFramebufferSize(Vector2i::Zero()), mLayerWindowSize(Vector2i::Zero()), mLayerRatio(0.f),
+      mLayerClipPosition(Vector2i::Zero()), mLayerClipSize(Vector2i::Zero()) { }
+
+Window::~Window() {
+    releaseLayer();
+}
 
 Vector2i Window::preferredSize(NVGcontext *ctx) const {
     if (mButtonPanel)
@@ -53,6 +74,7 @@ Widget *Window::buttonPanel() {
 }
 
 void Window::performLayout(NVGcontext *ctx) {
+    invalidateLayer();
     
     if( mFullscreen 
         && mParent != nullptr) {
@@ -77,6 +99,20 @@ void Window::performLayout(NVGcontext *ctx) {
 }
 
 void Window::draw(NVGcontext *ctx) {
+    if (mLayerCached && !mLayerRendering) {
+        mLayerRequested = true;
+        if (layerValid(screen())) {
+            /* Composite the layer rendered before the frame */
+            float x = mPos.x() - mLayerMargin, y = mPos.y() - mLayerMargin;
+            float w = mSize.x() + 2 * mLayerMargin, h = mSize.y() + 2 * mLayerMargin;
+            NVGpaint paint = nvgImagePattern(ctx, x, y, w, h, 0, mLayer->image, 1.0f);
+            nvgBeginPath(ctx);
+            nvgRect(ctx, x, y, w, h);
+            nvgFillPaint(ctx, paint);
+            nvgFill(ctx);
+            return;
+        }
+    }
 
     if(mModal) {
         int ds = mTheme->mWindowDropShadowSize, cr = mTheme->mWindowCornerRadius;
@@ -168,18 +204,129 @@ void Window::center() {
     ((Screen *) widget)->centerWindow(this);
 }
 
+Screen *Window::screen() {
+    Widget *widget = this;
+    while (widget->parent())
+        widget = widget->parent();
+    return dynamic_cast<Screen *>(widget);
+}
+
+void Window::setLayerCached(bool layerCached) {
+    mLayerCached = layerCached;
+    mLayerRequested = false;
+    mLayerDirty = true;
+    if (!layerCached)
+        releaseLayer();
+}
+
+void Window::releaseLayer() {
+    if (mLayer) {
+        nvgluDeleteFramebuffer(mLayer);
+        mLayer = nullptr;
+    }
+    if (mLayerViewId >= 0) {
+        bgfx::FrameBufferHandle invalid = BGFX_INVALID_HANDLE;
+        bgfx::setViewFrameBuffer((uint8_t) mLayerViewId, invalid);
+        mLayerScreen->releaseViewId((uint8_t) mLayerViewId);
+        mLayerViewId = -1;
+    }
+    mLayerDirty = true;
+}
+
+bool Window::layerValid(const Screen *screen) const {
+    if (!mLayer || mLayerDirty || !screen || screen != mLayerScreen ||
+        mLayerWindowSize != mSize || mLayerRatio != screen->pixelRatio() ||
+        mLayerMargin != mTheme->mWindowDropShadowSize)
+        return false;
+
+    /* Widgets that were clipped away are missing from the layer: it is only
+       valid as long as the same part of the window is visible */
+    if (mLayerClipPosition == Vector2i::Zero() && mLayerClipSize == mSize)
+        return true;
+    return mLayerClipPosition == clipPosition() - absolutePosition() &&
+           mLayerClipSize == clipSize();
+}
+
+void Window::renderLayer(NVGcontext *ctx) {
+    if (!mLayerCached || !mLayerRequested || !mVisible)
+        return;
+    /* The layer is rendered again if the window is not drawn by the next frame */
+    mLayerRequested = false;
+
+    Screen *screen = this->screen();
+    if (!mLayerDirty && subtreeNeedsRedraw(this))
+        mLayerDirty = true;
+    if (!screen || layerValid(screen) || clipSize() == Vector2i::Zero())
+        return;
+
+    if (screen != mLayerScreen) {
+        releaseLayer();
+        mLayerScreen = screen;
+    }
+    if (mLayerViewId < 0)
+        mLayerViewId = screen->acquireViewId();
+
+    float ratio = screen->pixelRatio();
+    int margin = mTheme->mWindowDropShadowSize;
+    Vector2i extent = mSize + Vector2i::Constant(2 * margin);
+    /* Same rounding as the view rectangle set by nvgBeginFrame() */
+    Vector2i size = (extent.cast<float>() * ratio).cast<int>().cwiseMax(1);
+    if (!mLayer || size != mLayerFramebufferSize) {
+        if (mLayer)
+            nvgluDeleteFramebuffer(mLayer);
+        mLayer = nvgluCreateFramebuffer(ctx, size.x(), size.y(),
+                                        nvgluFramebufferImageFlags(), (uint8_t) mLayerViewId);
+        if (!mLayer)
+            throw std::runtime_error("Window: could not create the layer framebuffer!");
+        mLayerFramebufferSize = size;
+    }
+
+    uint8_t viewId = (uint8_t) mLayerViewId;
+    bgfx::setViewClear(viewId, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH | BGFX_CLEAR_STENCIL, 0, 1.0f, 0);
+    bgfx::touch(viewId);
+
+    nvgluBindFramebuffer(mLayer);
+    nvgBeginFrame(ctx, extent.x(), extent.y(), ratio);
+    nvgTranslate(ctx, (float) (margin - mPos.x()), (float) (margin - mPos.y()));
+    /* Widgets that are still animating invalidate the layer again while drawn */
+    mLayerDirty = false;
+    mLayerRendering = true;
+    draw(ctx);
+    mLayerRendering = false;
+    nvgEndFrame(ctx);
+    nvgluBindFramebuffer(nullptr);
+
+    mLayerMargin = margin;
+    mLayerWindowSize = mSize;
+    mLayerRatio = ratio;
+    mLayerClipPosition = clipPosition() - absolutePosition();
+    mLayerClipSize = clipSize();
+}
+
+bool Window::mouseEnterEvent(const Vector2i &p, bool enter) {
+    invalidateLayer();
+    return Widget::mouseEnterEvent(p, enter);
+}
+
+void Window::setTheme(Theme *theme) {
+    Widget::setTheme(theme);
+    invalidateLayer();
+}
+
 bool Window::mouseDragEvent(const Vector2i &, const Vector2i &rel,
                             int button, int /* modifiers */) {
     if (mDrag && (button & (1 << NG_MOUSE_BUTTON_1)) != 0) {
-        mPos += rel;
-        mPos = mPos.cwiseMax(Vector2i::Zero());
-        mPos = mPos.cwiseMin(parent()->size() - mSize);
+        Vector2i pos = mPos + rel;
+        pos = pos.cwiseMax(Vector2i::Zero());
+        pos = pos.cwiseMin(parent()->size() - mSize);
+        setPosition(pos);
         return true;
     }
     return false;
 }
 
 bool Window::mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) {
+    invalidateLayer();
     if (Widget::mouseButtonEvent(p, button, down, modifiers))
         return true;
     if (button == NG_MOUSE_BUTTON_1) {
@@ -190,6 +337,7 @@ bool Window::mouseButtonEvent(const Vector2i &p, int button, bool down, int modi
 }
 
 bool Window::scrollEvent(const Vector2i &p, const Vector2f &rel) {
+    invalidateLayer();
     Widget::scrollEvent(p, rel);
     return true;
 }